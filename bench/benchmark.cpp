@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <vector>
+#include "execution/Program.h"
+#include "execution/Superinstructions.h"
+#include "execution/VirtualMachine.h"
+
+/**
+ * Struct for one benchmarked program
+ */
+typedef struct Benchmark {
+    /** Path to the instructions file */
+    std::string instructions_file;
+    /** Program input (REA) */
+    std::string input;
+} Benchmark;
+
+/**
+ * Struct for benchmarked configuration of the virtual machine
+ */
+typedef struct Configuration {
+    /** Name of the configuration (column of the table) */
+    const char *name;
+    /** Dispatch mode */
+    DispatchMode dispatch_mode;
+    /** True if superinstructions are used; False otherwise */
+    bool superinstructions;
+    /** True if the hot functions are compiled by the JIT compiler; False otherwise */
+    bool jit;
+    /** True if the interpreter loop checks every instruction even if the program was verified; False otherwise */
+    bool checked;
+    /** True if the builtin functions run natively (entries from the functions file next to the instructions file); False otherwise */
+    bool intrinsics;
+    /** True if the stack and heap have the 32-bit cells; False for the 64-bit cells */
+    bool compact;
+    /** True if the interpreter loop keeps the display; False if it walks the static links */
+    bool display;
+} Configuration;
+
+/**
+ * Benchmarked configurations (run times in milliseconds), the first one is the baseline
+ */
+static const std::vector<Configuration> Configurations = {
+    {"switch", DISPATCH_SWITCH, false, false, true, false, false, true},
+    {"threaded", DISPATCH_THREADED, false, false, true, false, false, true},
+    {"switch+SI", DISPATCH_SWITCH, true, false, true, false, false, true},
+    {"threaded+SI", DISPATCH_THREADED, true, false, true, false, false, true},
+    {"verified+SI", DISPATCH_THREADED, true, false, false, false, false, true},
+    {"links+SI", DISPATCH_THREADED, true, false, false, false, false, false},
+    {"intrinsics", DISPATCH_THREADED, true, false, false, true, false, true},
+    {"int32", DISPATCH_THREADED, true, false, false, true, true, true},
+    {"register", DISPATCH_REGISTER, false, false, true, false, false, true},
+    {"threaded+JIT", DISPATCH_THREADED, true, true, true, false, false, true}
+};
+
+/**
+ * Prints usage of the program to stderr
+ * @param program_name name of the program
+ */
+void print_usage(const char *program_name) {
+    std::cerr << "Usage: " << program_name << " [--repeat=<count>] [--ngrams=<n>] <instructions file>[:<input file>] ..." << std::endl;
+    std::cerr << "Runs every program with every configuration of the virtual machine and prints the best run time [ms]" << std::endl;
+    std::cerr << "    --ngrams=<n> - only print the most frequent instruction n-grams of all programs (static counting)" << std::endl;
+}
+
+/**
+ * Reads whole file into string
+ * @param path Path to the file
+ * @return Content of the file
+ */
+std::string read_file(const std::string &path) {
+    auto file = std::ifstream(path, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("cannot open file " + path);
+    auto content = std::stringstream();
+    content << file.rdbuf();
+    return content.str();
+}
+
+/**
+ * Runs the program repeatedly and measures the best run time (only the execution itself is measured)
+ * @tparam Cell Type of the cell of the virtual machine
+ * @param program Program to run
+ * @param input Program input
+ * @param configuration Configuration of the virtual machine
+ * @param repeat Number of runs
+ * @param instructions Number of executed instructions (output)
+ * @return Best run time in milliseconds
+ */
+template<typename Cell>
+double measure(const Program &program, const std::string &input, const Configuration &configuration, int repeat, std::uint64_t &instructions) {
+    auto best = 0.0;
+    for (auto i = 0; i < repeat; i++) {
+        auto output = std::string();
+        auto virtual_machine = BasicVirtualMachine<Cell>(program, InputBuffer(input), OutputBuffer(output), DEFAULT_STACK_SIZE,
+                                                         DEFAULT_HEAP_SIZE, configuration.superinstructions);
+        if (configuration.jit)
+            virtual_machine.enable_jit();
+        if (configuration.checked)
+            virtual_machine.enable_checks();
+        if (!configuration.display)
+            virtual_machine.disable_display();
+
+        auto start = std::chrono::steady_clock::now();
+        virtual_machine.run(configuration.dispatch_mode);
+        auto end = std::chrono::steady_clock::now();
+
+        auto elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+        if (i == 0 || elapsed < best)
+            best = elapsed;
+        instructions = virtual_machine.get_instruction_counter();
+    }
+    return best;
+}
+
+/**
+ * Prints the most frequent instruction n-grams of the programs
+ * @param benchmarks Benchmarked programs
+ * @param n Length of the n-grams
+ */
+void print_ngrams(const std::vector<Benchmark> &benchmarks, std::size_t n) {
+    auto counts = std::map<std::string, std::uint64_t>();
+    for (const auto &benchmark : benchmarks)
+        count_ngrams(Program::load(benchmark.instructions_file).get_instructions(), n, counts);
+
+    auto sorted = std::vector<std::pair<std::string, std::uint64_t>>(counts.begin(), counts.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto &left, const auto &right) { return left.second > right.second; });
+    for (std::size_t i = 0; i < sorted.size() && i < 20; i++)
+        std::cout << std::setw(8) << sorted[i].second << "  " << sorted[i].first << std::endl;
+}
+
+/**
+ * Main function of the benchmark
+ * @param argc Argument count
+ * @param argv Argument values
+ * @return EXIT_SUCCESS if all programs finished successfully, EXIT_FAILURE otherwise
+ */
+int main(int argc, char **argv) {
+    auto repeat = 5;
+    auto ngrams = 0;
+    auto benchmarks = std::vector<Benchmark>();
+    for (auto i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--repeat=", 9) == 0) {
+            repeat = std::atoi(argv[i] + 9);
+            continue;
+        }
+        if (std::strncmp(argv[i], "--ngrams=", 9) == 0) {
+            ngrams = std::atoi(argv[i] + 9);
+            continue;
+        }
+        auto argument = std::string(argv[i]);
+        auto separator = argument.find(':');
+        if (separator == std::string::npos)
+            benchmarks.push_back(Benchmark{argument, ""});
+        else
+            benchmarks.push_back(Benchmark{argument.substr(0, separator), read_file(argument.substr(separator + 1))});
+    }
+    if (benchmarks.empty() || repeat <= 0 || ngrams < 0) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (ngrams > 0) {
+        try {
+            print_ngrams(benchmarks, ngrams);
+        } catch (const std::runtime_error &error) {
+            std::cerr << error.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+#if !YADC_VM_COMPUTED_GOTO
+    std::cerr << "Warning: built without YADC_VM_COMPUTED_GOTO, threaded dispatch falls back to switch" << std::endl;
+#endif
+    if (!JitCompiler::is_available())
+        std::cerr << "Warning: JIT compiler is not available (built without YADC_VM_JIT or executable memory refused), JIT configuration is interpreted" << std::endl;
+
+    std::cout << std::left << std::setw(36) << "program" << std::right << std::setw(14) << "instructions";
+    for (const auto &configuration : Configurations)
+        std::cout << std::setw(14) << configuration.name;
+    std::cout << std::setw(10) << "speedup" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+
+    auto result = EXIT_SUCCESS;
+    for (const auto &benchmark : benchmarks) {
+        try {
+            auto program = Program::load(benchmark.instructions_file);
+            auto instructions = std::uint64_t(0);
+            /* Builtin functions are found by the functions file of the compiler (<name>.functions.txt), without it they stay PL/0 code */
+            auto intrinsic_program = program;
+            auto functions = std::ifstream(std::filesystem::path(benchmark.instructions_file).replace_extension(".functions.txt"));
+            if (functions)
+                intrinsic_program.set_builtin_entries(parse_builtin_entries(functions));
+
+            std::cout << std::left << std::setw(36) << std::filesystem::path(benchmark.instructions_file).filename().string() << std::right;
+            auto times = std::vector<double>();
+            for (const auto &configuration : Configurations) {
+                const auto &measured = configuration.intrinsics ? intrinsic_program : program;
+                times.push_back(configuration.compact ? measure<compact_cell_t>(measured, benchmark.input, configuration, repeat, instructions)
+                                                      : measure<cell_t>(measured, benchmark.input, configuration, repeat, instructions));
+            }
+            std::cout << std::setw(14) << instructions;
+            for (auto time : times)
+                std::cout << std::setw(14) << time;
+
+            /* Speedup of the fastest configuration over the plain switch */
+            auto best = *std::min_element(times.begin(), times.end());
+            std::cout << std::setw(9) << (best > 0 ? times[0] / best : 0.0) << "x" << std::endl;
+        } catch (const std::runtime_error &error) {
+            std::cerr << benchmark.instructions_file << ": " << error.what() << std::endl;
+            result = EXIT_FAILURE;
+        }
+    }
+
+    return result;
+}
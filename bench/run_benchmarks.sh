@@ -0,0 +1,25 @@
+#!/bin/bash
+# Compiles every example program and microbenchmark and benchmarks yadc-vm dispatch modes on it
+# Usage: bench/run_benchmarks.sh <build directory> [--repeat=<count>]
+
+set -e
+
+BUILD_DIR=$(realpath "${1:-build}")
+REPEAT=${2:---repeat=5}
+ROOT_DIR=$(realpath "$(dirname "$0")/..")
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+BENCHMARKS=()
+for example in "$ROOT_DIR"/examples/*.yadc "$ROOT_DIR"/bench/*.yadc; do
+    name=$(basename "$example" .yadc)
+    # The compiler always writes instructions.txt and functions.txt into the working directory
+    (cd "$WORK_DIR" && "$BUILD_DIR/yadc" "$example" > /dev/null && mv instructions.txt "$name.txt" && mv functions.txt "$name.functions.txt")
+    if [ -f "$ROOT_DIR/bench/inputs/$name.txt" ]; then
+        BENCHMARKS+=("$WORK_DIR/$name.txt:$ROOT_DIR/bench/inputs/$name.txt")
+    else
+        BENCHMARKS+=("$WORK_DIR/$name.txt")
+    fi
+done
+
+"$BUILD_DIR/yadc-vm-bench" "$REPEAT" "${BENCHMARKS[@]}"
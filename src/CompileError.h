@@ -0,0 +1,37 @@
+#pragma once
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Exception for a lexical, syntax or semantic error of the compiled program
+ * Its message is the error as printed by the compiler (e.g. "Semantic error: ..., error on line 3"),
+ * so the compilation of one program fails without ending the process (e.g. the test runner compiling more programs at once)
+ */
+class CompileError : public std::runtime_error {
+public:
+    /**
+     * Constructor, the parts of the message are joined the way they would be written to a stream
+     * @tparam Parts Types of the parts of the message
+     * @param parts Parts of the message
+     */
+    template<typename... Parts>
+    explicit CompileError(const Parts &...parts) : std::runtime_error(join(parts...)) {
+        /* Empty */
+    }
+
+private:
+    /**
+     * Joins the parts of the message
+     * @tparam Parts Types of the parts of the message
+     * @param parts Parts of the message
+     * @return Message
+     */
+    template<typename... Parts>
+    static std::string join(const Parts &...parts) {
+        std::ostringstream message;
+        (message << ... << parts);
+        return message.str();
+    }
+};
@@ -1,6 +1,6 @@
 #include "SymbolTable.h"
 
-std::vector<std::string> SymbolTable::builtin_functions = {
+const std::vector<std::string> SymbolTable::builtin_functions = {
         "print_int",
         "read_int",
         "print_str",
@@ -189,7 +189,7 @@ void SymbolTable::remove_scope() {
 
 void SymbolTable::allocate_symbols(uint32_t number_of_symbols, std::vector<uint32_t> size_of_symbols) {
     for (int i = 0; i < number_of_symbols; i++)
-        this->table.back().insert("__TEMP__" + std::to_string(temp_counter++), VARIABLE, size_representant[size_of_symbols[i]], false);
+        this->table.back().insert("__TEMP__" + std::to_string(temp_counter++), VARIABLE, size_representant.at(size_of_symbols[i]), false);
 }
 
 SymbolTableRecord &SymbolTable::get_first_empty_symbol(uint32_t size_of_symbol) {
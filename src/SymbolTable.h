@@ -5,6 +5,7 @@
 #include <map>
 #include <string>
 #include <ranges>
+#include <algorithm>
 
 /** Activation record size */
 const std::uint32_t ACTIVATION_RECORD_SIZE = 3;
@@ -164,7 +165,7 @@ template<uint32_t pointer_level, bool is_pointing_to_stack = false>
 static Type float_t_ptr = {FLOAT, pointer_level, is_pointing_to_stack};
 
 /** Map of size representants for each known possible value size */
-static std::map<uint32_t, Type> size_representant = {
+static const std::map<uint32_t, Type> size_representant = {
         {0, void_t},
         {1, int_t},
         {2, float_t},
@@ -195,11 +196,24 @@ public:
      * @param is_function_scope Flag if scope is function scope
      */
     ScopeSymbolTable(uint32_t address_base, uint32_t address_offset, bool is_function_scope = false);
+    /**
+     * Copy constructor
+     * @param other Scope to copy
+     */
+    ScopeSymbolTable(const ScopeSymbolTable &other) = default;
+    /**
+     * Move constructor (records keep their addresses when the scopes are reallocated, SymbolTableRecord::pointee points to them)
+     * @param other Scope to move
+     */
+    ScopeSymbolTable(ScopeSymbolTable &&other) noexcept = default;
     /**
      * Destructor
      */
     ~ScopeSymbolTable();
 
+    ScopeSymbolTable &operator=(const ScopeSymbolTable &other) = default;
+    ScopeSymbolTable &operator=(ScopeSymbolTable &&other) noexcept = default;
+
     /**
      * Inserts symbol into scope
      * @param name Name of symbol
@@ -273,7 +287,7 @@ private:
 
 public:
     /** Vector of builtin functions */
-    static std::vector<std::string> builtin_functions;
+    static const std::vector<std::string> builtin_functions;
 
     /**
      * Constructor
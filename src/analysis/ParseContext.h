@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include "../AbstractSyntaxTree.h"
+
+/**
+ * Struct for state of one compilation shared by the parser and the scanner (the extra data of the reentrant scanner),
+ * so more source files can be parsed at once on different threads
+ */
+typedef struct ParseContext {
+    /** Global "block" of the program; basically just root of the AST */
+    ASTNodeBlock *global_block;
+    /** Column of the last token */
+    int column;
+    /** Column of the next token */
+    int next_column;
+    /** Depth of the nested block comments */
+    int inside_comment;
+    /** First lexical or syntax error (empty if the program was parsed) */
+    std::string error;
+} ParseContext;
@@ -1,4 +1,5 @@
 #include "SyntaxAnalyzer.h"
+#include "Tokenizer.h"
 
 SyntaxAnalyzer::SyntaxAnalyzer(std::string input_file_name) : input_file_name(std::move(input_file_name)) {
     /* Empty */
@@ -6,10 +7,25 @@ SyntaxAnalyzer::SyntaxAnalyzer(std::string input_file_name) : input_file_name(st
 
 SyntaxAnalyzer::~SyntaxAnalyzer() = default;
 
-ASTNodeBlock *SyntaxAnalyzer::analyze() {
-    yyin = fopen(this->input_file_name.c_str(), "r");
-    yyparse();
-    fclose(yyin);
+ParseContext SyntaxAnalyzer::analyze() {
+    auto input = fopen(this->input_file_name.c_str(), "r");
+    if (input == nullptr)
+        throw CompileError("Input error: cannot open file \"", this->input_file_name, "\"");
+    auto context = ParseContext{nullptr, 1, 1, 0, ""};
+    yyscan_t scanner;
+    if (yylex_init_extra(&context, &scanner) != 0) {
+        fclose(input);
+        throw CompileError("Input error: cannot create the scanner of file \"", this->input_file_name, "\"");
+    }
+    yyset_in(input, scanner);
+    auto result = yyparse(scanner, &context);
+    yylex_destroy(scanner);
+    fclose(input);
 
-    return global_block;
-}
+    /* Global block frees the statements parsed before the error, the nodes left on the stack of the parser are lost */
+    if (result != 0) {
+        delete context.global_block;
+        throw CompileError(context.error.empty() ? "Syntax error: parsing failed" : context.error);
+    }
+    return context;
+}
\ No newline at end of file
@@ -2,15 +2,13 @@
 
 #include <fstream>
 #include <utility>
+#include "CompileError.h"
 #include "Parser.h"
 
-/** Global "block" of the program; basically just root of the AST */
-extern ASTNodeBlock *global_block;
-/** Input file stream */
-extern FILE *yyin;
-
 /**
  * Class for syntax analysis
+ * The parser and the scanner are reentrant, every analysis keeps its state in its own ParseContext,
+ * so more source files can be analyzed at once on different threads
  */
 class SyntaxAnalyzer {
 private:
@@ -30,7 +28,8 @@ public:
 
     /**
      * Analyze the syntax
-     * @return Root of the AST
+     * Throws CompileError if the input file cannot be read or on the first lexical or syntax error
+     * @return Context of the analysis (its global block is the root of the AST)
      */
-    ASTNodeBlock *analyze();
+    ParseContext analyze();
 };
\ No newline at end of file
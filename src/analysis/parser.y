@@ -2,24 +2,35 @@
     #include <iostream>
     #include <regex>
     #include "../src/AbstractSyntaxTree.h"
-
-    extern int yylineno;
-    extern int column;
-
-    ASTNodeBlock *global_block;
 %}
 
 %code requires {
     #include "AbstractSyntaxTree.h"
+    #include "analysis/ParseContext.h"
+
+    /* Handle of the reentrant scanner, declared the same way by the scanner header */
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void *yyscan_t;
+    #endif
 }
 
 %code provides {
-  int yyerror(const char *s);
-  int yylex(YYSTYPE*, YYLTYPE*);
+  int yyerror(YYLTYPE *location, yyscan_t scanner, ParseContext *context, const char *s);
+  int yylex(YYSTYPE *value, YYLTYPE *location, yyscan_t scanner);
+  int yyget_lineno(yyscan_t scanner);
 }
 
+%code {
+    /* Line number of the scanner of this compilation */
+    #define yylineno yyget_lineno(scanner)
+}
+
+%require "3.6"
 %locations
 %define api.pure
+%parse-param {yyscan_t scanner} {ParseContext *context}
+%lex-param {yyscan_t scanner}
 %union {
     ASTNode *node;
     ASTNodeExpression *expr;
@@ -67,8 +78,8 @@ program:
         $1->statements.emplace_back($2);
     }
     | %empty {
-        global_block = new ASTNodeBlock();
-        $$ = global_block;
+        context->global_block = new ASTNodeBlock();
+        $$ = context->global_block;
     }
 ;
 
@@ -598,9 +609,12 @@ memory_expr:
 
 %%
 
-int yyerror(const char *s) {
+int yyerror(YYLTYPE *, yyscan_t scanner, ParseContext *context, const char *s) {
+    /* Parsing stops at the first error (there are no error recovery rules), the lexical error was reported by the scanner */
+    if (!context->error.empty())
+        return 0;
     std::string error = std::string(s);
     error = error.substr(error.find_first_of(",") + 2, error.length());
-    std::cerr << "Syntax error: " << error << ", in line " << yylineno << ", column " << column << std::endl;
-    exit(1);
-}
+    context->error = "Syntax error: " + error + ", in line " + std::to_string(yylineno) + ", column " + std::to_string(context->column);
+    return 0;
+}
\ No newline at end of file
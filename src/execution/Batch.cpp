@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include "Batch.h"
+
+std::vector<BatchJob> parse_batch_jobs(std::istream &input) {
+    std::vector<BatchJob> jobs;
+    std::string line;
+    while (std::getline(input, line)) {
+        auto line_stream = std::istringstream(line);
+        std::string input_file, output_file;
+        if (!(line_stream >> input_file))
+            continue;
+        if (!(line_stream >> output_file))
+            output_file = input_file + ".out";
+        jobs.push_back(BatchJob{input_file, output_file, "", 0, 0.0, ""});
+    }
+    return jobs;
+}
+
+/**
+ * Runs the program with the input of the job and writes its output
+ * @param program Program
+ * @param job Job of the batch
+ * @param settings Settings of the virtual machine
+ */
+static void run_job(const Program &program, BatchJob &job, const BatchSettings &settings) {
+    auto start = std::chrono::steady_clock::now();
+    auto input_file = std::ifstream(job.input_file, std::ios::binary);
+    if (!input_file) {
+        job.status = "IO_ERROR";
+        job.message = "cannot open file \"" + job.input_file + "\"";
+        return;
+    }
+    std::stringstream input;
+    input << input_file.rdbuf();
+
+    /* Output is collected in memory and written once, the workers do not share a stream */
+    auto output = std::string();
+    job.status = "OK";
+    {
+        auto virtual_machine = VirtualMachine(program, InputBuffer(input.str()), OutputBuffer(output), settings.stack_size,
+                                              settings.heap_size, settings.superinstructions);
+        if (settings.collection)
+            virtual_machine.enable_collection();
+        if (settings.checked)
+            virtual_machine.enable_checks();
+        if (settings.fuel > 0)
+            virtual_machine.set_instruction_limit(settings.fuel);
+        try {
+            virtual_machine.run(settings.dispatch_mode);
+        } catch (const FuelExhaustedError &error) {
+            job.status = "FUEL_EXHAUSTED";
+            job.message = error.what();
+        } catch (const RuntimeError &error) {
+            job.status = "RUNTIME_ERROR";
+            job.message = error.what();
+        }
+        job.instructions = virtual_machine.get_instruction_counter();
+    }
+
+    /* Output of the failed program is kept, like the output of yadc-vm */
+    auto output_file = std::ofstream(job.output_file, std::ios::binary);
+    if (!output_file.write(output.data(), static_cast<std::streamsize>(output.size()))) {
+        job.status = "IO_ERROR";
+        job.message = "cannot write file \"" + job.output_file + "\"";
+    }
+    job.run_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void run_batch(const Program &program, std::vector<BatchJob> &jobs, const BatchSettings &settings, unsigned workers) {
+    std::atomic<std::size_t> next_job = 0;
+    std::vector<std::thread> threads;
+    workers = std::max(1u, std::min<unsigned>(workers, jobs.size()));
+    for (unsigned i = 0; i < workers; i++) {
+        threads.emplace_back([&]() {
+            for (auto index = next_job++; index < jobs.size(); index = next_job++) {
+                try {
+                    run_job(program, jobs[index], settings);
+                } catch (const std::exception &exception) {
+                    /* Virtual machine of the job could not be created (e.g. its memory could not be reserved) */
+                    jobs[index].status = "RUNTIME_ERROR";
+                    jobs[index].message = exception.what();
+                }
+            }
+        });
+    }
+    for (auto &thread: threads)
+        thread.join();
+}
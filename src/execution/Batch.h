@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+#include "Program.h"
+#include "VirtualMachine.h"
+
+/**
+ * Struct for one run of the batch (the program with one input)
+ */
+typedef struct BatchJob {
+    /** Input file of the program */
+    std::string input_file;
+    /** Output file of the program (written even if the program fails) */
+    std::string output_file;
+    /** Status (OK, RUNTIME_ERROR, FUEL_EXHAUSTED, IO_ERROR) */
+    std::string status;
+    /** Number of the executed instructions */
+    std::uint64_t instructions;
+    /** Run time including reading the input and writing the output (in milliseconds) */
+    double run_time;
+    /** Error message (empty if the program finished) */
+    std::string message;
+} BatchJob;
+
+/**
+ * Struct for settings of the virtual machines of the batch (the same for every job)
+ */
+typedef struct BatchSettings {
+    /** Size of the stack (in cells) */
+    std::size_t stack_size;
+    /** Maximum size of the heap (in cells) */
+    std::size_t heap_size;
+    /** Maximum number of the executed instructions (0 = unlimited) */
+    std::uint64_t fuel;
+    /** Dispatch mode of the interpreter loop */
+    DispatchMode dispatch_mode;
+    /** True if the known instruction sequences are fused into superinstructions; False otherwise */
+    bool superinstructions;
+    /** True if the interpreter loop checks every instruction even if the program was verified; False otherwise */
+    bool checked;
+    /** True if the unreachable heap blocks are collected; False otherwise */
+    bool collection;
+} BatchSettings;
+
+/**
+ * Parses the jobs of the batch, "<input file> [<output file>]" per line (the output file defaults to "<input file>.out")
+ * Empty lines are skipped
+ * @param input Input stream
+ * @return Jobs of the batch
+ */
+std::vector<BatchJob> parse_batch_jobs(std::istream &input);
+
+/**
+ * Runs the program with every input of the batch on the worker threads
+ * The program is loaded and verified once and shared read-only by the workers, every job runs in its own virtual machine
+ * (its own stack, heap and buffered input and output), the workers take the jobs one by one
+ * @param program Program (its builtin entries included)
+ * @param jobs Jobs of the batch, their status, executed instructions, run time and message are filled in
+ * @param settings Settings of the virtual machines
+ * @param workers Number of the worker threads
+ */
+void run_batch(const Program &program, std::vector<BatchJob> &jobs, const BatchSettings &settings, unsigned workers);
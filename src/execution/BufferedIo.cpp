@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cerrno>
+#include <utility>
+#include <unistd.h>
+#include "BufferedIo.h"
+
+OutputBuffer::OutputBuffer(int fd) : fd(fd), target(nullptr), limit(SIZE_MAX), block(IO_BLOCK_SIZE), size(0) {
+}
+
+OutputBuffer::OutputBuffer(std::string &target, std::size_t limit) : fd(-1), target(&target), limit(limit), block(IO_BLOCK_SIZE), size(0) {
+}
+
+OutputBuffer::OutputBuffer(OutputBuffer &&other) noexcept :
+    fd(other.fd), target(other.target), limit(other.limit), block(std::move(other.block)), size(other.size) {
+    /* Moved-from buffer has nothing to flush */
+    other.size = 0;
+}
+
+OutputBuffer::~OutputBuffer() {
+    this->flush();
+}
+
+void OutputBuffer::flush() {
+    if (this->size == 0)
+        return;
+    if (this->target != nullptr) {
+        if (this->target->size() < this->limit)
+            this->target->append(this->block.data(), std::min(this->size, this->limit - this->target->size()));
+        this->size = 0;
+        return;
+    }
+
+    /* Partial writes (e.g. to a pipe) are continued, the rest of the block is dropped on error */
+    std::size_t written = 0;
+    while (written < this->size) {
+        auto result = ::write(this->fd, this->block.data() + written, this->size - written);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0)
+            break;
+        written += static_cast<std::size_t>(result);
+    }
+    this->size = 0;
+}
+
+InputBuffer::InputBuffer(int fd) : fd(fd), block(IO_BLOCK_SIZE), position(0), size(0), finished(false), tied(nullptr) {
+}
+
+InputBuffer::InputBuffer(const std::string &data) :
+    fd(-1), block(data.begin(), data.end()), position(0), size(data.size()), finished(true), tied(nullptr) {
+}
+
+InputBuffer::InputBuffer() : fd(-1), position(0), size(0), finished(false), tied(nullptr) {
+}
+
+InputBuffer::~InputBuffer() = default;
+
+void InputBuffer::tie(OutputBuffer *output) {
+    this->tied = output;
+}
+
+void InputBuffer::append(const std::string &data) {
+    if (this->fd >= 0 || this->finished)
+        return;
+    this->block.erase(this->block.begin(), this->block.begin() + static_cast<std::ptrdiff_t>(this->position));
+    this->block.insert(this->block.end(), data.begin(), data.end());
+    this->position = 0;
+    this->size = this->block.size();
+}
+
+void InputBuffer::close() {
+    this->finished = true;
+}
+
+bool InputBuffer::read_block() {
+    if (this->finished)
+        return false;
+    if (this->tied != nullptr)
+        this->tied->flush();
+    if (this->fd < 0)
+        return false;
+
+    /* Read error ends the input like the end of file */
+    auto result = ::read(this->fd, this->block.data(), this->block.size());
+    while (result < 0 && errno == EINTR)
+        result = ::read(this->fd, this->block.data(), this->block.size());
+    if (result <= 0) {
+        this->finished = true;
+        return false;
+    }
+    this->position = 0;
+    this->size = static_cast<std::size_t>(result);
+    return true;
+}
+
+int InputBuffer::refill() {
+    if (!this->read_block())
+        return this->finished ? END_OF_INPUT : INPUT_PENDING;
+    return static_cast<unsigned char>(this->block[this->position++]);
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/** Size of the block read from or written to the file descriptor (in bytes) */
+const std::size_t IO_BLOCK_SIZE = 1 << 16;
+/** Value returned by the read at the end of the input (the same as std::char_traits<char>::eof()) */
+const int END_OF_INPUT = -1;
+/** Value returned by the read of the input in memory which is not closed yet when all of its characters were read */
+const int INPUT_PENDING = -2;
+
+/**
+ * Class for buffered output of the program (WRI)
+ * Characters are collected in the block which is written at once when it is full, when the program finishes
+ * or when the tied input waits for more characters; the target is a file descriptor or a string in memory
+ */
+class OutputBuffer {
+private:
+    /** File descriptor of the target (-1 if the target is in memory) */
+    int fd;
+    /** Target string in memory (nullptr if the target is the file descriptor) */
+    std::string *target;
+    /** Maximum size of the target string in memory, the rest of the output is dropped */
+    std::size_t limit;
+    /** Collected characters */
+    std::vector<char> block;
+    /** Number of the collected characters */
+    std::size_t size;
+
+public:
+    /**
+     * Constructor of the output to the file descriptor (e.g. STDOUT_FILENO), the descriptor is not closed
+     * @param fd File descriptor
+     */
+    explicit OutputBuffer(int fd);
+    /**
+     * Constructor of the output to memory
+     * @param target String the output is appended to
+     * @param limit Maximum size of the target string (the rest of the output is dropped)
+     */
+    explicit OutputBuffer(std::string &target, std::size_t limit = SIZE_MAX);
+    OutputBuffer(OutputBuffer &&other) noexcept;
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+    /**
+     * Destructor, flushes the collected characters (e.g. output of the program before its runtime error)
+     */
+    ~OutputBuffer();
+
+    /**
+     * Writes character
+     * @param character Character
+     */
+    void put(char character) {
+        if (this->size == this->block.size())
+            this->flush();
+        this->block[this->size++] = character;
+    }
+    /**
+     * Writes the collected characters to the target (errors of the file descriptor are ignored like by std::ostream)
+     */
+    void flush();
+};
+
+/**
+ * Class for buffered input of the program (REA)
+ * Input is read from the file descriptor in blocks (a terminal returns one line per read) or taken from memory,
+ * the tied output is flushed before the read waits for the file descriptor, so a prompt is shown before the input is read;
+ * the input in memory may also arrive in parts (append) until it is closed, the read returns INPUT_PENDING meanwhile
+ */
+class InputBuffer {
+private:
+    /** File descriptor of the source (-1 if the source is in memory) */
+    int fd;
+    /** Characters read ahead (the whole input if the source is in memory) */
+    std::vector<char> block;
+    /** Position of the next character in the block */
+    std::size_t position;
+    /** Number of the characters in the block */
+    std::size_t size;
+    /** True if the end of the input was reached; False otherwise */
+    bool finished;
+    /** Output flushed before the read waits for more input (nullptr if none) */
+    OutputBuffer *tied;
+
+    /**
+     * Reads next block from the file descriptor (the tied output is flushed first)
+     * @return True if read; False at the end of the input or if the input in memory is not closed yet
+     */
+    bool read_block();
+    /**
+     * Reads next block from the file descriptor
+     * @return Next character (END_OF_INPUT at the end of the input, INPUT_PENDING if the input in memory is not closed yet)
+     */
+    int refill();
+
+public:
+    /**
+     * Constructor of the input from the file descriptor (e.g. STDIN_FILENO), the descriptor is not closed
+     * @param fd File descriptor
+     */
+    explicit InputBuffer(int fd);
+    /**
+     * Constructor of the input from memory
+     * @param data Whole input
+     */
+    explicit InputBuffer(const std::string &data);
+    /**
+     * Constructor of the input in memory arriving in parts (append) until it is closed (close)
+     */
+    InputBuffer();
+    InputBuffer(InputBuffer &&other) noexcept = default;
+    InputBuffer(const InputBuffer &) = delete;
+    InputBuffer &operator=(const InputBuffer &) = delete;
+    /**
+     * Destructor
+     */
+    ~InputBuffer();
+
+    /**
+     * Ties the output to the input
+     * @param output Output flushed before the read waits for more input (nullptr to untie)
+     */
+    void tie(OutputBuffer *output);
+    /**
+     * Appends characters to the input in memory (the read characters are dropped)
+     * @param data Characters
+     */
+    void append(const std::string &data);
+    /**
+     * Ends the input, the read returns END_OF_INPUT after the remaining characters
+     */
+    void close();
+    /**
+     * Reads character
+     * @return Character (0 to 255), END_OF_INPUT at the end of the input or INPUT_PENDING if more input may be appended
+     */
+    int get() {
+        if (this->position < this->size)
+            return static_cast<unsigned char>(this->block[this->position++]);
+        return this->refill();
+    }
+    /**
+     * Get the characters read ahead, the next block is read first if all of them were read (as by the next get())
+     * @return Characters read ahead, valid until the next read (empty at the end of the input or if the input in memory is pending)
+     */
+    std::string_view peek() {
+        if (this->position == this->size && !this->read_block())
+            return {};
+        return {this->block.data() + this->position, this->size - this->position};
+    }
+    /**
+     * Skips the characters read ahead (returned by peek)
+     * @param count Number of the characters
+     */
+    void skip(std::size_t count) {
+        this->position += count;
+    }
+};
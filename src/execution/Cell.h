@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+/** Single memory cell of the virtual machine (both stack and heap consist of cells) */
+typedef std::int64_t cell_t;
+/** Compact cell of the virtual machine (--cells=32), half of the memory of the stack and heap, the arithmetic wraps at 32 bits */
+typedef std::int32_t compact_cell_t;
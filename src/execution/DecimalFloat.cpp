@@ -0,0 +1,66 @@
+#include "DecimalFloat.h"
+
+template<typename Cell>
+BasicDecimalFloat<Cell> decimal_float_from_parts(Cell whole_part, Cell fractional_part) {
+    using Unsigned = std::make_unsigned_t<Cell>;
+    if (fractional_part < 0)
+        throw std::runtime_error("fractional part of float cannot be negative");
+
+    Cell digits = 0;
+    while (digits <= std::numeric_limits<Cell>::digits10 && static_cast<std::uint64_t>(fractional_part) >= PowersOfTen[digits])
+        digits++;
+
+    auto mantissa = static_cast<Unsigned>(decimal_float_scale<Cell>(whole_part, digits, 0));
+    mantissa += whole_part < 0 ? static_cast<Unsigned>(0) - static_cast<Unsigned>(fractional_part) : static_cast<Unsigned>(fractional_part);
+    return {static_cast<Cell>(mantissa), static_cast<Cell>(-digits)};
+}
+
+template<typename Cell>
+Cell decimal_float_to_part(BasicDecimalFloat<Cell> value, bool whole_part) {
+    using Unsigned = std::make_unsigned_t<Cell>;
+    if (value.exponent >= 0)
+        return whole_part ? decimal_float_scale<Cell>(value.mantissa, value.exponent, 0) : 0;
+
+    /* Powers of ten with more digits than the cell are larger than any mantissa (they would wrap), all digits are fractional */
+    auto digits = static_cast<Unsigned>(static_cast<Unsigned>(0) - static_cast<Unsigned>(value.exponent));
+    if (digits > static_cast<Unsigned>(std::numeric_limits<Cell>::digits10))
+        return whole_part ? 0 : static_cast<Cell>(value.mantissa < 0 ? static_cast<Unsigned>(0) - static_cast<Unsigned>(value.mantissa) : value.mantissa);
+    auto divisor = static_cast<Cell>(PowersOfTen[digits]);
+    if (whole_part)
+        return static_cast<Cell>(value.mantissa / divisor);
+    auto fractional_part = static_cast<Cell>(value.mantissa % divisor);
+    return fractional_part < 0 ? static_cast<Cell>(-fractional_part) : fractional_part;
+}
+
+bool decimal_float_is_comparison(int operation) {
+    return operation >= PL0_EQ && operation <= PL0_LEQ;
+}
+
+template<typename Cell>
+BasicDecimalFloat<Cell> decimal_float_divide(BasicDecimalFloat<Cell> left, BasicDecimalFloat<Cell> right) {
+    using Unsigned = std::make_unsigned_t<Cell>;
+    if (right.mantissa == 0)
+        throw std::runtime_error("division by zero");
+    auto exponent = static_cast<Cell>(static_cast<Unsigned>(static_cast<Unsigned>(left.exponent) - static_cast<Unsigned>(right.exponent)));
+    /* Division by -1 is always exact, it only wraps the negated mantissa */
+    if (right.mantissa == -1)
+        return {static_cast<Cell>(static_cast<Unsigned>(0) - static_cast<Unsigned>(left.mantissa)), exponent};
+
+    /* Add digits after the decimal point until the division is exact (or precision is exhausted),
+       a digit which would not fit into the cell is not added (the 32-bit cells keep fewer digits) */
+    auto numerator = left.mantissa;
+    for (auto i = 0; i < DECIMAL_FLOAT_DIVISION_PRECISION && numerator % right.mantissa != 0; i++) {
+        if (numerator > std::numeric_limits<Cell>::max() / 10 || numerator < std::numeric_limits<Cell>::min() / 10)
+            break;
+        numerator = static_cast<Cell>(static_cast<Unsigned>(static_cast<Unsigned>(numerator) * 10));
+        exponent--;
+    }
+    return {static_cast<Cell>(numerator / right.mantissa), exponent};
+}
+
+template BasicDecimalFloat<cell_t> decimal_float_from_parts(cell_t whole_part, cell_t fractional_part);
+template BasicDecimalFloat<compact_cell_t> decimal_float_from_parts(compact_cell_t whole_part, compact_cell_t fractional_part);
+template cell_t decimal_float_to_part(BasicDecimalFloat<cell_t> value, bool whole_part);
+template compact_cell_t decimal_float_to_part(BasicDecimalFloat<compact_cell_t> value, bool whole_part);
+template BasicDecimalFloat<cell_t> decimal_float_divide(BasicDecimalFloat<cell_t> left, BasicDecimalFloat<cell_t> right);
+template BasicDecimalFloat<compact_cell_t> decimal_float_divide(BasicDecimalFloat<compact_cell_t> left, BasicDecimalFloat<compact_cell_t> right);
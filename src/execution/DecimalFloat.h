@@ -0,0 +1,183 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "Cell.h"
+#include "synthesis/Instructions.h"
+
+/** Maximum number of digits division adds after the decimal point when the result is not exact (fewer if the mantissa would overflow) */
+const int DECIMAL_FLOAT_DIVISION_PRECISION = 9;
+
+/**
+ * Struct for float value of the extended PL/0
+ * Float occupies two cells: mantissa (lower cell) and decimal exponent (upper cell), i.e. mantissa * 10^exponent
+ * @tparam Cell Type of the cell (cell_t or compact_cell_t)
+ */
+template<typename Cell>
+struct BasicDecimalFloat {
+    /** Mantissa */
+    Cell mantissa;
+    /** Exponent (base 10) */
+    Cell exponent;
+};
+
+/** Float of the virtual machine with the 64-bit cells */
+typedef BasicDecimalFloat<cell_t> DecimalFloat;
+
+/** Powers of ten wrapped to 64 bits (10^64 and higher wrap to zero, a narrower cell takes their low bits), so rescaling is one multiplication */
+constexpr std::array<std::uint64_t, 64> PowersOfTen = [] {
+    std::array<std::uint64_t, 64> powers = {};
+    std::uint64_t power = 1;
+    for (auto &entry: powers) {
+        entry = power;
+        power *= 10;
+    }
+    return powers;
+}();
+
+/**
+ * Computes 10^exponent wrapped to the cell (the same as multiplying by ten exponent times)
+ * @param exponent Exponent
+ * @return 10^exponent
+ */
+inline std::uint64_t decimal_float_power_of_ten(std::uint64_t exponent) {
+    return exponent < PowersOfTen.size() ? PowersOfTen[exponent] : 0;
+}
+
+/**
+ * Multiplies mantissa by 10^(high - low) (wrapping like the OPR arithmetic)
+ * @tparam Cell Type of the cell
+ * @param mantissa Mantissa
+ * @param high Higher exponent
+ * @param low Lower exponent
+ * @return Scaled mantissa
+ */
+template<typename Cell>
+inline Cell decimal_float_scale(Cell mantissa, Cell high, Cell low) {
+    using Unsigned = std::make_unsigned_t<Cell>;
+    auto distance = static_cast<Unsigned>(static_cast<Unsigned>(high) - static_cast<Unsigned>(low));
+    return static_cast<Cell>(static_cast<Unsigned>(static_cast<Unsigned>(mantissa) * static_cast<Unsigned>(decimal_float_power_of_ten(distance))));
+}
+
+/**
+ * Rescales both operands to the same (lower) exponent
+ * @tparam Cell Type of the cell
+ * @param left Left operand
+ * @param right Right operand
+ */
+template<typename Cell>
+inline void decimal_float_align(BasicDecimalFloat<Cell> &left, BasicDecimalFloat<Cell> &right) {
+    if (left.exponent > right.exponent) {
+        left.mantissa = decimal_float_scale(left.mantissa, left.exponent, right.exponent);
+        left.exponent = right.exponent;
+    } else if (right.exponent > left.exponent) {
+        right.mantissa = decimal_float_scale(right.mantissa, right.exponent, left.exponent);
+        right.exponent = left.exponent;
+    }
+}
+
+/**
+ * Creates float from its whole and fractional part (instruction ITR), e.g. 3 and 14 -> 314 * 10^-2
+ * @tparam Cell Type of the cell
+ * @param whole_part Whole part
+ * @param fractional_part Fractional part (digits after the decimal point)
+ * @return Float value
+ */
+template<typename Cell>
+BasicDecimalFloat<Cell> decimal_float_from_parts(Cell whole_part, Cell fractional_part);
+/**
+ * Extracts whole or fractional part of the float (instruction RTI)
+ * @tparam Cell Type of the cell
+ * @param value Float value
+ * @param whole_part True for the whole part, false for the fractional part
+ * @return Requested part
+ */
+template<typename Cell>
+Cell decimal_float_to_part(BasicDecimalFloat<Cell> value, bool whole_part);
+/**
+ * Checks if the OPF operation is a comparison (pushes one cell instead of a float)
+ * @param operation OPF operation
+ * @return True if the operation is a comparison; False otherwise
+ */
+bool decimal_float_is_comparison(int operation);
+/**
+ * Division of floats, adds digits after the decimal point until the division is exact, precision is exhausted
+ * or the next digit would overflow the mantissa
+ * @tparam Cell Type of the cell
+ * @param left Left operand
+ * @param right Right operand
+ * @return Result of the division
+ */
+template<typename Cell>
+BasicDecimalFloat<Cell> decimal_float_divide(BasicDecimalFloat<Cell> left, BasicDecimalFloat<Cell> right);
+
+/**
+ * Arithmetic operation on floats (instruction OPF with PL0_NEG, PL0_ADD, PL0_SUB, PL0_MUL, PL0_DIV or PL0_MOD)
+ * Inline, so the interpreter loops run the operations on operands of the same exponent (e.g. sums of prices) without a call;
+ * the mantissas wrap like the OPR arithmetic
+ * @tparam Cell Type of the cell
+ * @param operation OPF operation
+ * @param left Left operand (ignored by PL0_NEG)
+ * @param right Right operand
+ * @return Result of the operation
+ */
+template<typename Cell>
+inline BasicDecimalFloat<Cell> decimal_float_arithmetic(int operation, BasicDecimalFloat<Cell> left, BasicDecimalFloat<Cell> right) {
+    using Unsigned = std::make_unsigned_t<Cell>;
+    auto wrap = [](Unsigned value) { return static_cast<Cell>(value); };
+    switch (operation) {
+        case PL0_NEG:
+            return {wrap(static_cast<Unsigned>(0) - static_cast<Unsigned>(right.mantissa)), right.exponent};
+        case PL0_ADD:
+            decimal_float_align(left, right);
+            return {wrap(static_cast<Unsigned>(left.mantissa) + static_cast<Unsigned>(right.mantissa)), left.exponent};
+        case PL0_SUB:
+            decimal_float_align(left, right);
+            return {wrap(static_cast<Unsigned>(left.mantissa) - static_cast<Unsigned>(right.mantissa)), left.exponent};
+        case PL0_MUL:
+            return {wrap(static_cast<Unsigned>(left.mantissa) * static_cast<Unsigned>(right.mantissa)),
+                    wrap(static_cast<Unsigned>(left.exponent) + static_cast<Unsigned>(right.exponent))};
+        case PL0_DIV:
+            return decimal_float_divide(left, right);
+        case PL0_MOD:
+            if (right.mantissa == 0)
+                throw std::runtime_error("division by zero");
+            decimal_float_align(left, right);
+            return {right.mantissa == -1 ? static_cast<Cell>(0) : static_cast<Cell>(left.mantissa % right.mantissa), left.exponent};
+        default:
+            throw std::runtime_error("invalid float operation " + std::to_string(operation));
+    }
+}
+
+/**
+ * Comparison of floats (instruction OPF with PL0_EQ, PL0_NEQ, PL0_LT, PL0_GEQ, PL0_GRT or PL0_LEQ)
+ * @tparam Cell Type of the cell
+ * @param operation OPF operation
+ * @param left Left operand
+ * @param right Right operand
+ * @return 1 if the comparison holds; 0 otherwise
+ */
+template<typename Cell>
+inline Cell decimal_float_compare(int operation, BasicDecimalFloat<Cell> left, BasicDecimalFloat<Cell> right) {
+    decimal_float_align(left, right);
+    switch (operation) {
+        case PL0_EQ:
+            return left.mantissa == right.mantissa;
+        case PL0_NEQ:
+            return left.mantissa != right.mantissa;
+        case PL0_LT:
+            return left.mantissa < right.mantissa;
+        case PL0_GEQ:
+            return left.mantissa >= right.mantissa;
+        case PL0_GRT:
+            return left.mantissa > right.mantissa;
+        case PL0_LEQ:
+            return left.mantissa <= right.mantissa;
+        default:
+            throw std::runtime_error("invalid float operation " + std::to_string(operation));
+    }
+}
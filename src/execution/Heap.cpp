@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <vector>
+#include "Heap.h"
+#include "Snapshot.h"
+
+/** Number of the size classes of the exact sizes */
+const cell_t EXACT_SIZE_CLASSES = 16;
+
+template<typename Cell>
+BasicHeap<Cell>::BasicHeap(std::size_t max_size) :
+    memory(max_size), max_size(max_size), block_sizes(max_size + 1, 1), free_lists(), arena_next(0), arena_end(0), free_blocks(), statistics(),
+    roots(nullptr), collection_threshold(std::min<std::uint64_t>(MIN_COLLECTION_THRESHOLD, max_size / 2)) {
+    this->free_lists.fill(-1);
+}
+
+template<typename Cell>
+BasicHeap<Cell>::~BasicHeap() = default;
+
+template<typename Cell>
+std::size_t BasicHeap<Cell>::size_class(Cell block_size) {
+    if (block_size <= EXACT_SIZE_CLASSES)
+        return static_cast<std::size_t>(std::max<Cell>(block_size, 1) - 1);
+
+    /* Four classes per power of two, e.g. 17-20, 21-24, 25-28, 29-32 */
+    auto value = static_cast<std::uint64_t>(block_size - 1);
+    auto exponent = std::bit_width(value) - 1;
+    auto quarter = (value >> (exponent - 2)) & 3;
+    return EXACT_SIZE_CLASSES + (exponent - 4) * 4 + quarter;
+}
+
+template<typename Cell>
+Cell BasicHeap<Cell>::class_size(std::size_t index) {
+    if (index < EXACT_SIZE_CLASSES)
+        return static_cast<Cell>(index + 1);
+
+    auto exponent = (index - EXACT_SIZE_CLASSES) / 4 + 4;
+    auto quarter = (index - EXACT_SIZE_CLASSES) % 4;
+    return static_cast<Cell>((4 + quarter + 1) << (exponent - 2));
+}
+
+template<typename Cell>
+Cell BasicHeap<Cell>::grow(Cell cells) {
+    if (this->memory.size() + cells > this->max_size)
+        throw std::runtime_error("out of heap memory");
+
+    auto address = static_cast<Cell>(this->memory.size());
+    this->memory.resize(this->memory.size() + cells);
+    /* One more size, so that the address of an empty block at the end of the heap can be marked as allocated */
+    this->block_sizes.resize(this->memory.size() + 1);
+    this->statistics.heap_cells = this->memory.size();
+    return address;
+}
+
+template<typename Cell>
+Cell BasicHeap<Cell>::carve(std::size_t index) {
+    auto block_size = class_size(index);
+    if (this->arena_end - this->arena_next < block_size) {
+        /* Rest of the arena is split into the blocks of the largest classes that fit */
+        while (this->arena_next < this->arena_end) {
+            auto rest = this->arena_end - this->arena_next;
+            auto rest_index = size_class(std::min<Cell>(rest, SMALL_BLOCK_LIMIT));
+            if (class_size(rest_index) > rest)
+                rest_index--;
+            this->memory[this->arena_next] = this->free_lists[rest_index];
+            this->free_lists[rest_index] = this->arena_next;
+            this->arena_next += class_size(rest_index);
+            this->statistics.small_free_cells += class_size(rest_index);
+        }
+
+        /* Heap is full, the block is searched among the free large blocks */
+        auto cells = std::min<Cell>(ARENA_SIZE, static_cast<Cell>(this->max_size - this->memory.size()));
+        if (cells < block_size) {
+            this->statistics.arena_cells = 0;
+            return this->allocate_large(block_size);
+        }
+        this->arena_next = this->grow(cells);
+        this->arena_end = this->arena_next + cells;
+    }
+
+    auto block_address = this->arena_next;
+    this->arena_next += block_size;
+    this->statistics.arena_cells = this->arena_end - this->arena_next;
+    return block_address;
+}
+
+template<typename Cell>
+Cell BasicHeap<Cell>::allocate_large(Cell block_size) {
+    /* First fit */
+    for (auto it = this->free_blocks.begin(); it != this->free_blocks.end(); it++) {
+        auto [block_address, free_size] = *it;
+        if (free_size < block_size)
+            continue;
+
+        this->free_blocks.erase(it);
+        if (free_size > block_size)
+            this->free_blocks[block_address + block_size] = free_size - block_size;
+        this->statistics.large_free_cells -= block_size;
+        return block_address;
+    }
+
+    /* No free block is big enough, grow the heap */
+    return this->grow(block_size);
+}
+
+template<typename Cell>
+Cell BasicHeap<Cell>::allocate(Cell size) {
+    if (size < 0)
+        throw std::runtime_error("cannot allocate negative number of cells");
+    auto block_size = size + 1; /* One more cell for the header */
+
+    if (this->roots && this->statistics.live_cells + block_size > this->collection_threshold)
+        this->collect();
+
+    Cell block_address;
+    if (block_size <= SMALL_BLOCK_LIMIT) {
+        auto index = size_class(block_size);
+        if (this->free_lists[index] >= 0) {
+            block_address = this->free_lists[index];
+            this->free_lists[index] = this->memory[block_address];
+            this->statistics.small_free_cells -= class_size(index);
+        } else {
+            block_address = this->carve(index);
+        }
+        this->statistics.small_allocations++;
+        this->statistics.internal_fragmentation += class_size(index) - block_size;
+    } else {
+        block_address = this->allocate_large(block_size);
+    }
+
+    this->memory[block_address] = size;
+    this->block_sizes[block_address + 1] = block_size;
+    this->statistics.allocations++;
+    this->statistics.live_blocks++;
+    this->statistics.live_cells += block_size;
+    this->statistics.peak_live_cells = std::max(this->statistics.peak_live_cells, this->statistics.live_cells);
+    return block_address + 1;
+}
+
+template<typename Cell>
+void BasicHeap<Cell>::free_large(Cell block_address, Cell block_size) {
+    this->statistics.large_free_cells += block_size;
+
+    /* Coalesce with the following free block */
+    auto next = this->free_blocks.find(block_address + block_size);
+    if (next != this->free_blocks.end()) {
+        block_size += next->second;
+        this->free_blocks.erase(next);
+    }
+    /* Coalesce with the preceding free block */
+    auto previous = this->free_blocks.lower_bound(block_address);
+    if (previous != this->free_blocks.begin()) {
+        previous--;
+        if (previous->first + previous->second == block_address) {
+            previous->second += block_size;
+            return;
+        }
+    }
+    this->free_blocks[block_address] = block_size;
+}
+
+template<typename Cell>
+void BasicHeap<Cell>::free(Cell address) {
+    if (address < 1 || static_cast<std::size_t>(address) >= this->block_sizes.size() || this->block_sizes[address] == 0)
+        throw std::runtime_error("cannot delete heap address " + std::to_string(address) + " (not allocated)");
+
+    auto block_address = address - 1;
+    auto block_size = this->block_sizes[address];
+    this->block_sizes[address] = 0;
+    this->statistics.frees++;
+    this->statistics.live_blocks--;
+    this->statistics.live_cells -= block_size;
+
+    if (block_size <= SMALL_BLOCK_LIMIT) {
+        /* Header cell links the free list */
+        auto index = size_class(block_size);
+        this->memory[block_address] = this->free_lists[index];
+        this->free_lists[index] = block_address;
+        this->statistics.small_free_cells += class_size(index);
+        this->statistics.internal_fragmentation -= class_size(index) - block_size;
+    } else {
+        this->free_large(block_address, block_size);
+    }
+}
+
+template<typename Cell>
+bool BasicHeap<Cell>::is_allocated(Cell address) const {
+    return address >= 1 && static_cast<std::size_t>(address) < this->block_sizes.size() && this->block_sizes[address] != 0;
+}
+
+template<typename Cell>
+void BasicHeap<Cell>::enable_collection(const ReservedMemory<Cell> *roots) {
+    this->roots = roots;
+}
+
+template<typename Cell>
+void BasicHeap<Cell>::collect() {
+    /* Addresses of the allocated blocks in ascending order, the block of a value is found by the binary search */
+    std::vector<Cell> addresses;
+    addresses.reserve(this->statistics.live_blocks);
+    for (std::size_t address = 1; address < this->block_sizes.size(); address++) {
+        if (this->block_sizes[address] != 0)
+            addresses.push_back(static_cast<Cell>(address));
+    }
+
+    std::vector<bool> marked(addresses.size(), false);
+    std::vector<std::size_t> pending;
+    auto mark = [&](Cell value) {
+        if (value < 1 || static_cast<std::size_t>(value) >= this->memory.size())
+            return;
+        auto it = std::upper_bound(addresses.begin(), addresses.end(), value);
+        if (it == addresses.begin())
+            return;
+        it--;
+        /* Value may point anywhere into the block (pointer arithmetic), an empty block only by its address */
+        auto cells = std::max<Cell>(this->block_sizes[*it] - 1, 1);
+        auto index = static_cast<std::size_t>(it - addresses.begin());
+        if (value < *it + cells && !marked[index]) {
+            marked[index] = true;
+            pending.push_back(index);
+        }
+    };
+
+    for (auto value: *this->roots)
+        mark(value);
+    while (!pending.empty()) {
+        auto address = addresses[pending.back()];
+        pending.pop_back();
+        auto end = address + this->block_sizes[address] - 1;
+        for (auto cell = address; cell < end; cell++)
+            mark(this->memory[cell]);
+    }
+
+    for (std::size_t i = 0; i < addresses.size(); i++) {
+        if (marked[i])
+            continue;
+        this->statistics.reclaimed_blocks++;
+        this->statistics.reclaimed_cells += this->block_sizes[addresses[i]];
+        this->free(addresses[i]);
+    }
+
+    /* Next collection when the live cells double (explicitly deleted blocks do not count), before the heap is full */
+    this->statistics.collections++;
+    this->collection_threshold = std::min<std::uint64_t>(std::max(MIN_COLLECTION_THRESHOLD, 2 * this->statistics.live_cells),
+                                                         this->max_size / 2);
+}
+
+template<typename Cell>
+const HeapStatistics &BasicHeap<Cell>::get_statistics() const {
+    return this->statistics;
+}
+
+template<typename Cell>
+void BasicHeap<Cell>::save(ImageWriter &image) const {
+    /* Rest of the current arena is zero, only the cells up to the last non-zero cell are written */
+    auto cells = this->memory.size();
+    while (cells > 0 && this->memory[cells - 1] == 0)
+        cells--;
+    image.write<std::uint64_t>(this->memory.size());
+    image.write<std::uint64_t>(cells);
+    image.write_bytes(this->memory.data(), cells * sizeof(Cell));
+    /* Sizes of the blocks are sparse, only the allocated blocks are written */
+    image.write<std::uint64_t>(this->block_sizes.size() - std::count(this->block_sizes.begin(), this->block_sizes.end(), 0));
+    for (std::size_t address = 0; address < this->block_sizes.size(); address++) {
+        if (this->block_sizes[address] != 0) {
+            image.write<Cell>(static_cast<Cell>(address));
+            image.write<Cell>(this->block_sizes[address]);
+        }
+    }
+    image.write(this->free_lists);
+    image.write(this->arena_next);
+    image.write(this->arena_end);
+    image.write<std::uint64_t>(this->free_blocks.size());
+    for (const auto &[address, size]: this->free_blocks) {
+        image.write(address);
+        image.write(size);
+    }
+    image.write(this->statistics);
+    image.write(this->collection_threshold);
+}
+
+template<typename Cell>
+void BasicHeap<Cell>::restore(ImageReader &image) {
+    auto cells = image.read<std::uint64_t>();
+    if (cells > this->max_size)
+        throw std::runtime_error("heap of the snapshot image (" + std::to_string(cells) + " cells) exceeds the maximum size of the heap");
+    auto used = image.read<std::uint64_t>();
+    if (used > cells)
+        throw std::runtime_error("corrupted snapshot image");
+    /* Memory of the heap before the restore is released, the cells beyond the used ones stay zero */
+    this->memory.resize(0);
+    this->memory.resize(cells);
+    std::memcpy(this->memory.data(), image.read_bytes(used * sizeof(Cell)), used * sizeof(Cell));
+    this->block_sizes.resize(0);
+    this->block_sizes.resize(cells + 1);
+    auto blocks = image.read<std::uint64_t>();
+    for (std::uint64_t i = 0; i < blocks; i++) {
+        auto address = image.read<Cell>();
+        auto size = image.read<Cell>();
+        if (address <= 0 || static_cast<std::uint64_t>(address) > cells)
+            throw std::runtime_error("corrupted snapshot image");
+        this->block_sizes[address] = size;
+    }
+    this->free_lists = image.read<decltype(this->free_lists)>();
+    this->arena_next = image.read<Cell>();
+    this->arena_end = image.read<Cell>();
+    this->free_blocks.clear();
+    auto free_blocks = image.read<std::uint64_t>();
+    for (std::uint64_t i = 0; i < free_blocks; i++) {
+        auto address = image.read<Cell>();
+        this->free_blocks[address] = image.read<Cell>();
+    }
+    this->statistics = image.read<HeapStatistics>();
+    this->collection_threshold = image.read<std::uint64_t>();
+}
+
+template class BasicHeap<cell_t>;
+template class BasicHeap<compact_cell_t>;
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include "Cell.h"
+#include "ReservedMemory.h"
+
+class ImageWriter;
+class ImageReader;
+
+/** Default maximum size of the heap (in cells) */
+const std::size_t DEFAULT_HEAP_SIZE = 1 << 24;
+/** Largest block (in cells, including the header cell) served from the size classes */
+const cell_t SMALL_BLOCK_LIMIT = 1024;
+/** Size of the arena the small blocks are carved from (in cells) */
+const cell_t ARENA_SIZE = 8192;
+/** Number of the size classes (exact sizes up to 16 cells, then four classes per power of two up to SMALL_BLOCK_LIMIT) */
+const std::size_t NUMBER_OF_SIZE_CLASSES = 40;
+/** Minimal number of the live cells which triggers a collection */
+const std::uint64_t MIN_COLLECTION_THRESHOLD = 1 << 16;
+
+/**
+ * Structure representing allocation and fragmentation statistics of the heap
+ */
+typedef struct HeapStatistics {
+    /** Number of the allocations */
+    std::uint64_t allocations;
+    /** Number of the frees */
+    std::uint64_t frees;
+    /** Number of the allocations served from the size classes */
+    std::uint64_t small_allocations;
+    /** Number of the allocated blocks */
+    std::uint64_t live_blocks;
+    /** Cells of the allocated blocks as requested (including the header cells) */
+    std::uint64_t live_cells;
+    /** Maximum of live_cells */
+    std::uint64_t peak_live_cells;
+    /** Cells lost by rounding the small blocks up to their size class */
+    std::uint64_t internal_fragmentation;
+    /** Cells in the free lists of the size classes */
+    std::uint64_t small_free_cells;
+    /** Cells in the free large blocks */
+    std::uint64_t large_free_cells;
+    /** Cells of the current arena not yet carved */
+    std::uint64_t arena_cells;
+    /** Size of the heap (in cells) */
+    std::uint64_t heap_cells;
+    /** Number of the collections of the unreachable blocks */
+    std::uint64_t collections;
+    /** Number of the blocks freed by the collections */
+    std::uint64_t reclaimed_blocks;
+    /** Cells of the blocks freed by the collections (including the header cells) */
+    std::uint64_t reclaimed_cells;
+} HeapStatistics;
+
+/**
+ * Class representing the heap of the virtual machine
+ * Every block has one extra cell in front of it (at address - 1), generated code stores the length of the block there
+ * Small blocks (strings, short arrays) are rounded up to a size class and reused from the free list of the class,
+ * an empty free list is refilled by bumping the pointer of the current arena; the header cell of a free block links the list
+ * Large blocks are kept in an ordered map, allocated by the first fit strategy and coalesced when freed
+ * Optionally, the blocks no longer reachable from the roots (the stack) are collected by a conservative mark-sweep,
+ * every cell which holds an address inside an allocated block keeps the block alive
+ * @tparam Cell Type of the cell (cell_t or compact_cell_t)
+ */
+template<typename Cell>
+class BasicHeap {
+private:
+    /** Memory of the heap (reserved for the maximum size, grows in place) */
+    ReservedMemory<Cell> memory;
+    /** Maximum size of the heap */
+    std::size_t max_size;
+    /** Requested sizes of the allocated blocks including the header cell, indexed by the address returned by allocate (0 = not allocated) */
+    ReservedMemory<Cell> block_sizes;
+    /** Heads of the free lists of the size classes (address of the header cell, -1 = empty) */
+    std::array<Cell, NUMBER_OF_SIZE_CLASSES> free_lists;
+    /** Next free cell of the current arena */
+    Cell arena_next;
+    /** End of the current arena */
+    Cell arena_end;
+    /** Free large blocks (address of the block -> size of the block, both including the header cell) */
+    std::map<Cell, Cell> free_blocks;
+    /** Statistics */
+    HeapStatistics statistics;
+    /** Roots of the collection (nullptr if the collection is disabled) */
+    const ReservedMemory<Cell> *roots;
+    /** Number of the live cells which triggers the next collection */
+    std::uint64_t collection_threshold;
+
+    /**
+     * Returns size class of the block
+     * @param block_size Size of the block including the header cell (at most SMALL_BLOCK_LIMIT)
+     * @return Index of the size class
+     */
+    static std::size_t size_class(Cell block_size);
+    /**
+     * Returns size of the blocks of the size class
+     * @param index Index of the size class
+     * @return Size of the block including the header cell
+     */
+    static Cell class_size(std::size_t index);
+    /**
+     * Grows the memory of the heap
+     * @param cells Number of cells to add
+     * @return Address of the first added cell
+     */
+    Cell grow(Cell cells);
+    /**
+     * Carves a block of the size class from the current arena (a new arena is started if the block does not fit)
+     * @param index Index of the size class
+     * @return Address of the header cell of the block
+     */
+    Cell carve(std::size_t index);
+    /**
+     * Allocates a block by the first fit from the free large blocks (or the top of the heap)
+     * @param block_size Size of the block including the header cell
+     * @return Address of the header cell of the block
+     */
+    Cell allocate_large(Cell block_size);
+    /**
+     * Returns a free large block and coalesces it with its neighbours
+     * @param block_address Address of the header cell of the block
+     * @param block_size Size of the block including the header cell
+     */
+    void free_large(Cell block_address, Cell block_size);
+    /**
+     * Frees all blocks which are not reachable from the roots (conservative mark-sweep)
+     */
+    void collect();
+
+public:
+    /**
+     * Constructor
+     * @param max_size Maximum size of the heap (in cells)
+     */
+    explicit BasicHeap(std::size_t max_size = DEFAULT_HEAP_SIZE);
+    /**
+     * Destructor
+     */
+    ~BasicHeap();
+
+    /**
+     * Allocates a block on the heap
+     * @param size Number of cells to allocate
+     * @return Address of the first cell of the block
+     */
+    Cell allocate(Cell size);
+    /**
+     * Frees a block previously returned by allocate
+     * @param address Address of the block
+     */
+    void free(Cell address);
+    /**
+     * Enables the collection of the unreachable blocks (e.g. leaked string literals)
+     * Every value of the roots is treated as a possible address, so the collection never frees a reachable block
+     * @param roots Roots of the collection (memory of the stack, it must live as long as the heap)
+     */
+    void enable_collection(const ReservedMemory<Cell> *roots);
+    /**
+     * Checks if the block is allocated (e.g. it was not freed by the collection)
+     * @param address Address of the block
+     * @return True if allocated; False otherwise
+     */
+    [[nodiscard]] bool is_allocated(Cell address) const;
+
+    /**
+     * Get allocation and fragmentation statistics
+     * @return Statistics
+     */
+    [[nodiscard]] const HeapStatistics &get_statistics() const;
+
+    /**
+     * Writes the memory, the free lists and the statistics of the heap to the snapshot image
+     * @param image Snapshot image
+     */
+    void save(ImageWriter &image) const;
+    /**
+     * Restores the heap saved by save (the collection stays as enabled)
+     * Throws std::runtime_error if the saved heap is larger than the maximum size of the heap
+     * @param image Snapshot image
+     */
+    void restore(ImageReader &image);
+
+    /**
+     * Checks if the cells are in the range of the heap (their load and store do not fail)
+     * @param address Address of the first cell
+     * @param cells Number of the cells
+     * @return True if in the range; False otherwise
+     */
+    [[nodiscard]] bool contains(Cell address, Cell cells) const {
+        return address >= 0 && cells >= 0 && static_cast<std::size_t>(address) <= this->memory.size()
+               && static_cast<std::size_t>(cells) <= this->memory.size() - static_cast<std::size_t>(address);
+    }
+    /**
+     * Loads a cell from the heap
+     * @param address Address of the cell
+     * @return Value of the cell
+     */
+    [[nodiscard]] Cell load(Cell address) const {
+        if (address < 0 || static_cast<std::size_t>(address) >= this->memory.size())
+            throw std::runtime_error("heap address " + std::to_string(address) + " out of range");
+        return this->memory[address];
+    }
+    /**
+     * Stores a value into a cell of the heap
+     * @param address Address of the cell
+     * @param value Value to store
+     */
+    void store(Cell address, Cell value) {
+        if (address < 0 || static_cast<std::size_t>(address) >= this->memory.size())
+            throw std::runtime_error("heap address " + std::to_string(address) + " out of range");
+        this->memory[address] = value;
+    }
+};
+
+/** Heap of the virtual machine with the 64-bit cells */
+typedef BasicHeap<cell_t> Heap;
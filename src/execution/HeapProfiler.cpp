@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+#include "HeapProfiler.h"
+
+/** Number of the allocation sites in the summary */
+const std::size_t REPORTED_SITES = 10;
+
+/**
+ * Returns JSON string literal
+ * @param value String
+ * @return Quoted and escaped string
+ */
+static std::string json_string(const std::string &value) {
+    std::string result = "\"";
+    for (auto character: value) {
+        if (character == '"' || character == '\\')
+            result += '\\';
+        result += character;
+    }
+    return result + "\"";
+}
+
+HeapProfiler::HeapProfiler(const Heap &heap) :
+    heap(heap), sites(), blocks(), histogram(), live_cells(0), peak_live_cells(0), peak_instructions(0), instructions(0), samples(),
+    sample_interval(1) {
+    this->histogram.fill(0);
+}
+
+HeapProfiler::~HeapProfiler() = default;
+
+void HeapProfiler::release(std::unordered_map<cell_t, std::pair<std::uint32_t, cell_t>>::iterator block, bool collected) {
+    auto &site = this->sites[block->second.first];
+    if (collected)
+        site.collected++;
+    else
+        site.frees++;
+    this->live_cells -= block->second.second;
+    this->blocks.erase(block);
+}
+
+void HeapProfiler::sample(std::uint64_t instructions) {
+    if (!this->samples.empty() && instructions < this->samples.back().instructions + this->sample_interval)
+        return;
+    this->samples.push_back(HeapSample{instructions, this->live_cells, this->blocks.size()});
+
+    /* Every other sample is dropped, so the samples keep covering the whole run */
+    if (this->samples.size() >= MAX_HEAP_SAMPLES) {
+        for (std::size_t i = 0; i < this->samples.size() / 2; i++)
+            this->samples[i] = this->samples[2 * i];
+        this->samples.resize(this->samples.size() / 2);
+        this->sample_interval *= 2;
+    }
+}
+
+void HeapProfiler::allocate(std::uint32_t site, std::uint32_t function, cell_t address, cell_t size, std::uint64_t instructions) {
+    /* Address allocated again, the previous block was freed by the collection */
+    auto previous = this->blocks.find(address);
+    if (previous != this->blocks.end())
+        this->release(previous, true);
+
+    auto [it, inserted] = this->sites.try_emplace(site, AllocationSite{function, 0, 0, 0, 0, 0, 0});
+    auto &allocation_site = it->second;
+    auto cells = size + 1;
+    allocation_site.allocations++;
+    allocation_site.allocated_cells += cells;
+    this->blocks[address] = {site, cells};
+    this->histogram[std::min<std::size_t>(std::bit_width(static_cast<std::uint64_t>(size)), HEAP_HISTOGRAM_BUCKETS - 1)]++;
+
+    this->live_cells += cells;
+    if (this->live_cells > this->peak_live_cells) {
+        this->peak_live_cells = this->live_cells;
+        this->peak_instructions = instructions;
+    }
+    this->sample(instructions);
+}
+
+void HeapProfiler::free(cell_t address, std::uint64_t instructions) {
+    auto block = this->blocks.find(address);
+    if (block != this->blocks.end())
+        this->release(block, false);
+    this->sample(instructions);
+}
+
+void HeapProfiler::finish(std::uint64_t instructions) {
+    this->instructions = instructions;
+    for (auto it = this->blocks.begin(); it != this->blocks.end();) {
+        auto block = it++;
+        if (!this->heap.is_allocated(block->first)) {
+            this->release(block, true);
+            continue;
+        }
+        auto &site = this->sites[block->second.first];
+        site.leaked_blocks++;
+        site.leaked_cells += block->second.second;
+    }
+
+    /* Last sample is the end of the run */
+    if (this->samples.empty() || this->samples.back().instructions != instructions)
+        this->samples.push_back(HeapSample{instructions, this->live_cells, this->blocks.size()});
+}
+
+void HeapProfiler::write_json(std::ostream &output, const Profiler &profiler) const {
+    const auto cell_bytes = sizeof(cell_t);
+    AllocationSite total{0, 0, 0, 0, 0, 0, 0};
+    std::map<std::uint32_t, AllocationSite> functions;
+    for (auto &[address, site]: this->sites) {
+        for (auto *sum: {&total, &functions[site.function]}) {
+            sum->function = site.function;
+            sum->allocations += site.allocations;
+            sum->allocated_cells += site.allocated_cells;
+            sum->frees += site.frees;
+            sum->collected += site.collected;
+            sum->leaked_blocks += site.leaked_blocks;
+            sum->leaked_cells += site.leaked_cells;
+        }
+    }
+    auto counts = [&](const AllocationSite &site) {
+        output << "\"allocations\": " << site.allocations << ", \"allocated_bytes\": " << site.allocated_cells * cell_bytes
+               << ", \"frees\": " << site.frees << ", \"collected\": " << site.collected
+               << ", \"leaked_blocks\": " << site.leaked_blocks << ", \"leaked_bytes\": " << site.leaked_cells * cell_bytes;
+    };
+
+    output << "{\n";
+    output << "  \"cell_bytes\": " << cell_bytes << ",\n";
+    output << "  \"instructions\": " << this->instructions << ",\n";
+    output << "  ";
+    counts(total);
+    output << ",\n";
+    output << "  \"peak_live_bytes\": " << this->peak_live_cells * cell_bytes << ",\n";
+    output << "  \"peak_instructions\": " << this->peak_instructions << ",\n";
+    output << "  \"final_live_bytes\": " << this->live_cells * cell_bytes << ",\n";
+
+    output << "  \"functions\": [";
+    auto first = true;
+    for (auto &[entry, function]: functions) {
+        output << (first ? "\n" : ",\n") << "    {\"entry\": " << entry << ", \"name\": " << json_string(profiler.function_name(entry)) << ", ";
+        counts(function);
+        output << "}";
+        first = false;
+    }
+    output << "\n  ],\n";
+
+    output << "  \"sites\": [";
+    first = true;
+    for (auto &[address, site]: this->sites) {
+        output << (first ? "\n" : ",\n") << "    {\"address\": " << address << ", \"function\": " << json_string(profiler.function_name(site.function)) << ", ";
+        counts(site);
+        output << "}";
+        first = false;
+    }
+    output << "\n  ],\n";
+
+    output << "  \"size_histogram\": [";
+    first = true;
+    for (std::size_t i = 0; i < HEAP_HISTOGRAM_BUCKETS; i++) {
+        if (this->histogram[i] == 0)
+            continue;
+        auto min_cells = i == 0 ? 0 : std::uint64_t(1) << (i - 1);
+        auto max_cells = i == 0 ? 0 : (std::uint64_t(1) << i) - 1;
+        output << (first ? "\n" : ",\n") << "    {\"min_cells\": " << min_cells << ", \"max_cells\": " << max_cells
+               << ", \"allocations\": " << this->histogram[i] << "}";
+        first = false;
+    }
+    output << "\n  ],\n";
+
+    output << "  \"timeline\": [";
+    first = true;
+    for (auto &sample: this->samples) {
+        output << (first ? "\n" : ",\n") << "    {\"instructions\": " << sample.instructions << ", \"live_bytes\": " << sample.live_cells * cell_bytes
+               << ", \"live_blocks\": " << sample.live_blocks << "}";
+        first = false;
+    }
+    output << "\n  ]\n";
+    output << "}" << std::endl;
+}
+
+void HeapProfiler::write_report(std::ostream &output, const Profiler &profiler) const {
+    const auto cell_bytes = sizeof(cell_t);
+    std::uint64_t allocations = 0, allocated_cells = 0, frees = 0, collected = 0, leaked_blocks = 0, leaked_cells = 0;
+    std::vector<std::pair<std::uint32_t, AllocationSite>> leaks;
+    for (auto &[address, site]: this->sites) {
+        allocations += site.allocations;
+        allocated_cells += site.allocated_cells;
+        frees += site.frees;
+        collected += site.collected;
+        leaked_blocks += site.leaked_blocks;
+        leaked_cells += site.leaked_cells;
+        if (site.leaked_blocks > 0)
+            leaks.emplace_back(address, site);
+    }
+    std::stable_sort(leaks.begin(), leaks.end(), [](const auto &left, const auto &right) {
+        return left.second.leaked_cells > right.second.leaked_cells;
+    });
+
+    output << "Heap profile: " << allocations << " allocations (" << allocated_cells * cell_bytes << " bytes), " << frees << " frees";
+    if (collected > 0)
+        output << ", " << collected << " collected";
+    output << ", peak live " << this->peak_live_cells * cell_bytes << " bytes at instruction " << this->peak_instructions << std::endl;
+    output << "Never freed: " << leaked_blocks << " blocks (" << leaked_cells * cell_bytes << " bytes)" << std::endl;
+    if (leaks.empty())
+        return;
+    output << std::setw(14) << "bytes" << std::setw(12) << "blocks" << "  NEW  function" << std::endl;
+    for (std::size_t i = 0; i < leaks.size() && i < REPORTED_SITES; i++) {
+        auto &[address, site] = leaks[i];
+        output << std::setw(14) << site.leaked_cells * cell_bytes << std::setw(12) << site.leaked_blocks << "  " << address
+               << "  " << profiler.function_name(site.function) << std::endl;
+    }
+}
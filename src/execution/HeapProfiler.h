@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+#include "Cell.h"
+#include "Heap.h"
+#include "Profiler.h"
+
+/** Maximum number of the samples of the live heap over time */
+const std::size_t MAX_HEAP_SAMPLES = 1024;
+/** Number of the buckets of the allocation size histogram (powers of two of the requested cells) */
+const std::size_t HEAP_HISTOGRAM_BUCKETS = 34;
+
+/**
+ * Struct for NEW instruction of the heap profile
+ */
+typedef struct AllocationSite {
+    /** Entry address of the function executing the NEW (first one, if more functions share the code) */
+    std::uint32_t function;
+    /** Number of the allocations */
+    std::uint64_t allocations;
+    /** Allocated cells (including the header cells) */
+    std::uint64_t allocated_cells;
+    /** Number of the blocks freed by DEL */
+    std::uint64_t frees;
+    /** Number of the blocks freed by the collection */
+    std::uint64_t collected;
+    /** Number of the blocks never freed */
+    std::uint64_t leaked_blocks;
+    /** Cells of the blocks never freed (including the header cells) */
+    std::uint64_t leaked_cells;
+} AllocationSite;
+
+/**
+ * Struct for sample of the live heap
+ */
+typedef struct HeapSample {
+    /** Number of the executed instructions */
+    std::uint64_t instructions;
+    /** Cells of the allocated blocks (including the header cells) */
+    std::uint64_t live_cells;
+    /** Number of the allocated blocks */
+    std::uint64_t live_blocks;
+} HeapSample;
+
+/**
+ * Class for allocation profile of the executed program
+ * The virtual machine reports every NEW and DEL of the profiled run, every allocation is attributed to its NEW instruction
+ * and to the executed function (taken from the call tree of the instruction profiler)
+ * Blocks freed by the collection are noticed when their address is allocated again and at the end of the run
+ */
+class HeapProfiler {
+private:
+    /** Profiled heap */
+    const Heap &heap;
+    /** Allocation sites (address of the NEW instruction -> site) */
+    std::map<std::uint32_t, AllocationSite> sites;
+    /** Allocated blocks (address of the block -> address of the NEW instruction, cells including the header cell) */
+    std::unordered_map<cell_t, std::pair<std::uint32_t, cell_t>> blocks;
+    /** Number of the allocations by the requested cells (bucket 0 for 0 cells, bucket k for 2^(k-1) to 2^k - 1 cells) */
+    std::array<std::uint64_t, HEAP_HISTOGRAM_BUCKETS> histogram;
+    /** Cells of the allocated blocks */
+    std::uint64_t live_cells;
+    /** Maximum of live_cells */
+    std::uint64_t peak_live_cells;
+    /** Number of the executed instructions when the peak was reached */
+    std::uint64_t peak_instructions;
+    /** Number of the executed instructions at the end of the run */
+    std::uint64_t instructions;
+    /** Samples of the live heap */
+    std::vector<HeapSample> samples;
+    /** Number of the instructions between two samples (doubled whenever the samples are thinned out) */
+    std::uint64_t sample_interval;
+
+    /**
+     * Removes the block from the allocated blocks
+     * @param block Iterator of the block
+     * @param collected True if the block was freed by the collection; False if by DEL
+     */
+    void release(std::unordered_map<cell_t, std::pair<std::uint32_t, cell_t>>::iterator block, bool collected);
+    /**
+     * Records sample of the live heap if the sample interval elapsed
+     * @param instructions Number of the executed instructions
+     */
+    void sample(std::uint64_t instructions);
+
+public:
+    /**
+     * Constructor
+     * @param heap Profiled heap
+     */
+    explicit HeapProfiler(const Heap &heap);
+    /**
+     * Destructor
+     */
+    ~HeapProfiler();
+
+    /**
+     * Records allocation
+     * @param site Address of the NEW instruction
+     * @param function Entry address of the executed function
+     * @param address Address of the allocated block
+     * @param size Requested number of cells
+     * @param instructions Number of the executed instructions
+     */
+    void allocate(std::uint32_t site, std::uint32_t function, cell_t address, cell_t size, std::uint64_t instructions);
+    /**
+     * Records free by DEL
+     * @param address Address of the freed block
+     * @param instructions Number of the executed instructions
+     */
+    void free(cell_t address, std::uint64_t instructions);
+    /**
+     * Finishes the profile, the remaining blocks are never freed
+     * @param instructions Number of the executed instructions
+     */
+    void finish(std::uint64_t instructions);
+
+    /**
+     * Writes the profile as JSON (sites, functions, size histogram and live heap over time, sizes in bytes)
+     * @param output Output stream
+     * @param profiler Instruction profiler (names of the functions)
+     */
+    void write_json(std::ostream &output, const Profiler &profiler) const;
+    /**
+     * Writes summary of the profile (peak heap and the sites of the never freed blocks)
+     * @param output Output stream
+     * @param profiler Instruction profiler (names of the functions)
+     */
+    void write_report(std::ostream &output, const Profiler &profiler) const;
+};
@@ -0,0 +1,224 @@
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include "Intrinsics.h"
+#include "DecimalFloat.h"
+
+/** Stack cells above the base any builtin function but read_str needs at most (print_float calls print_int with its digits) */
+const cell_t INTRINSIC_STACK_CELLS = 64;
+
+/**
+ * Wrapping step of the number parsing of read_int and read_float, result * 10 + (character - '0')
+ * @tparam Cell Type of the cell
+ * @param result Number parsed so far
+ * @param character Read character
+ * @return Number
+ */
+template<typename Cell>
+static Cell parse_digit(Cell result, unsigned char character) {
+    using Unsigned = std::make_unsigned_t<Cell>;
+    auto digit = static_cast<Unsigned>(static_cast<Unsigned>(character) - static_cast<Unsigned>('0'));
+    return static_cast<Cell>(static_cast<Unsigned>(digit + static_cast<Unsigned>(static_cast<Unsigned>(result) * 10)));
+}
+
+/**
+ * Writes the number the way print_int does (digits of the negative number are written as the characters below '0')
+ * @tparam Cell Type of the cell
+ * @param output Output of the program
+ * @param number Number
+ */
+template<typename Cell>
+static void print_number(OutputBuffer &output, Cell number) {
+    char digits[20];
+    auto count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + number % 10);
+        number /= 10;
+    } while (number != 0);
+    while (count > 0)
+        output.put(digits[--count]);
+}
+
+/**
+ * Checks the string on the heap, its length is in the cell in front of it
+ * @tparam Cell Type of the cell
+ * @param heap Heap
+ * @param string Address of the string
+ * @param length Length of the string (output)
+ * @return True if the string is in the heap and its length is positive; False otherwise
+ */
+template<typename Cell>
+static bool string_length(const BasicHeap<Cell> &heap, Cell string, Cell &length) {
+    if (!heap.contains(string - 1, 1))
+        return false;
+    length = heap.load(string - 1);
+    return length > 0 && heap.contains(string, length);
+}
+
+/**
+ * Allocates the block like NEW
+ * @tparam Cell Type of the cell
+ * @param heap Heap
+ * @param size Number of cells to allocate
+ * @param address Address of the block (output)
+ * @return True if allocated; False if the allocation failed (the PL/0 code fails the same way)
+ */
+template<typename Cell>
+static bool allocate(BasicHeap<Cell> &heap, Cell size, Cell &address) {
+    try {
+        address = heap.allocate(size);
+    } catch (const std::runtime_error &) {
+        return false;
+    }
+    return true;
+}
+
+std::vector<BuiltinEntry> find_builtin_entries(const std::map<std::uint32_t, std::string> &functions) {
+    std::vector<BuiltinEntry> entries;
+    for (const auto &[address, name]: functions) {
+        for (auto function = 0; function < BUILTIN_NUM_OF_FUNCTIONS; function++) {
+            if (name == BuiltinFunctionNames[function])
+                entries.push_back(BuiltinEntry{address, static_cast<BuiltinFunction>(function)});
+        }
+    }
+    return entries;
+}
+
+std::vector<BuiltinEntry> parse_builtin_entries(std::istream &input) {
+    std::map<std::uint32_t, std::string> functions;
+    std::string line;
+    while (std::getline(input, line)) {
+        auto line_stream = std::istringstream(line);
+        std::uint32_t entry;
+        std::string name;
+        if (line_stream >> entry >> name)
+            functions[entry] = name;
+    }
+    return find_builtin_entries(functions);
+}
+
+template<typename Cell>
+bool run_intrinsic(BuiltinFunction function, Cell *stack, Cell stack_size, Cell base, BasicHeap<Cell> &heap, InputBuffer &input, OutputBuffer &output) {
+    /* Arguments and the result take at most three cells of the caller */
+    if (base < 3 || base + INTRINSIC_STACK_CELLS >= stack_size)
+        return false;
+
+    switch (function) {
+        case BUILTIN_PRINT_INT:
+            print_number(output, stack[base - 1]);
+            return true;
+        case BUILTIN_READ_INT: {
+            /* Whole line must be read ahead, the PL/0 code reads the rest (and the end of the input) itself */
+            auto line = input.peek();
+            auto end = line.find('\n');
+            if (end == std::string_view::npos)
+                return false;
+            Cell result = 0;
+            for (std::size_t i = 0; i < end; i++)
+                result = parse_digit(result, static_cast<unsigned char>(line[i]));
+            input.skip(end + 1);
+            stack[base - 1] = result;
+            return true;
+        }
+        case BUILTIN_PRINT_STR: {
+            Cell length;
+            auto string = stack[base - 1];
+            if (!string_length(heap, string, length))
+                return false;
+            for (Cell i = 0; i < length; i++)
+                output.put(static_cast<char>(heap.load(string + i)));
+            return true;
+        }
+        case BUILTIN_READ_STR: {
+            /* PL/0 code keeps the line on the stack, an empty line overruns the copy */
+            auto line = input.peek();
+            auto end = line.find('\n');
+            if (end == std::string_view::npos || end == 0 || static_cast<std::size_t>(stack_size - base - INTRINSIC_STACK_CELLS) <= end)
+                return false;
+            auto length = static_cast<Cell>(end);
+            Cell string;
+            if (!allocate(heap, length, string))
+                return false;
+            heap.store(string - 1, length);
+            for (Cell i = 0; i < length; i++)
+                heap.store(string + i, static_cast<unsigned char>(line[i]));
+            input.skip(end + 1);
+            stack[base - 1] = string;
+            return true;
+        }
+        case BUILTIN_STRCMP: {
+            Cell first_length, second_length;
+            auto first = stack[base - 2], second = stack[base - 1];
+            if (!heap.contains(first - 1, 1) || !heap.contains(second - 1, 1))
+                return false;
+            if (heap.load(first - 1) != heap.load(second - 1)) {
+                stack[base - 3] = 0;
+                return true;
+            }
+            if (!string_length(heap, first, first_length) || !string_length(heap, second, second_length))
+                return false;
+            Cell result = 1;
+            for (Cell i = 0; i < first_length && result != 0; i++)
+                result = heap.load(first + i) == heap.load(second + i);
+            stack[base - 3] = result;
+            return true;
+        }
+        case BUILTIN_STRCAT: {
+            Cell first_length, second_length;
+            auto first = stack[base - 2], second = stack[base - 1];
+            if (!string_length(heap, first, first_length) || !string_length(heap, second, second_length))
+                return false;
+            Cell result;
+            if (!allocate(heap, first_length + second_length, result))
+                return false;
+            /* Cells are copied in the order of the PL/0 code, so the result is the same even if a freed string overlaps it */
+            heap.store(result - 1, first_length + second_length);
+            for (Cell i = 0; i < first_length; i++)
+                heap.store(result + i, heap.load(first + i));
+            for (Cell i = 0; i < second_length; i++)
+                heap.store(result + first_length + i, heap.load(second + i));
+            stack[base - 3] = result;
+            return true;
+        }
+        case BUILTIN_STRLEN:
+            if (!heap.contains(stack[base - 1] - 1, 1))
+                return false;
+            stack[base - 2] = heap.load(stack[base - 1] - 1);
+            return true;
+        case BUILTIN_PRINT_FLOAT: {
+            auto value = BasicDecimalFloat<Cell>{stack[base - 2], stack[base - 1]};
+            print_number(output, decimal_float_to_part(value, true));
+            output.put('.');
+            print_number(output, decimal_float_to_part(value, false));
+            return true;
+        }
+        case BUILTIN_READ_FLOAT: {
+            /* Whole part is read until '.', the fractional part by read_int until the end of the line */
+            auto line = input.peek();
+            auto point = line.find('.');
+            auto end = point == std::string_view::npos ? point : line.find('\n', point + 1);
+            if (end == std::string_view::npos)
+                return false;
+            Cell whole_part = 0, fractional_part = 0;
+            for (std::size_t i = 0; i < point; i++)
+                whole_part = parse_digit(whole_part, static_cast<unsigned char>(line[i]));
+            for (auto i = point + 1; i < end; i++)
+                fractional_part = parse_digit(fractional_part, static_cast<unsigned char>(line[i]));
+            /* Invalid fractional part fails in ITR of the PL/0 code */
+            if (fractional_part < 0)
+                return false;
+            auto value = decimal_float_from_parts(whole_part, fractional_part);
+            input.skip(end + 1);
+            stack[base - 2] = value.mantissa;
+            stack[base - 1] = value.exponent;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+template bool run_intrinsic(BuiltinFunction function, cell_t *stack, cell_t stack_size, cell_t base, Heap &heap, InputBuffer &input,
+                            OutputBuffer &output);
+template bool run_intrinsic(BuiltinFunction function, compact_cell_t *stack, compact_cell_t stack_size, compact_cell_t base,
+                            BasicHeap<compact_cell_t> &heap, InputBuffer &input, OutputBuffer &output);
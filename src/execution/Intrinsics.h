@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+#include "BufferedIo.h"
+#include "Cell.h"
+#include "Heap.h"
+
+/**
+ * Enum for builtin functions generated by the compiler as PL/0 code (InstructionsGenerator::init_builtin_functions)
+ */
+enum BuiltinFunction {
+    BUILTIN_PRINT_INT,
+    BUILTIN_READ_INT,
+    BUILTIN_PRINT_STR,
+    BUILTIN_READ_STR,
+    BUILTIN_STRCMP,
+    BUILTIN_STRCAT,
+    BUILTIN_STRLEN,
+    BUILTIN_PRINT_FLOAT,
+    BUILTIN_READ_FLOAT,
+    BUILTIN_NUM_OF_FUNCTIONS
+};
+
+/** Names of the builtin functions ordered by the BuiltinFunction enum (the names in functions.txt) */
+const char *const BuiltinFunctionNames[BUILTIN_NUM_OF_FUNCTIONS] = {
+    "print_int", "read_int", "print_str", "read_str", "strcmp", "strcat", "strlen", "print_float", "read_float"
+};
+
+/**
+ * Struct for entry of the builtin function in the program
+ */
+typedef struct BuiltinEntry {
+    /** Entry address (INT of the activation record) */
+    std::uint32_t address;
+    /** Builtin function */
+    BuiltinFunction function;
+} BuiltinEntry;
+
+/**
+ * Finds the builtin functions among the entries of the functions
+ * @param functions Entry addresses and names of the functions (InstructionsGenerator::get_function_entries)
+ * @return Entries of the builtin functions
+ */
+std::vector<BuiltinEntry> find_builtin_entries(const std::map<std::uint32_t, std::string> &functions);
+/**
+ * Parses the entries of the builtin functions (the format of functions.txt generated by the compiler, "<entry address> <name>" per line)
+ * @param input Input stream
+ * @return Entries of the builtin functions
+ */
+std::vector<BuiltinEntry> parse_builtin_entries(std::istream &input);
+
+/**
+ * Runs the builtin function natively, called at its entry after CAL (the arguments and the result are below the base)
+ * The effect equals to its PL/0 code - the result, the heap, the consumed input and the output (only the temporary cells
+ * of the PL/0 code above the base are not written); the cases the PL/0 code handles differently are left to it:
+ * a line of the input which was not read ahead yet (or the end of the input), a string of non-positive length
+ * or out of the heap, an empty line read as a string, a failed allocation or too little of the stack
+ * @tparam Cell Type of the cell (cell_t or compact_cell_t)
+ * @param function Builtin function
+ * @param stack Stack
+ * @param stack_size Size of the stack (in cells)
+ * @param base Base of the activation record of the builtin function
+ * @param heap Heap
+ * @param input Input of the program
+ * @param output Output of the program
+ * @return True if the function was run; False if nothing was changed and the PL/0 code must run
+ */
+template<typename Cell>
+bool run_intrinsic(BuiltinFunction function, Cell *stack, Cell stack_size, Cell base, BasicHeap<Cell> &heap, InputBuffer &input, OutputBuffer &output);
@@ -0,0 +1,547 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include "Jit.h"
+#include "X86Assembler.h"
+
+#if YADC_VM_JIT
+#include <sys/mman.h>
+
+/* Size of the memory probing the protection switch (one page) */
+static const std::size_t JIT_PROBE_SIZE = 4096;
+
+/* Registers of the compiled code (callee-saved, so they survive the helper calls) */
+static const X86Register STACK = X86_RBX;
+static const X86Register STACK_SIZE = X86_RBP;
+static const X86Register B = X86_R12;
+static const X86Register T = X86_R13;
+static const X86Register STATE = X86_R14;
+static const X86Register COUNTER = X86_R15;
+
+/* Offsets of the JitState members */
+static const auto STATE_STACK = static_cast<std::int32_t>(offsetof(JitState, stack));
+static const auto STATE_STACK_SIZE = static_cast<std::int32_t>(offsetof(JitState, stack_size));
+static const auto STATE_B = static_cast<std::int32_t>(offsetof(JitState, b));
+static const auto STATE_T = static_cast<std::int32_t>(offsetof(JitState, t));
+static const auto STATE_COUNTER = static_cast<std::int32_t>(offsetof(JitState, instruction_counter));
+static const auto STATE_ENTRIES = static_cast<std::int32_t>(offsetof(JitState, entries));
+static const auto STATE_P = static_cast<std::int32_t>(offsetof(JitState, p));
+static const auto STATE_EXIT = static_cast<std::int32_t>(offsetof(JitState, exit));
+
+/*
+ * Helpers called by the compiled code (they must not throw through the compiled code,
+ * failure is returned and the compiled code leaves to the interpreter, which reports the error)
+ */
+
+static std::int64_t jit_read(JitState *state) {
+    auto character = state->input->get();
+    /* End of input behaves as the input terminator (ASCII 10) */
+    return character == END_OF_INPUT ? '\n' : character;
+}
+
+static void jit_write(JitState *state, cell_t value) {
+    state->output->put(static_cast<char>(value));
+}
+
+static std::int64_t jit_new(JitState *state, cell_t size, cell_t *result) {
+    try {
+        *result = state->heap->allocate(size);
+        return 0;
+    } catch (const std::exception &) {
+        return 1;
+    }
+}
+
+static std::int64_t jit_delete(JitState *state, cell_t address) {
+    try {
+        state->heap->free(address);
+        return 0;
+    } catch (const std::exception &) {
+        return 1;
+    }
+}
+
+static std::int64_t jit_load(JitState *state, cell_t address, cell_t *result) {
+    try {
+        *result = state->heap->load(address);
+        return 0;
+    } catch (const std::exception &) {
+        return 1;
+    }
+}
+
+static std::int64_t jit_store(JitState *state, cell_t address, cell_t value) {
+    try {
+        state->heap->store(address, value);
+        return 0;
+    } catch (const std::exception &) {
+        return 1;
+    }
+}
+
+/**
+ * Emits call of the helper
+ * @param assembler Assembler
+ * @param helper Address of the helper
+ */
+static void call_helper(X86Assembler &assembler, const void *helper) {
+    assembler.mov(X86_RDI, STATE);
+    assembler.mov_immediate(X86_RAX, static_cast<std::int64_t>(reinterpret_cast<std::uintptr_t>(helper)));
+    assembler.call(X86_RAX);
+}
+
+JitCompiler::JitCompiler(const std::vector<DecodedInstruction> &instructions, std::uint32_t threshold) :
+    instructions(instructions), threshold(threshold), functions(), calls(instructions.size() + 1, 0), entries(instructions.size() + 1, nullptr),
+    memory(nullptr), memory_used(0), enter(nullptr), leave(0), compiled_functions(0) {
+    /* Functions are delimited by the CAL targets */
+    for (const auto &instruction : instructions)
+        if (instruction.opcode == PL0_CAL && instruction.parameter >= 0 && static_cast<std::size_t>(instruction.parameter) < instructions.size())
+            this->functions.push_back(instruction.parameter);
+    std::sort(this->functions.begin(), this->functions.end());
+    this->functions.erase(std::unique(this->functions.begin(), this->functions.end()), this->functions.end());
+
+    auto memory = mmap(nullptr, JIT_CODE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+        throw std::runtime_error("cannot allocate executable memory");
+    this->memory = static_cast<std::uint8_t *>(memory);
+    this->generate_trampolines();
+}
+
+JitCompiler::~JitCompiler() {
+    munmap(this->memory, JIT_CODE_SIZE);
+}
+
+bool JitCompiler::is_available() {
+    /* Policies like SELinux execmem or PaX MPROTECT refuse to make the written memory executable, so the switch is probed once */
+    static const auto available = []() {
+        auto memory = mmap(nullptr, JIT_PROBE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+            return false;
+        auto switched = mprotect(memory, JIT_PROBE_SIZE, PROT_READ | PROT_EXEC) == 0 && mprotect(memory, JIT_PROBE_SIZE, PROT_READ | PROT_WRITE) == 0;
+        munmap(memory, JIT_PROBE_SIZE);
+        return switched;
+    }();
+    return available;
+}
+
+std::uint8_t *JitCompiler::install(const std::vector<std::uint8_t> &code) {
+    if (this->memory_used + code.size() > JIT_CODE_SIZE)
+        return nullptr;
+
+    /* Memory is never writable and executable at the same time, the code which cannot be made executable is not installed */
+    auto address = this->memory + this->memory_used;
+    if (mprotect(this->memory, JIT_CODE_SIZE, PROT_READ | PROT_WRITE) != 0)
+        return nullptr;
+    std::memcpy(address, code.data(), code.size());
+    if (mprotect(this->memory, JIT_CODE_SIZE, PROT_READ | PROT_EXEC) != 0)
+        return nullptr;
+    this->memory_used = (this->memory_used + code.size() + 15) & ~static_cast<std::size_t>(15);
+    return address;
+}
+
+void JitCompiler::generate_trampolines() {
+    auto assembler = X86Assembler(reinterpret_cast<std::uintptr_t>(this->memory));
+
+    /* void enter(JitState *state, const void *code) */
+    for (auto reg : {X86_RBX, X86_RBP, X86_R12, X86_R13, X86_R14, X86_R15})
+        assembler.push(reg);
+    /* Keeps the stack aligned to 16 bytes for the helper calls */
+    assembler.arithmetic_immediate(X86_SUB, X86_RSP, 8);
+    assembler.mov(STATE, X86_RDI);
+    assembler.load(STACK, STATE, X86Assembler::NO_INDEX, STATE_STACK);
+    assembler.load(STACK_SIZE, STATE, X86Assembler::NO_INDEX, STATE_STACK_SIZE);
+    assembler.load(B, STATE, X86Assembler::NO_INDEX, STATE_B);
+    assembler.load(T, STATE, X86Assembler::NO_INDEX, STATE_T);
+    assembler.load(COUNTER, STATE, X86Assembler::NO_INDEX, STATE_COUNTER);
+    assembler.jmp(X86_RSI);
+
+    /* Leave (p and exit are already stored) */
+    auto leave_offset = assembler.offset();
+    assembler.store(STATE, X86Assembler::NO_INDEX, STATE_B, B);
+    assembler.store(STATE, X86Assembler::NO_INDEX, STATE_T, T);
+    assembler.store(STATE, X86Assembler::NO_INDEX, STATE_COUNTER, COUNTER);
+    assembler.arithmetic_immediate(X86_ADD, X86_RSP, 8);
+    for (auto reg : {X86_R15, X86_R14, X86_R13, X86_R12, X86_RBP, X86_RBX})
+        assembler.pop(reg);
+    assembler.ret();
+
+    auto address = this->install(assembler.get_code());
+    /* Without the trampolines no function is compiled (enter_call) */
+    if (address == nullptr)
+        return;
+    this->enter = reinterpret_cast<void (*)(JitState *, const void *)>(address);
+    this->leave = reinterpret_cast<std::uintptr_t>(address + leave_offset);
+}
+
+bool JitCompiler::enter_call(std::uint32_t address) {
+    if (this->entries[address] != nullptr)
+        return true;
+    if (this->enter == nullptr || ++this->calls[address] != this->threshold)
+        return false;
+
+    auto function = std::lower_bound(this->functions.begin(), this->functions.end(), address);
+    if (function == this->functions.end() || *function != address)
+        return false;
+    auto end = function + 1 == this->functions.end() ? static_cast<std::uint32_t>(this->instructions.size()) : *(function + 1);
+    if (this->compile(address, end))
+        this->compiled_functions++;
+    return this->entries[address] != nullptr;
+}
+
+bool JitCompiler::compile(std::uint32_t start, std::uint32_t end) {
+    auto code_size = static_cast<std::int64_t>(this->instructions.size());
+    auto in_code = [&](std::int64_t address) { return address >= 0 && address < code_size; };
+
+    /* Only functions with supported instructions are compiled */
+    for (auto i = start; i < end; i++) {
+        const auto &instruction = this->instructions[i];
+        switch (instruction.opcode) {
+            case PL0_ITR:
+            case PL0_RTI:
+            case PL0_OPF:
+            case PL0_PLD:
+            case PL0_PST:
+                return false;
+            case PL0_OPR:
+                if (instruction.parameter < PL0_NEG || instruction.parameter > PL0_LEQ)
+                    return false;
+                break;
+            case PL0_JMP:
+            case PL0_JMC:
+            case PL0_CAL:
+                if (!in_code(instruction.parameter))
+                    return false;
+                break;
+            default:
+                break;
+        }
+    }
+
+    /* Code is generated directly for its final address */
+    auto address = reinterpret_cast<std::uintptr_t>(this->memory + this->memory_used);
+    auto assembler = X86Assembler(address);
+    auto labels = std::vector<X86Label>(end - start);
+    auto deopts = std::vector<X86Label>(end - start);
+    auto exits = std::vector<std::pair<X86Label, std::uint32_t>>();
+
+    /* Leaves the compiled code to continue at the address */
+    auto leave_to = [&](std::uint32_t target, JitExit reason) {
+        assembler.store_dword_immediate(STATE, STATE_P, static_cast<std::int32_t>(target));
+        assembler.store_dword_immediate(STATE, STATE_EXIT, reason);
+        assembler.jmp_absolute(this->leave);
+    };
+    /* Jumps to the target (directly if it is in the function) */
+    auto jump = [&](std::uint32_t target) {
+        if (target >= start && target < end) {
+            assembler.jmp(labels[target - start]);
+        } else {
+            exits.emplace_back(X86Label(), target);
+            assembler.jmp(exits.back().first);
+        }
+    };
+
+    for (auto i = start; i < end; i++) {
+        const auto &instruction = this->instructions[i];
+        auto &deopt = deopts[i - start];
+        auto level = instruction.level;
+        auto parameter = instruction.parameter;
+
+        /* base(level) into rcx (with the same checks as the interpreter) */
+        auto static_link = [&]() {
+            assembler.mov(X86_RCX, B);
+            for (auto j = 0; j < level; j++) {
+                assembler.load(X86_RCX, STACK, X86_RCX, 0);
+                assembler.arithmetic(X86_CMP, X86_RCX, STACK_SIZE);
+                assembler.jcc(X86_ABOVE_OR_EQUAL, deopt);
+            }
+        };
+        /* base(level) + parameter into rcx */
+        auto variable_address = [&]() {
+            static_link();
+            assembler.lea(X86_RCX, X86_RCX, X86Assembler::NO_INDEX, parameter);
+            assembler.arithmetic(X86_CMP, X86_RCX, STACK_SIZE);
+            assembler.jcc(X86_ABOVE_OR_EQUAL, deopt);
+        };
+        /* rax = t + cells, leaves if it overflows */
+        auto check_push = [&](std::int32_t cells) {
+            assembler.lea(X86_RAX, T, X86Assembler::NO_INDEX, cells);
+            assembler.arithmetic(X86_CMP, X86_RAX, STACK_SIZE);
+            assembler.jcc(X86_GREATER_OR_EQUAL, deopt);
+        };
+        auto check_pop = [&](std::int32_t cells) {
+            assembler.arithmetic_immediate(X86_CMP, T, cells - 1);
+            assembler.jcc(X86_LESS, deopt);
+        };
+        /* Leaves if the helper failed */
+        auto check_helper = [&]() {
+            assembler.test(X86_RAX, X86_RAX);
+            assembler.jcc(X86_NOT_EQUAL, deopt);
+        };
+
+        assembler.bind(labels[i - start]);
+        assembler.inc(COUNTER);
+
+        switch (instruction.opcode) {
+            case PL0_LIT:
+                check_push(1);
+                assembler.store_immediate(STACK, X86_RAX, 0, parameter);
+                assembler.mov(T, X86_RAX);
+                break;
+            case PL0_LOD:
+                check_push(1);
+                variable_address();
+                assembler.load(X86_RDX, STACK, X86_RCX, 0);
+                assembler.store(STACK, X86_RAX, 0, X86_RDX);
+                assembler.mov(T, X86_RAX);
+                break;
+            case PL0_STO:
+                check_pop(1);
+                variable_address();
+                assembler.load(X86_RDX, STACK, T, 0);
+                assembler.store(STACK, X86_RCX, 0, X86_RDX);
+                assembler.dec(T);
+                break;
+            case PL0_OPR:
+                if (parameter == PL0_NEG || parameter == PL0_ODD) {
+                    check_pop(1);
+                    assembler.load(X86_RAX, STACK, T, 0);
+                    if (parameter == PL0_NEG)
+                        assembler.neg(X86_RAX);
+                    else
+                        assembler.arithmetic_immediate(X86_AND, X86_RAX, 1);
+                    assembler.store(STACK, T, 0, X86_RAX);
+                    break;
+                }
+                check_pop(2);
+                assembler.load(X86_RAX, STACK, T, -8);
+                assembler.load(X86_RCX, STACK, T, 0);
+                switch (parameter) {
+                    case PL0_ADD:
+                        assembler.arithmetic(X86_ADD, X86_RAX, X86_RCX);
+                        break;
+                    case PL0_SUB:
+                        assembler.arithmetic(X86_SUB, X86_RAX, X86_RCX);
+                        break;
+                    case PL0_MUL:
+                        assembler.imul(X86_RAX, X86_RCX);
+                        break;
+                    case PL0_DIV:
+                    case PL0_MOD: {
+                        /* Division by zero is reported by the interpreter, division by -1 would overflow for the minimal value */
+                        auto minus_one = X86Label();
+                        auto done = X86Label();
+                        assembler.test(X86_RCX, X86_RCX);
+                        assembler.jcc(X86_EQUAL, deopt);
+                        assembler.arithmetic_immediate(X86_CMP, X86_RCX, -1);
+                        assembler.jcc(X86_EQUAL, minus_one);
+                        assembler.cqo();
+                        assembler.idiv(X86_RCX);
+                        if (parameter == PL0_MOD)
+                            assembler.mov(X86_RAX, X86_RDX);
+                        assembler.jmp(done);
+                        assembler.bind(minus_one);
+                        if (parameter == PL0_DIV)
+                            assembler.neg(X86_RAX);
+                        else
+                            assembler.mov_immediate(X86_RAX, 0);
+                        assembler.bind(done);
+                        break;
+                    }
+                    default: {
+                        static const X86Condition conditions[] = {
+                            X86_EQUAL, X86_NOT_EQUAL, X86_LESS, X86_GREATER_OR_EQUAL, X86_GREATER, X86_LESS_OR_EQUAL
+                        };
+                        assembler.arithmetic(X86_CMP, X86_RAX, X86_RCX);
+                        assembler.setcc_rax(conditions[parameter - PL0_EQ]);
+                        break;
+                    }
+                }
+                assembler.store(STACK, T, -8, X86_RAX);
+                assembler.dec(T);
+                break;
+            case PL0_CAL:
+                check_push(3);
+                static_link();
+                assembler.store(STACK, T, 8, X86_RCX);
+                assembler.store(STACK, T, 16, B);
+                assembler.store_immediate(STACK, T, 24, static_cast<std::int32_t>(i + 1));
+                assembler.lea(B, T, X86Assembler::NO_INDEX, 1);
+                if (static_cast<std::uint32_t>(parameter) == start) {
+                    /* Recursion */
+                    assembler.jmp(labels[0]);
+                } else {
+                    /* Compiled code of the callee, or leave to the interpreter */
+                    auto not_compiled = X86Label();
+                    assembler.load(X86_RAX, STATE, X86Assembler::NO_INDEX, STATE_ENTRIES);
+                    assembler.load(X86_RAX, X86_RAX, X86Assembler::NO_INDEX, parameter * 8);
+                    assembler.test(X86_RAX, X86_RAX);
+                    assembler.jcc(X86_EQUAL, not_compiled);
+                    assembler.jmp(X86_RAX);
+                    assembler.bind(not_compiled);
+                    leave_to(parameter, JIT_EXIT_CALL);
+                }
+                break;
+            case PL0_INT:
+                if (parameter > 0) {
+                    check_push(parameter);
+                } else if (parameter < 0) {
+                    assembler.lea(X86_RAX, T, X86Assembler::NO_INDEX, parameter);
+                    assembler.arithmetic_immediate(X86_CMP, X86_RAX, -1);
+                    assembler.jcc(X86_LESS, deopt);
+                }
+                if (parameter != 0)
+                    assembler.mov(T, X86_RAX);
+                break;
+            case PL0_JMP:
+                jump(parameter);
+                break;
+            case PL0_JMC: {
+                auto next = X86Label();
+                check_pop(1);
+                assembler.load(X86_RAX, STACK, T, 0);
+                assembler.dec(T);
+                assembler.test(X86_RAX, X86_RAX);
+                assembler.jcc(X86_NOT_EQUAL, next);
+                jump(parameter);
+                assembler.bind(next);
+                break;
+            }
+            case PL0_RET: {
+                auto finished = X86Label();
+                auto not_compiled = X86Label();
+                /* check_address(b), check_address(b + 2) and check_jump(return address) */
+                assembler.arithmetic(X86_CMP, B, STACK_SIZE);
+                assembler.jcc(X86_ABOVE_OR_EQUAL, deopt);
+                assembler.lea(X86_RAX, B, X86Assembler::NO_INDEX, 2);
+                assembler.arithmetic(X86_CMP, X86_RAX, STACK_SIZE);
+                assembler.jcc(X86_ABOVE_OR_EQUAL, deopt);
+                assembler.load(X86_RDX, STACK, B, 16);
+                assembler.mov_immediate(X86_RAX, code_size);
+                assembler.arithmetic(X86_CMP, X86_RDX, X86_RAX);
+                assembler.jcc(X86_ABOVE_OR_EQUAL, deopt);
+                assembler.load(X86_RCX, STACK, B, 8);
+                assembler.lea(T, B, X86Assembler::NO_INDEX, -1);
+                assembler.mov(B, X86_RCX);
+                /* Return to the address 0 means the end of the program */
+                assembler.test(X86_RDX, X86_RDX);
+                assembler.jcc(X86_EQUAL, finished);
+                assembler.load(X86_RAX, STATE, X86Assembler::NO_INDEX, STATE_ENTRIES);
+                assembler.load(X86_RAX, X86_RAX, X86_RDX, 0);
+                assembler.test(X86_RAX, X86_RAX);
+                assembler.jcc(X86_EQUAL, not_compiled);
+                assembler.jmp(X86_RAX);
+                assembler.bind(not_compiled);
+                assembler.store_dword(STATE, STATE_P, X86_RDX);
+                assembler.store_dword_immediate(STATE, STATE_EXIT, JIT_EXIT_INTERPRET);
+                assembler.jmp_absolute(this->leave);
+                assembler.bind(finished);
+                leave_to(0, JIT_EXIT_FINISHED);
+                break;
+            }
+            case PL0_REA:
+                check_push(1);
+                call_helper(assembler, reinterpret_cast<const void *>(&jit_read));
+                assembler.store(STACK, T, 8, X86_RAX);
+                assembler.inc(T);
+                break;
+            case PL0_WRI:
+                check_pop(1);
+                assembler.load(X86_RSI, STACK, T, 0);
+                call_helper(assembler, reinterpret_cast<const void *>(&jit_write));
+                assembler.dec(T);
+                break;
+            case PL0_NEW:
+                check_pop(1);
+                assembler.load(X86_RSI, STACK, T, 0);
+                assembler.lea(X86_RDX, STACK, T, 0);
+                call_helper(assembler, reinterpret_cast<const void *>(&jit_new));
+                check_helper();
+                break;
+            case PL0_DEL:
+                check_pop(1);
+                assembler.load(X86_RSI, STACK, T, 0);
+                call_helper(assembler, reinterpret_cast<const void *>(&jit_delete));
+                check_helper();
+                assembler.dec(T);
+                break;
+            case PL0_LDA:
+                check_pop(1);
+                assembler.load(X86_RSI, STACK, T, 0);
+                assembler.lea(X86_RDX, STACK, T, 0);
+                call_helper(assembler, reinterpret_cast<const void *>(&jit_load));
+                check_helper();
+                break;
+            case PL0_STA:
+                check_pop(2);
+                assembler.load(X86_RSI, STACK, T, -8);
+                assembler.load(X86_RDX, STACK, T, 0);
+                call_helper(assembler, reinterpret_cast<const void *>(&jit_store));
+                check_helper();
+                assembler.arithmetic_immediate(X86_SUB, T, 2);
+                break;
+            default:
+                return false;
+        }
+    }
+    /* Falling through the end of the function */
+    leave_to(end, JIT_EXIT_INTERPRET);
+
+    /* Leaving to the interpreter before the instruction (it was not executed, so it is not counted) */
+    for (auto i = start; i < end; i++) {
+        auto &deopt = deopts[i - start];
+        if (deopt.references.empty())
+            continue;
+        assembler.bind(deopt);
+        assembler.dec(COUNTER);
+        leave_to(i, JIT_EXIT_INTERPRET);
+    }
+    for (auto &[label, target] : exits) {
+        assembler.bind(label);
+        leave_to(target, JIT_EXIT_INTERPRET);
+    }
+
+    auto code = this->install(assembler.get_code());
+    if (code == nullptr)
+        return false;
+
+    /* Compiled code is entered at the function start and at the return addresses */
+    this->entries[start] = code + labels[0].offset;
+    for (auto i = start; i + 1 < end; i++)
+        if (this->instructions[i].opcode == PL0_CAL)
+            this->entries[i + 1] = code + labels[i + 1 - start].offset;
+    return true;
+}
+
+void JitCompiler::execute(JitState &state) {
+    state.entries = this->entries.data();
+    this->enter(&state, this->entries[state.p]);
+}
+
+#else
+
+JitCompiler::JitCompiler(const std::vector<DecodedInstruction> &instructions, std::uint32_t threshold) :
+    instructions(instructions), threshold(threshold), functions(), calls(), entries(instructions.size() + 1, nullptr),
+    memory(nullptr), memory_used(0), enter(nullptr), leave(0), compiled_functions(0) {
+    /* Empty */
+}
+
+JitCompiler::~JitCompiler() = default;
+
+bool JitCompiler::is_available() {
+    return false;
+}
+
+bool JitCompiler::enter_call(std::uint32_t) {
+    return false;
+}
+
+void JitCompiler::execute(JitState &state) {
+    state.exit = JIT_EXIT_INTERPRET;
+}
+
+#endif
+
+std::uint32_t JitCompiler::get_compiled_functions() const {
+    return this->compiled_functions;
+}
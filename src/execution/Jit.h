@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BufferedIo.h"
+#include "Cell.h"
+#include "Heap.h"
+#include "Program.h"
+
+/** Default number of calls after which the function is compiled */
+const std::uint32_t DEFAULT_JIT_THRESHOLD = 50;
+/** Size of the executable memory for the compiled code (in bytes) */
+const std::size_t JIT_CODE_SIZE = 16 << 20;
+
+/**
+ * Enum for reasons of leaving the compiled code
+ */
+enum JitExit {
+    /** Program finished (return to the address 0) */
+    JIT_EXIT_FINISHED,
+    /** Call of the function which is not compiled (p is the function address) */
+    JIT_EXIT_CALL,
+    /** Continue with the interpreter at p (the instruction at p was not executed) */
+    JIT_EXIT_INTERPRET
+};
+
+/**
+ * Struct for state shared by the virtual machine and the compiled code
+ * Layout is used by the generated code (offsets are taken by offsetof in Jit.cpp)
+ */
+typedef struct JitState {
+    /** Stack */
+    cell_t *stack;
+    /** Size of the stack (in cells) */
+    cell_t stack_size;
+    /** Base of the current activation record */
+    cell_t b;
+    /** Top of the stack */
+    cell_t t;
+    /** Number of executed instructions */
+    std::uint64_t instruction_counter;
+    /** Compiled code of the addresses (nullptr if not compiled) */
+    const void *const *entries;
+    /** Heap (NEW, DEL, LDA, STA) */
+    Heap *heap;
+    /** Input of the program (REA) */
+    InputBuffer *input;
+    /** Output of the program (WRI) */
+    OutputBuffer *output;
+    /** Program counter (where to continue after leaving the compiled code) */
+    std::uint32_t p;
+    /** Reason of leaving the compiled code (JitExit) */
+    std::uint32_t exit;
+} JitState;
+
+/**
+ * Class representing the JIT compiler of the hot PL/0 functions to the x86-64 machine code
+ * Functions are the ranges between the CAL targets; a function is compiled after DEFAULT_JIT_THRESHOLD calls
+ * if it contains only supported instructions (all but ITR, RTI, OPF, PLD and PST), otherwise it stays interpreted
+ * Compiled code checks everything the interpreter checks; if a check fails, it leaves to the interpreter
+ * before the failing instruction, so the error is reported by the interpreter
+ */
+class JitCompiler {
+private:
+    /** Compiled instructions */
+    const std::vector<DecodedInstruction> &instructions;
+    /** Number of calls after which the function is compiled */
+    std::uint32_t threshold;
+    /** Sorted start addresses of the functions (CAL targets) */
+    std::vector<std::uint32_t> functions;
+    /** Number of calls of the functions (indexed by the address) */
+    std::vector<std::uint32_t> calls;
+    /** Compiled code of the addresses (function starts and return addresses) */
+    std::vector<const void *> entries;
+    /** Executable memory */
+    std::uint8_t *memory;
+    /** Used part of the executable memory */
+    std::size_t memory_used;
+    /** Code entering the compiled code: void enter(JitState *state, const void *code) */
+    void (*enter)(JitState *, const void *);
+    /** Code leaving the compiled code (registers are stored to the state) */
+    std::uintptr_t leave;
+    /** Number of the compiled functions */
+    std::uint32_t compiled_functions;
+
+    /**
+     * Generates the enter and leave code
+     */
+    void generate_trampolines();
+    /**
+     * Compiles the function
+     * @param start Start address of the function
+     * @param end End address of the function (exclusive)
+     * @return True if the function was compiled; False if it is not supported
+     */
+    bool compile(std::uint32_t start, std::uint32_t end);
+    /**
+     * Copies the generated code into the executable memory
+     * @param code Generated code
+     * @return Address of the code (nullptr if the memory is full or cannot be made executable)
+     */
+    std::uint8_t *install(const std::vector<std::uint8_t> &code);
+
+public:
+    /**
+     * Constructor
+     * @param instructions Decoded instructions (without superinstructions)
+     * @param threshold Number of calls after which the function is compiled
+     */
+    JitCompiler(const std::vector<DecodedInstruction> &instructions, std::uint32_t threshold = DEFAULT_JIT_THRESHOLD);
+    /**
+     * Destructor
+     */
+    ~JitCompiler();
+
+    /**
+     * Checks if the JIT compiler is available on this platform and the system allows to switch the written memory to executable
+     * (probed once)
+     * @return True if available; False otherwise
+     */
+    static bool is_available();
+
+    /**
+     * Counts the call of the address and compiles the function if it became hot
+     * @param address Called address
+     * @return True if there is compiled code for the address; False otherwise
+     */
+    bool enter_call(std::uint32_t address);
+    /**
+     * Checks if there is compiled code for the address
+     * @param address Address
+     * @return True if there is compiled code for the address; False otherwise
+     */
+    [[nodiscard]] bool has_native(std::uint32_t address) const {
+        return this->entries[address] != nullptr;
+    }
+    /**
+     * Runs the compiled code at state.p until it leaves
+     * @param state State of the virtual machine (updated)
+     */
+    void execute(JitState &state);
+
+    /**
+     * Get number of the compiled functions
+     * @return Number of the compiled functions
+     */
+    [[nodiscard]] std::uint32_t get_compiled_functions() const;
+};
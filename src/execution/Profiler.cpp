@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include "Profiler.h"
+
+Profiler::Profiler(const std::vector<DecodedInstruction> &code) :
+    code(code), function_names(), executions(code.size(), 0), jumps(code.size(), 0), owners(code.size(), UINT32_MAX), nodes(), current(0) {
+    this->nodes.push_back(CallNode{0, 0, 1, 0, {}});
+}
+
+Profiler::~Profiler() = default;
+
+void Profiler::load_function_names(std::istream &input) {
+    std::string line;
+    while (std::getline(input, line)) {
+        auto line_stream = std::istringstream(line);
+        std::uint32_t entry;
+        std::string name;
+        if (line_stream >> entry >> name)
+            this->function_names[entry] = name;
+    }
+}
+
+std::string Profiler::function_name(std::uint32_t entry) const {
+    if (entry == 0)
+        return "global";
+    auto it = this->function_names.find(entry);
+    return it != this->function_names.end() ? it->second : "function_" + std::to_string(entry);
+}
+
+void Profiler::call(std::uint32_t entry) {
+    for (auto &[child_entry, child]: this->nodes[this->current].children) {
+        if (child_entry == entry) {
+            this->current = child;
+            this->nodes[child].calls++;
+            return;
+        }
+    }
+
+    auto child = static_cast<std::uint32_t>(this->nodes.size());
+    this->nodes[this->current].children.emplace_back(entry, child);
+    this->nodes.push_back(CallNode{entry, this->current, 1, 0, {}});
+    this->current = child;
+}
+
+std::vector<FunctionProfile> Profiler::get_functions() const {
+    /* Children are always created after their parent, so the totals of the subtrees are summed from the end */
+    std::vector<std::uint64_t> totals(this->nodes.size(), 0);
+    for (auto i = this->nodes.size(); i-- > 0;) {
+        totals[i] += this->nodes[i].instructions;
+        if (i > 0)
+            totals[this->nodes[i].parent] += totals[i];
+    }
+
+    std::map<std::uint32_t, FunctionProfile> functions;
+    /* Depth-first walk, the subtree of a recursive call is already counted in the inclusive instructions of the outermost call */
+    std::map<std::uint32_t, std::uint32_t> active;
+    std::vector<std::pair<std::uint32_t, bool>> pending{{0, false}};
+    while (!pending.empty()) {
+        auto [index, leaving] = pending.back();
+        pending.pop_back();
+        auto &node = this->nodes[index];
+        if (leaving) {
+            active[node.entry]--;
+            continue;
+        }
+
+        auto &function = functions[node.entry];
+        function.entry = node.entry;
+        function.calls += node.calls;
+        function.exclusive += node.instructions;
+        if (active[node.entry]++ == 0)
+            function.inclusive += totals[index];
+
+        pending.emplace_back(index, true);
+        for (auto &[child_entry, child]: node.children)
+            pending.emplace_back(child, false);
+    }
+
+    std::vector<FunctionProfile> result;
+    for (auto &[entry, function]: functions) {
+        function.name = this->function_name(entry);
+        result.push_back(function);
+    }
+    std::stable_sort(result.begin(), result.end(), [](const FunctionProfile &left, const FunctionProfile &right) {
+        return left.inclusive > right.inclusive;
+    });
+    return result;
+}
+
+std::vector<LoopProfile> Profiler::get_loops() const {
+    std::vector<LoopProfile> result;
+    for (std::uint32_t address = 0; address < this->code.size(); address++) {
+        auto &instruction = this->code[address];
+        if (this->jumps[address] == 0 || (instruction.opcode != PL0_JMP && instruction.opcode != PL0_JMC))
+            continue;
+        /* Only backward jumps close loops */
+        if (instruction.parameter < 0 || static_cast<std::uint32_t>(instruction.parameter) > address)
+            continue;
+
+        auto target = static_cast<std::uint32_t>(instruction.parameter);
+        std::uint64_t instructions = 0;
+        for (auto i = target; i <= address; i++)
+            instructions += this->executions[i];
+        result.push_back(LoopProfile{address, target, this->jumps[address], instructions, this->owners[address]});
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const LoopProfile &left, const LoopProfile &right) {
+        return left.trips > right.trips;
+    });
+    return result;
+}
+
+void Profiler::write_folded_stacks(std::ostream &output) const {
+    /* Depth-first walk, the path of the node is built from the paths of its parents */
+    std::vector<std::pair<std::uint32_t, std::string>> pending{{0, this->function_name(0)}};
+    while (!pending.empty()) {
+        auto [index, path] = std::move(pending.back());
+        pending.pop_back();
+        auto &node = this->nodes[index];
+        if (node.instructions > 0)
+            output << path << " " << node.instructions << "\n";
+        for (auto it = node.children.rbegin(); it != node.children.rend(); it++)
+            pending.emplace_back(it->second, path + ";" + this->function_name(it->first));
+    }
+    output.flush();
+}
+
+void Profiler::write_report(std::ostream &output, std::size_t hot_loops) const {
+    std::uint64_t total = 0;
+    for (auto executions: this->executions)
+        total += executions;
+    auto percent = [&](std::uint64_t instructions) {
+        return total == 0 ? 0.0 : 100.0 * static_cast<double>(instructions) / static_cast<double>(total);
+    };
+
+    output << "Profile of " << total << " executed instructions" << std::endl;
+    output << "Functions:" << std::endl;
+    output << std::setw(14) << "inclusive" << std::setw(9) << "%" << std::setw(14) << "exclusive" << std::setw(9) << "%"
+           << std::setw(12) << "calls" << "  function (entry)" << std::endl;
+    output << std::fixed << std::setprecision(2);
+    for (auto &function: this->get_functions()) {
+        output << std::setw(14) << function.inclusive << std::setw(9) << percent(function.inclusive)
+               << std::setw(14) << function.exclusive << std::setw(9) << percent(function.exclusive)
+               << std::setw(12) << function.calls << "  " << function.name << " (" << function.entry << ")" << std::endl;
+    }
+
+    auto loops = this->get_loops();
+    output << "Hot loops (backward jumps by trips):" << std::endl;
+    output << std::setw(14) << "trips" << std::setw(14) << "instructions" << std::setw(9) << "%" << "  jump -> head  function" << std::endl;
+    for (std::size_t i = 0; i < loops.size() && i < hot_loops; i++) {
+        auto &loop = loops[i];
+        output << std::setw(14) << loop.trips << std::setw(14) << loop.instructions << std::setw(9) << percent(loop.instructions)
+               << "  " << loop.address << " -> " << loop.target << "  " << this->function_name(loop.function) << std::endl;
+    }
+    output << std::defaultfloat;
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Program.h"
+
+/** Default number of the hot loops in the report */
+const std::size_t DEFAULT_HOT_LOOPS = 10;
+
+/**
+ * Struct for node of the call tree (one node per distinct path of the calls)
+ */
+typedef struct CallNode {
+    /** Entry address of the function (0 for the global code) */
+    std::uint32_t entry;
+    /** Index of the calling node (the root is its own parent) */
+    std::uint32_t parent;
+    /** Number of the calls of the function along this path */
+    std::uint64_t calls;
+    /** Instructions executed directly in the function along this path */
+    std::uint64_t instructions;
+    /** Called functions (entry address, index of the node), usually only a few, so they are searched linearly */
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> children;
+} CallNode;
+
+/**
+ * Struct for profile of a function
+ */
+typedef struct FunctionProfile {
+    /** Entry address of the function */
+    std::uint32_t entry;
+    /** Name of the function */
+    std::string name;
+    /** Number of the calls */
+    std::uint64_t calls;
+    /** Instructions executed in the function and in the functions it called (recursive calls are counted once) */
+    std::uint64_t inclusive;
+    /** Instructions executed directly in the function */
+    std::uint64_t exclusive;
+} FunctionProfile;
+
+/**
+ * Struct for backward jump (the loop it closes) of the profile
+ */
+typedef struct LoopProfile {
+    /** Address of the jump */
+    std::uint32_t address;
+    /** Target of the jump (head of the loop) */
+    std::uint32_t target;
+    /** Number of the taken jumps (trips of the loop) */
+    std::uint64_t trips;
+    /** Instructions executed inside the loop (between the target and the jump) */
+    std::uint64_t instructions;
+    /** Entry address of the function containing the loop */
+    std::uint32_t function;
+} LoopProfile;
+
+/**
+ * Class for instruction-level profile of the executed program
+ * The virtual machine reports every executed instruction, call, return and taken jump, the profiler counts executions
+ * of every instruction and keeps the call tree, so the instructions are attributed to the functions by the calls
+ * actually made (nested functions are inside the code of their enclosing function)
+ */
+class Profiler {
+private:
+    /** Profiled instructions */
+    const std::vector<DecodedInstruction> &code;
+    /** Names of the functions (entry address -> name) */
+    std::map<std::uint32_t, std::string> function_names;
+    /** Number of executions of every instruction */
+    std::vector<std::uint64_t> executions;
+    /** Number of taken jumps of every instruction */
+    std::vector<std::uint64_t> jumps;
+    /** Entry address of the function which executed the instruction (first one, if more functions share the code) */
+    std::vector<std::uint32_t> owners;
+    /** Call tree, the root (index 0) is the global code */
+    std::vector<CallNode> nodes;
+    /** Node of the executed function */
+    std::uint32_t current;
+
+public:
+    /**
+     * Constructor
+     * @param code Profiled instructions
+     */
+    explicit Profiler(const std::vector<DecodedInstruction> &code);
+    /**
+     * Destructor
+     */
+    ~Profiler();
+
+    /**
+     * Loads names of the functions (the format of functions.txt generated by the compiler, "<entry address> <name>" per line)
+     * @param input Input stream
+     */
+    void load_function_names(std::istream &input);
+    /**
+     * Returns name of the function
+     * @param entry Entry address of the function
+     * @return Name of the function (or its address if the name is unknown)
+     */
+    [[nodiscard]] std::string function_name(std::uint32_t entry) const;
+    /**
+     * Get the executed function
+     * @return Entry address of the executed function (0 for the global code)
+     */
+    [[nodiscard]] std::uint32_t current_function() const {
+        return this->nodes[this->current].entry;
+    }
+
+    /**
+     * Counts execution of the instruction
+     * @param address Address of the instruction
+     */
+    void execute(std::uint32_t address) {
+        this->executions[address]++;
+        auto &node = this->nodes[this->current];
+        node.instructions++;
+        if (this->owners[address] == UINT32_MAX)
+            this->owners[address] = node.entry;
+    }
+    /**
+     * Counts taken jump
+     * @param address Address of the jump
+     */
+    void jump(std::uint32_t address) {
+        this->jumps[address]++;
+    }
+    /**
+     * Enters the called function
+     * @param entry Entry address of the function
+     */
+    void call(std::uint32_t entry);
+    /**
+     * Returns to the calling function
+     */
+    void ret() {
+        this->current = this->nodes[this->current].parent;
+    }
+
+    /**
+     * Get profiles of the functions
+     * @return Profiles of the executed functions sorted by the inclusive instructions (descending)
+     */
+    [[nodiscard]] std::vector<FunctionProfile> get_functions() const;
+    /**
+     * Get profiles of the loops
+     * @return Profiles of the taken backward jumps sorted by the trips (descending)
+     */
+    [[nodiscard]] std::vector<LoopProfile> get_loops() const;
+
+    /**
+     * Writes the call stacks in the folded format of the flame graph tools ("main;f;g <instructions>" per line)
+     * @param output Output stream
+     */
+    void write_folded_stacks(std::ostream &output) const;
+    /**
+     * Writes report of the functions and of the hot loops
+     * @param output Output stream
+     * @param hot_loops Maximum number of the reported loops
+     */
+    void write_report(std::ostream &output, std::size_t hot_loops = DEFAULT_HOT_LOOPS) const;
+};
@@ -0,0 +1,110 @@
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include "Program.h"
+#include "Verifier.h"
+
+/**
+ * Decodes the instruction
+ * @param name Name of the instruction
+ * @param level Level
+ * @param parameter Parameter
+ * @param line_number Line number of the instruction (reported by the errors)
+ * @return Decoded instruction
+ */
+static DecodedInstruction decode_instruction(const std::string &name, int level, int parameter, int line_number) {
+    auto opcode = -1;
+    for (auto i = 0; i < PL0_NUM_OF_INSTRUCTIONS; i++) {
+        if (name == InstructionsTable[i]) {
+            opcode = i;
+            break;
+        }
+    }
+    if (opcode == -1)
+        throw std::runtime_error("unknown instruction \"" + name + "\" on line " + std::to_string(line_number));
+    if (level < 0 || level > UINT8_MAX)
+        throw std::runtime_error("level out of range on line " + std::to_string(line_number));
+
+    return DecodedInstruction{static_cast<std::uint8_t>(opcode), static_cast<std::uint8_t>(level), parameter};
+}
+
+Program::Program(std::vector<DecodedInstruction> instructions) :
+    instructions(std::move(instructions)), verification(std::make_shared<const Verification>(verify_program(this->instructions))),
+    builtin_entries() {
+}
+
+Program::~Program() = default;
+
+Program Program::load(const std::string &file_name) {
+    auto input = std::ifstream(file_name);
+    if (!input)
+        throw std::runtime_error("cannot open file \"" + file_name + "\"");
+    return Program::parse(input);
+}
+
+Program Program::parse(std::istream &input) {
+    std::vector<DecodedInstruction> instructions;
+    std::string line;
+    auto line_number = 0;
+
+    while (std::getline(input, line)) {
+        line_number++;
+        auto line_stream = std::istringstream(line);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (line_stream >> token)
+            tokens.push_back(token);
+
+        if (tokens.empty())
+            continue;
+        /* Line number in front of the instruction is optional */
+        if (tokens.size() == 4)
+            tokens.erase(tokens.begin());
+        if (tokens.size() != 3)
+            throw std::runtime_error("malformed instruction on line " + std::to_string(line_number));
+
+        int level, parameter;
+        try {
+            level = std::stoi(tokens[1]);
+            parameter = std::stoi(tokens[2]);
+        } catch (const std::exception &) {
+            throw std::runtime_error("malformed operand on line " + std::to_string(line_number));
+        }
+        instructions.push_back(decode_instruction(tokens[0], level, parameter, line_number));
+    }
+
+    return Program(std::move(instructions));
+}
+
+Program Program::from_instructions(const std::vector<Instruction> &instructions) {
+    std::vector<DecodedInstruction> decoded;
+    decoded.reserve(instructions.size());
+    for (std::size_t i = 0; i < instructions.size(); i++)
+        decoded.push_back(decode_instruction(instructions[i].instruction, instructions[i].level, instructions[i].parameter, static_cast<int>(i + 1)));
+    return Program(std::move(decoded));
+}
+
+const std::vector<DecodedInstruction> &Program::get_instructions() const {
+    return this->instructions;
+}
+
+std::uint32_t Program::size() const {
+    return this->instructions.size();
+}
+
+const Verification &Program::get_verification() const {
+    return *this->verification;
+}
+
+void Program::set_builtin_entries(std::vector<BuiltinEntry> entries) {
+    for (const auto &entry: entries) {
+        if (entry.address >= this->instructions.size() || this->instructions[entry.address].opcode != PL0_INT)
+            throw std::runtime_error("entry of the builtin function " + std::string(BuiltinFunctionNames[entry.function]) + " at "
+                                     + std::to_string(entry.address) + " is not INT");
+    }
+    this->builtin_entries = std::move(entries);
+}
+
+const std::vector<BuiltinEntry> &Program::get_builtin_entries() const {
+    return this->builtin_entries;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Intrinsics.h"
+#include "synthesis/Instructions.h"
+
+/**
+ * Struct for decoded instruction
+ * Compact form of the Instruction used by the virtual machine (instruction name is decoded only once)
+ */
+typedef struct DecodedInstruction {
+    /** Instruction (InstructionIndex) */
+    std::uint8_t opcode;
+    /** Level */
+    std::uint8_t level;
+    /** Parameter */
+    std::int32_t parameter;
+} DecodedInstruction;
+
+struct Verification;
+
+/**
+ * Class representing a loaded PL/0 program
+ * Instructions are decoded once into a compact internal array and verified once (verify_program)
+ */
+class Program {
+private:
+    /** Decoded instructions */
+    std::vector<DecodedInstruction> instructions;
+    /** Result of the verification of the instructions */
+    std::shared_ptr<const Verification> verification;
+    /** Entries of the builtin functions run natively by the virtual machine */
+    std::vector<BuiltinEntry> builtin_entries;
+
+public:
+    /**
+     * Constructor
+     * @param instructions Decoded instructions
+     */
+    explicit Program(std::vector<DecodedInstruction> instructions);
+    /**
+     * Destructor
+     */
+    ~Program();
+
+    /**
+     * Loads program from the file (the format of instructions.txt)
+     * @param file_name Input file name
+     * @return Loaded program
+     */
+    static Program load(const std::string &file_name);
+    /**
+     * Parses program from the input stream (one instruction per line, line number is optional)
+     * @param input Input stream
+     * @return Parsed program
+     */
+    static Program parse(std::istream &input);
+    /**
+     * Decodes program from the instructions generated by the compiler in the same process (no text is formatted or parsed)
+     * @param instructions Instructions (InstructionsGenerator::get_instructions)
+     * @return Decoded program
+     */
+    static Program from_instructions(const std::vector<Instruction> &instructions);
+
+    /**
+     * Get decoded instructions
+     * @return Decoded instructions
+     */
+    [[nodiscard]] const std::vector<DecodedInstruction> &get_instructions() const;
+    /**
+     * Get number of instructions
+     * @return Number of instructions
+     */
+    [[nodiscard]] std::uint32_t size() const;
+    /**
+     * Get result of the verification of the instructions
+     * @return Result of the verification
+     */
+    [[nodiscard]] const Verification &get_verification() const;
+    /**
+     * Sets the entries of the builtin functions, the virtual machine then runs them natively (run_intrinsic)
+     * Throws std::runtime_error if an entry is not the INT of an activation record
+     * @param entries Entries of the builtin functions (e.g. parse_builtin_entries of functions.txt generated by the compiler)
+     */
+    void set_builtin_entries(std::vector<BuiltinEntry> entries);
+    /**
+     * Get entries of the builtin functions
+     * @return Entries of the builtin functions (empty unless set)
+     */
+    [[nodiscard]] const std::vector<BuiltinEntry> &get_builtin_entries() const;
+};
@@ -0,0 +1,344 @@
+#include "RegisterCode.h"
+
+/**
+ * Creates operand
+ * @param kind Kind (OperandKind)
+ * @param value Constant, register or address
+ * @param level Level (only for OPERAND_LOCAL)
+ * @return Operand
+ */
+static Operand operand(OperandKind kind, std::int32_t value, std::uint8_t level = 0) {
+    return Operand{static_cast<std::uint8_t>(kind), level, value};
+}
+
+/**
+ * Class translating basic blocks of the PL/0 code into the register code
+ * Keeps the operand stack of the block symbolically: every entry is an operand whose value would be in the stack slot
+ */
+class RegisterTranslator {
+private:
+    /** Translated instructions */
+    const std::vector<DecodedInstruction> &instructions;
+    /** Register code */
+    RegisterCode code;
+    /** Operand stack entries (the topmost entries of the operand stack, the ones below are in the registers) */
+    std::vector<Operand> entries;
+    /** Depth of the operand stack relative to the top of the stack at the start of the block (or the last synchronization) */
+    std::int32_t depth;
+    /** Number of the PL/0 instructions not yet accounted for by the emitted instructions */
+    std::uint16_t count;
+    /** Address of the translated PL/0 instruction */
+    std::uint32_t address;
+    /** Index of the last emitted instruction if its destination may be redirected (-1 otherwise) */
+    std::int32_t last_result;
+
+    /**
+     * Emits register instruction
+     * @param opcode Instruction (RegisterOpcode)
+     * @param destination Destination operand
+     * @param left Left operand
+     * @param right Right operand
+     * @param operation Operation
+     * @param target Jump target or ADJUST offset
+     */
+    void emit(RegisterOpcode opcode, Operand destination = {}, Operand left = {}, Operand right = {}, std::uint8_t operation = 0, std::int32_t target = 0) {
+        this->code.instructions.push_back(RegisterInstruction{static_cast<std::uint8_t>(opcode), operation, this->count, this->address, target, destination, left, right});
+        this->count = 0;
+        this->last_result = -1;
+    }
+
+    /**
+     * Pushes operand to the operand stack
+     * @param value Operand
+     */
+    void push(Operand value) {
+        this->entries.push_back(value);
+        this->depth++;
+    }
+
+    /**
+     * Pops operand from the operand stack
+     * @return Operand (register if the entry is not known)
+     */
+    Operand pop() {
+        this->depth--;
+        if (this->entries.empty())
+            return operand(OPERAND_REGISTER, this->depth);
+        auto value = this->entries.back();
+        this->entries.pop_back();
+        return value;
+    }
+
+    /**
+     * Moves the pending constants and variables of the operand stack into their registers
+     */
+    void materialize() {
+        auto position = this->depth - static_cast<std::int32_t>(this->entries.size());
+        for (auto &entry : this->entries) {
+            if (entry.kind != OPERAND_REGISTER) {
+                this->emit(REG_MOVE, operand(OPERAND_REGISTER, position), entry);
+                entry = operand(OPERAND_REGISTER, position);
+            }
+            position++;
+        }
+    }
+
+    /**
+     * Moves the pending variables of the operand stack into their registers (before the variable may be overwritten)
+     * @return True if any instruction was emitted; False otherwise
+     */
+    bool materialize_variables() {
+        auto emitted = false;
+        auto position = this->depth - static_cast<std::int32_t>(this->entries.size());
+        for (auto &entry : this->entries) {
+            if (entry.kind == OPERAND_LOCAL) {
+                this->emit(REG_MOVE, operand(OPERAND_REGISTER, position), entry);
+                entry = operand(OPERAND_REGISTER, position);
+                emitted = true;
+            }
+            position++;
+        }
+        return emitted;
+    }
+
+    /**
+     * Synchronizes the operand stack with the stack memory (all entries are stored, top of the stack is moved)
+     * @param kept Operand still used after the synchronization (its register is rebased)
+     */
+    void synchronize(Operand *kept = nullptr) {
+        this->materialize();
+        if (this->depth != 0)
+            this->emit(REG_ADJUST, {}, {}, {}, 0, this->depth);
+        if (kept != nullptr && kept->kind == OPERAND_REGISTER)
+            kept->value -= this->depth;
+        this->entries.clear();
+        this->depth = 0;
+    }
+
+    /**
+     * Emits instruction with the result pushed to the operand stack
+     * @param opcode Instruction (RegisterOpcode)
+     * @param left Left operand
+     * @param right Right operand
+     * @param operation Operation
+     */
+    void emit_result(RegisterOpcode opcode, Operand left, Operand right = {}, std::uint8_t operation = 0) {
+        auto destination = operand(OPERAND_REGISTER, this->depth);
+        this->emit(opcode, destination, left, right, operation);
+        this->last_result = static_cast<std::int32_t>(this->code.instructions.size()) - 1;
+        this->entries.push_back(destination);
+        this->depth++;
+    }
+
+    /**
+     * Translates one PL/0 instruction
+     * @param instruction PL/0 instruction
+     */
+    void translate(const DecodedInstruction &instruction) {
+        auto level = instruction.level;
+        auto parameter = instruction.parameter;
+
+        switch (instruction.opcode) {
+            case PL0_LIT:
+                this->push(operand(OPERAND_CONSTANT, parameter));
+                break;
+            case PL0_LOD:
+                this->push(operand(OPERAND_LOCAL, parameter, level));
+                break;
+            case PL0_STO: {
+                auto value = this->pop();
+                auto destination = operand(OPERAND_LOCAL, parameter, level);
+                auto result = this->last_result;
+                /* The variable may be read by the pending operands */
+                if (this->materialize_variables())
+                    result = -1;
+                /* Result of the last instruction is written to the variable directly */
+                if (result != -1 && value.kind == OPERAND_REGISTER && value.value == this->depth
+                    && this->code.instructions[result].destination.value == value.value) {
+                    this->code.instructions[result].destination = destination;
+                    this->code.instructions[result].count += this->count;
+                    this->count = 0;
+                    this->last_result = -1;
+                } else {
+                    this->emit(REG_MOVE, destination, value);
+                }
+                break;
+            }
+            case PL0_OPR:
+                if (parameter < PL0_NEG || parameter > PL0_LEQ) {
+                    this->synchronize();
+                    this->emit(REG_INVALID, {}, {}, {}, PL0_OPR, parameter);
+                } else if (parameter == PL0_NEG || parameter == PL0_ODD) {
+                    auto value = this->pop();
+                    this->emit_result(REG_UNARY, value, {}, parameter);
+                } else {
+                    auto right = this->pop();
+                    auto left = this->pop();
+                    /* x * 1 (pointer arithmetic with the cell size) and x + 0 are the left operand itself */
+                    if (right.kind == OPERAND_CONSTANT && ((parameter == PL0_MUL && right.value == 1) || (parameter == PL0_ADD && right.value == 0)))
+                        this->push(left);
+                    else
+                        this->emit_result(REG_BINARY, left, right, parameter);
+                }
+                break;
+            case PL0_CAL:
+                this->synchronize();
+                this->emit(REG_CALL, {}, {}, {}, level, parameter);
+                break;
+            case PL0_INT:
+                /* Reserved cells are registers at their own positions, nothing is emitted */
+                for (auto i = 0; i < parameter; i++) {
+                    this->entries.push_back(operand(OPERAND_REGISTER, this->depth));
+                    this->depth++;
+                }
+                for (auto i = 0; i > parameter; i--)
+                    this->pop();
+                break;
+            case PL0_JMP:
+                this->synchronize();
+                this->emit(REG_JUMP, {}, {}, {}, 0, parameter);
+                break;
+            case PL0_JMC: {
+                auto condition = this->pop();
+                this->synchronize(&condition);
+                this->emit(REG_JUMP_IF_ZERO, {}, condition, {}, 0, parameter);
+                break;
+            }
+            case PL0_RET:
+                /* Return drops the whole activation record, the operand stack need not be synchronized */
+                this->entries.clear();
+                this->depth = 0;
+                this->emit(REG_RETURN);
+                break;
+            case PL0_REA:
+                this->emit_result(REG_READ, {});
+                break;
+            case PL0_WRI:
+                this->emit(REG_WRITE, {}, this->pop());
+                break;
+            case PL0_NEW:
+                this->emit_result(REG_NEW, this->pop());
+                break;
+            case PL0_DEL:
+                this->emit(REG_DELETE, {}, this->pop());
+                break;
+            case PL0_LDA:
+                this->emit_result(REG_LOAD_HEAP, this->pop());
+                break;
+            case PL0_STA: {
+                auto value = this->pop();
+                auto heap_address = this->pop();
+                this->emit(REG_STORE_HEAP, {}, heap_address, value);
+                break;
+            }
+            case PL0_PLD: {
+                auto stack_address = this->pop();
+                auto stack_level = this->pop();
+                /* Pointer may point anywhere in the stack */
+                this->materialize();
+                this->emit_result(REG_LOAD_INDIRECT, stack_level, stack_address);
+                break;
+            }
+            case PL0_PST: {
+                auto stack_address = this->pop();
+                auto stack_level = this->pop();
+                auto value = this->pop();
+                this->materialize();
+                this->emit(REG_STORE_INDIRECT, value, stack_level, stack_address);
+                break;
+            }
+            case PL0_ITR: {
+                auto fractional_part = this->pop();
+                auto whole_part = this->pop();
+                this->emit_result(REG_INT_TO_FLOAT, whole_part, fractional_part);
+                /* Exponent is the second result */
+                this->last_result = -1;
+                this->entries.push_back(operand(OPERAND_REGISTER, this->depth));
+                this->depth++;
+                break;
+            }
+            case PL0_RTI: {
+                auto exponent = this->pop();
+                auto mantissa = this->pop();
+                this->emit_result(REG_FLOAT_TO_INT, mantissa, exponent, parameter != 0);
+                break;
+            }
+            case PL0_OPF:
+                this->synchronize();
+                this->emit(REG_FLOAT, {}, {}, {}, static_cast<std::uint8_t>(parameter < 0 || parameter > 255 ? 0 : parameter));
+                break;
+            default:
+                this->synchronize();
+                this->emit(REG_INVALID, {}, {}, {}, instruction.opcode);
+                break;
+        }
+    }
+
+public:
+    /**
+     * Constructor
+     * @param instructions Translated instructions
+     */
+    explicit RegisterTranslator(const std::vector<DecodedInstruction> &instructions) :
+        instructions(instructions), depth(0), count(0), address(0), last_result(-1) {
+        /* Empty */
+    }
+
+    /**
+     * Translates the program
+     * @return Register code
+     */
+    RegisterCode translate() {
+        auto size = this->instructions.size();
+
+        /* Basic block starts at the address 0, at every jump or call target and after every jump, call or return */
+        auto leaders = std::vector<bool>(size + 1, false);
+        leaders[0] = true;
+        for (std::size_t i = 0; i < size; i++) {
+            const auto &instruction = this->instructions[i];
+            if (instruction.opcode == PL0_JMP || instruction.opcode == PL0_JMC || instruction.opcode == PL0_CAL) {
+                if (instruction.parameter >= 0 && static_cast<std::size_t>(instruction.parameter) < size)
+                    leaders[instruction.parameter] = true;
+                leaders[i + 1] = true;
+            } else if (instruction.opcode == PL0_RET) {
+                leaders[i + 1] = true;
+            }
+        }
+
+        this->code.entries.assign(size + 1, -1);
+        for (std::size_t i = 0; i < size; i++) {
+            if (leaders[i]) {
+                /* Block ends by falling through to the next one */
+                this->synchronize();
+                if (this->count > 0)
+                    this->emit(REG_ADJUST);
+                this->code.entries[i] = static_cast<std::int32_t>(this->code.instructions.size());
+            }
+            this->address = static_cast<std::uint32_t>(i);
+            /* Count of the long run of instructions emitting nothing must not overflow */
+            if (this->count == UINT16_MAX)
+                this->emit(REG_ADJUST);
+            this->count++;
+            this->translate(this->instructions[i]);
+        }
+        /* Falling through the end of the program */
+        this->synchronize();
+        this->address = static_cast<std::uint32_t>(size > 0 ? size - 1 : 0);
+        this->code.entries[size] = static_cast<std::int32_t>(this->code.instructions.size());
+        this->emit(REG_INVALID, {}, {}, {}, PL0_NUM_OF_INSTRUCTIONS);
+
+        /* Jump targets are translated to the indexes of the register code */
+        for (auto &instruction : this->code.instructions) {
+            if (instruction.opcode == REG_JUMP || instruction.opcode == REG_JUMP_IF_ZERO || instruction.opcode == REG_CALL) {
+                auto target = instruction.target;
+                instruction.target = target >= 0 && static_cast<std::size_t>(target) < size ? this->code.entries[target] : -1;
+            }
+        }
+
+        return std::move(this->code);
+    }
+};
+
+RegisterCode translate_to_register_code(const std::vector<DecodedInstruction> &instructions) {
+    return RegisterTranslator(instructions).translate();
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Program.h"
+
+/**
+ * Enum for kinds of the register instruction operands
+ */
+enum OperandKind {
+    /** Constant (value) */
+    OPERAND_CONSTANT,
+    /** Virtual register - operand stack slot relative to the top of the stack (value 0 is the slot above the top) */
+    OPERAND_REGISTER,
+    /** Variable - stack cell "value" in the activation record "level" levels down (as addressed by LOD and STO) */
+    OPERAND_LOCAL
+};
+
+/**
+ * Struct for operand of the register instruction
+ */
+typedef struct Operand {
+    /** Kind (OperandKind) */
+    std::uint8_t kind;
+    /** Level (only for OPERAND_LOCAL) */
+    std::uint8_t level;
+    /** Constant, register or address */
+    std::int32_t value;
+} Operand;
+
+/**
+ * Enum for instructions of the register code
+ */
+enum RegisterOpcode {
+    /** destination = left */
+    REG_MOVE,
+    /** destination = operation left (OPR NEG or ODD) */
+    REG_UNARY,
+    /** destination = left operation right (binary OPR) */
+    REG_BINARY,
+    /** Jump to the target */
+    REG_JUMP,
+    /** Jump to the target if left == 0 (JMC) */
+    REG_JUMP_IF_ZERO,
+    /** Moves the top of the stack by target cells (synchronizes the operand stack with the stack memory) */
+    REG_ADJUST,
+    /** Call of the target (CAL, operation is the level) */
+    REG_CALL,
+    /** Return (RET) */
+    REG_RETURN,
+    /** destination = read character (REA) */
+    REG_READ,
+    /** Write character left (WRI) */
+    REG_WRITE,
+    /** destination = allocated block of left cells (NEW) */
+    REG_NEW,
+    /** Free the block left (DEL) */
+    REG_DELETE,
+    /** destination = heap[left] (LDA) */
+    REG_LOAD_HEAP,
+    /** heap[left] = right (STA) */
+    REG_STORE_HEAP,
+    /** destination = stack[base(left) + right] (PLD) */
+    REG_LOAD_INDIRECT,
+    /** stack[base(left) + right] = destination (PST, destination operand is the stored value) */
+    REG_STORE_INDIRECT,
+    /** destination, destination + 1 = float from the whole part left and fractional part right (ITR) */
+    REG_INT_TO_FLOAT,
+    /** destination = part of the float left (mantissa), right (exponent) given by the operation (RTI) */
+    REG_FLOAT_TO_INT,
+    /** Float operation on the top of the stack (OPF, executed on the synchronized stack) */
+    REG_FLOAT,
+    /** Invalid instruction (operation is the original opcode, target is the operation of the invalid OPR) */
+    REG_INVALID
+};
+
+/**
+ * Struct for instruction of the register code
+ */
+typedef struct RegisterInstruction {
+    /** Instruction (RegisterOpcode) */
+    std::uint8_t opcode;
+    /** OPR/OPF operation, RTI parameter, CAL level or invalid opcode */
+    std::uint8_t operation;
+    /** Number of the PL/0 instructions this instruction accounts for */
+    std::uint16_t count;
+    /** Address of the PL/0 instruction it was translated from */
+    std::uint32_t address;
+    /** Jump target (index to the register code, -1 if invalid) or ADJUST offset */
+    std::int32_t target;
+    /** Destination operand */
+    Operand destination;
+    /** Left operand */
+    Operand left;
+    /** Right operand */
+    Operand right;
+} RegisterInstruction;
+
+/**
+ * Struct for program translated into the register code
+ */
+typedef struct RegisterCode {
+    /** Register instructions */
+    std::vector<RegisterInstruction> instructions;
+    /** Index of the register instruction for every PL/0 address starting a basic block (-1 for the other addresses) */
+    std::vector<std::int32_t> entries;
+} RegisterCode;
+
+/**
+ * Translates the program into the register code, one basic block at a time
+ * Operand stack slots of the block become virtual registers, constants and variables are used directly as operands
+ * and the push/pop traffic is removed; the stack memory is synchronized at the end of every block
+ * (and before CAL, RET and OPF), so the state between the blocks is the same as of the stack machine
+ * Variables must not alias the operand stack slots (the generated code never reads cells above the top of the stack),
+ * cells above the top of the stack may differ
+ * @param instructions Decoded instructions
+ * @return Register code
+ */
+RegisterCode translate_to_register_code(const std::vector<DecodedInstruction> &instructions);
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "ReservedMemory.h"
+#include "Cell.h"
+
+/**
+ * Get size of the page of the virtual memory
+ * @return Size of the page (in bytes)
+ */
+static std::size_t page_size() {
+    static const auto size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+/**
+ * Rounds the size up to whole pages
+ * @param bytes Size (in bytes)
+ * @return Size of the pages (in bytes)
+ */
+static std::size_t round_to_pages(std::size_t bytes) {
+    return (bytes + page_size() - 1) / page_size() * page_size();
+}
+
+template<typename T>
+ReservedMemory<T>::ReservedMemory(std::size_t capacity, std::size_t size) :
+    reservation(nullptr), reservation_size(0), cells(nullptr), count(0), capacity(capacity), accessible(0) {
+    if (capacity > (std::numeric_limits<std::size_t>::max() - 3 * page_size()) / sizeof(T))
+        throw std::runtime_error("cannot reserve memory of " + std::to_string(capacity) + " cells");
+    /* Guard page, the cells, the guard page; nothing is committed until the cells are made accessible and touched */
+    this->reservation_size = page_size() + round_to_pages(capacity * sizeof(T)) + page_size();
+    auto memory = mmap(nullptr, this->reservation_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (memory == MAP_FAILED)
+        throw std::runtime_error("cannot reserve memory of " + std::to_string(capacity) + " cells");
+    this->reservation = static_cast<char *>(memory);
+    this->cells = reinterpret_cast<T *>(this->reservation + page_size());
+    this->resize(size);
+}
+
+template<typename T>
+ReservedMemory<T>::~ReservedMemory() {
+    munmap(this->reservation, this->reservation_size);
+}
+
+template<typename T>
+void ReservedMemory<T>::resize(std::size_t size) {
+    if (size > this->capacity)
+        throw std::runtime_error("cannot grow memory beyond " + std::to_string(this->capacity) + " cells");
+    auto *start = reinterpret_cast<char *>(this->cells);
+    auto bytes = round_to_pages(size * sizeof(T));
+    if (bytes > this->accessible) {
+        if (mprotect(start + this->accessible, bytes - this->accessible, PROT_READ | PROT_WRITE) != 0)
+            throw std::runtime_error("cannot commit memory of " + std::to_string(size) + " cells");
+    } else if (bytes < this->accessible) {
+        /* Released pages are returned to the system, they are zero again when the memory grows */
+        madvise(start + bytes, this->accessible - bytes, MADV_DONTNEED);
+        mprotect(start + bytes, this->accessible - bytes, PROT_NONE);
+    }
+    this->accessible = bytes;
+    /* Cells of the last page beyond the size are zeroed, so the added cells are always zero */
+    if (size < this->count)
+        std::memset(start + size * sizeof(T), 0, std::min(this->count * sizeof(T), bytes) - size * sizeof(T));
+    this->count = size;
+}
+
+template class ReservedMemory<cell_t>;
+template class ReservedMemory<compact_cell_t>;
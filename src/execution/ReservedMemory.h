@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+
+/**
+ * Class for memory of the stack or heap of the virtual machine, reserved as a range of the virtual memory (mmap) at once
+ * The range of the maximum size is reserved without memory behind it, the cells in use are accessible and their pages
+ * are committed by the system on the first touch (a new cell is zero), so the resident memory follows the cells actually used
+ * and the growth never moves the cells; the memory released by shrinking is returned to the system
+ * A guard page in front of the first cell and the inaccessible rest of the range (up to a guard page after the maximum size)
+ * crash an access out of the range at once instead of corrupting other memory (the virtual machine checks the addresses itself)
+ * @tparam T Type of the cell
+ */
+template<typename T>
+class ReservedMemory {
+private:
+    /** Reserved range (starts by the guard page) */
+    char *reservation;
+    /** Size of the reserved range (in bytes) */
+    std::size_t reservation_size;
+    /** First cell */
+    T *cells;
+    /** Number of the cells in use */
+    std::size_t count;
+    /** Maximum number of the cells */
+    std::size_t capacity;
+    /** Accessible bytes from the first cell (whole pages) */
+    std::size_t accessible;
+
+public:
+    /**
+     * Constructor, reserves the range
+     * Throws std::runtime_error if the range cannot be reserved
+     * @param capacity Maximum number of the cells
+     * @param size Number of the cells in use (zero)
+     */
+    explicit ReservedMemory(std::size_t capacity, std::size_t size = 0);
+    ReservedMemory(const ReservedMemory &) = delete;
+    ReservedMemory &operator=(const ReservedMemory &) = delete;
+    /**
+     * Destructor, releases the range
+     */
+    ~ReservedMemory();
+
+    /**
+     * Changes the number of the cells in use, the added cells are zero
+     * Throws std::runtime_error if the size exceeds the maximum size or the pages cannot be made accessible
+     * @param size Number of the cells
+     */
+    void resize(std::size_t size);
+
+    /**
+     * Get the first cell
+     * @return Pointer to the first cell
+     */
+    [[nodiscard]] T *data() {
+        return this->cells;
+    }
+    /**
+     * Get the first cell
+     * @return Pointer to the first cell
+     */
+    [[nodiscard]] const T *data() const {
+        return this->cells;
+    }
+    /**
+     * Get number of the cells in use
+     * @return Number of the cells
+     */
+    [[nodiscard]] std::size_t size() const {
+        return this->count;
+    }
+    /**
+     * Get maximum number of the cells
+     * @return Maximum number of the cells
+     */
+    [[nodiscard]] std::size_t max_size() const {
+        return this->capacity;
+    }
+    /**
+     * Access to the cell (not checked)
+     * @param index Index of the cell
+     * @return Reference to the cell
+     */
+    T &operator[](std::size_t index) {
+        return this->cells[index];
+    }
+    /**
+     * Access to the cell (not checked)
+     * @param index Index of the cell
+     * @return Reference to the cell
+     */
+    const T &operator[](std::size_t index) const {
+        return this->cells[index];
+    }
+    /**
+     * Get iterator to the first cell
+     * @return Pointer to the first cell
+     */
+    [[nodiscard]] const T *begin() const {
+        return this->cells;
+    }
+    /**
+     * Get iterator past the last cell in use
+     * @return Pointer past the last cell
+     */
+    [[nodiscard]] const T *end() const {
+        return this->cells + this->count;
+    }
+};
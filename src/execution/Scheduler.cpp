@@ -0,0 +1,174 @@
+#include <utility>
+#include "Scheduler.h"
+
+void Scheduler::Requeue::await_suspend(std::coroutine_handle<SessionTask::promise_type> handle) const {
+    /* Another worker may resume the coroutine before this returns, nothing of its frame (the awaiter) is touched afterwards */
+    auto *scheduler = this->scheduler;
+    {
+        std::lock_guard lock(scheduler->mutex);
+        scheduler->queue.push_back(handle);
+    }
+    scheduler->queue_ready.notify_one();
+}
+
+bool Scheduler::WaitInput::await_suspend(std::coroutine_handle<SessionTask::promise_type> handle) const {
+    std::lock_guard lock(this->scheduler->mutex);
+    /* Input arrived after the slice took the pending input, the session continues at once */
+    if (!this->session->pending_input.empty() || this->session->input_closed)
+        return false;
+    this->session->handle = handle;
+    this->session->waiting_input = true;
+    return true;
+}
+
+Scheduler::Scheduler(unsigned workers, std::uint64_t slice) : slice(slice), stopping(false), next_session(0) {
+    for (unsigned i = 0; i < workers; i++)
+        this->workers.emplace_back(&Scheduler::work, this);
+}
+
+Scheduler::~Scheduler() {
+    {
+        std::lock_guard lock(this->mutex);
+        this->stopping = true;
+    }
+    this->queue_ready.notify_all();
+    for (auto &worker: this->workers)
+        worker.join();
+
+    /* Unfinished coroutines are suspended (queued or waiting for the input) */
+    for (auto &[id, session]: this->sessions)
+        session->handle.destroy();
+}
+
+SessionTask Scheduler::run_session(Session *session) {
+    auto &virtual_machine = *session->virtual_machine;
+    while (true) {
+        std::string input;
+        bool input_closed;
+        {
+            std::lock_guard lock(this->mutex);
+            input = std::move(session->pending_input);
+            session->pending_input.clear();
+            input_closed = session->input_closed;
+        }
+        if (!input.empty())
+            virtual_machine.provide_input(input);
+        if (input_closed)
+            virtual_machine.close_input();
+
+        SliceState state;
+        try {
+            state = virtual_machine.run_slice(this->slice);
+        } catch (const std::exception &error) {
+            if (!session->output.empty())
+                session->on_output(session->id, session->output);
+            this->finish(session, SessionResult{"RUNTIME_ERROR", virtual_machine.get_instruction_counter(), error.what()});
+            co_return;
+        }
+
+        if (!session->output.empty()) {
+            session->on_output(session->id, session->output);
+            session->output.clear();
+        }
+        if (state == SLICE_FINISHED) {
+            this->finish(session, SessionResult{"OK", virtual_machine.get_instruction_counter(), ""});
+            co_return;
+        }
+        if (state == SLICE_WAITING_INPUT)
+            co_await WaitInput{this, session};
+        else
+            co_await Requeue{this};
+    }
+}
+
+void Scheduler::finish(Session *session, const SessionResult &result) {
+    session->on_finish(session->id, result);
+
+    /* Session is destroyed out of the lock, its coroutine only returns afterwards */
+    std::unique_ptr<Session> finished;
+    {
+        std::lock_guard lock(this->mutex);
+        auto found = this->sessions.find(session->id);
+        finished = std::move(found->second);
+        this->sessions.erase(found);
+        if (this->sessions.empty())
+            this->sessions_finished.notify_all();
+    }
+}
+
+void Scheduler::work() {
+    while (true) {
+        std::coroutine_handle<SessionTask::promise_type> handle;
+        {
+            std::unique_lock lock(this->mutex);
+            this->queue_ready.wait(lock, [this] { return this->stopping || !this->queue.empty(); });
+            if (this->stopping)
+                return;
+            handle = this->queue.front();
+            this->queue.pop_front();
+        }
+        /* Coroutine runs one slice and queues itself again, waits for the input or finishes */
+        handle.resume();
+    }
+}
+
+std::uint64_t Scheduler::start(std::shared_ptr<const Program> program, SessionOutputCallback on_output, SessionFinishCallback on_finish,
+                               std::size_t stack_size, std::size_t heap_size) {
+    auto session = std::make_unique<Session>();
+    session->program = std::move(program);
+    session->virtual_machine = std::make_unique<VirtualMachine>(*session->program, InputBuffer(), OutputBuffer(session->output),
+                                                                stack_size, heap_size);
+    session->input_closed = false;
+    session->waiting_input = false;
+    session->on_output = std::move(on_output);
+    session->on_finish = std::move(on_finish);
+    session->handle = this->run_session(session.get()).handle;
+
+    std::uint64_t id;
+    {
+        std::lock_guard lock(this->mutex);
+        id = this->next_session++;
+        session->id = id;
+        this->queue.push_back(session->handle);
+        this->sessions[id] = std::move(session);
+    }
+    this->queue_ready.notify_one();
+    return id;
+}
+
+bool Scheduler::provide_input(std::uint64_t session, const std::string &data) {
+    {
+        std::lock_guard lock(this->mutex);
+        auto found = this->sessions.find(session);
+        if (found == this->sessions.end() || found->second->input_closed)
+            return false;
+        found->second->pending_input += data;
+        if (!found->second->waiting_input)
+            return true;
+        found->second->waiting_input = false;
+        this->queue.push_back(found->second->handle);
+    }
+    this->queue_ready.notify_one();
+    return true;
+}
+
+bool Scheduler::close_input(std::uint64_t session) {
+    {
+        std::lock_guard lock(this->mutex);
+        auto found = this->sessions.find(session);
+        if (found == this->sessions.end())
+            return false;
+        found->second->input_closed = true;
+        if (!found->second->waiting_input)
+            return true;
+        found->second->waiting_input = false;
+        this->queue.push_back(found->second->handle);
+    }
+    this->queue_ready.notify_one();
+    return true;
+}
+
+void Scheduler::wait() {
+    std::unique_lock lock(this->mutex);
+    this->sessions_finished.wait(lock, [this] { return this->sessions.empty(); });
+}
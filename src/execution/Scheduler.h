@@ -0,0 +1,220 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Program.h"
+#include "VirtualMachine.h"
+
+/** Default size of the stack of a session (in cells), thousands of sessions may run at once, but only the used pages of the stacks are resident */
+const std::size_t DEFAULT_SESSION_STACK_SIZE = DEFAULT_STACK_SIZE;
+
+/**
+ * Struct for result of a finished session
+ */
+typedef struct SessionResult {
+    /** Status (OK, RUNTIME_ERROR) */
+    std::string status;
+    /** Number of the executed instructions */
+    std::uint64_t instructions;
+    /** Error message (empty if the program finished) */
+    std::string message;
+} SessionResult;
+
+/** Callback receiving the output of the session after every slice (called by the worker threads) */
+typedef std::function<void(std::uint64_t session, const std::string &output)> SessionOutputCallback;
+/** Callback receiving the result of the finished session (called by the worker threads) */
+typedef std::function<void(std::uint64_t session, const SessionResult &result)> SessionFinishCallback;
+
+/**
+ * Class for coroutine running one session: it runs the virtual machine in slices and suspends between them
+ */
+class SessionTask {
+public:
+    /**
+     * Struct for promise of the coroutine
+     */
+    struct promise_type {
+        SessionTask get_return_object() {
+            return SessionTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        /* Coroutine starts when the scheduler queues it, the finished coroutine frees its frame */
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+        void return_void() {
+        }
+        void unhandled_exception() {
+            std::terminate();
+        }
+    };
+
+    /** Handle of the coroutine */
+    std::coroutine_handle<promise_type> handle;
+
+    /**
+     * Constructor
+     * @param handle Handle of the coroutine
+     */
+    explicit SessionTask(std::coroutine_handle<promise_type> handle) : handle(handle) {
+    }
+};
+
+/**
+ * Class for the scheduler multiplexing many running programs (sessions) on a few worker threads
+ * Every session is a coroutine which runs its virtual machine for a slice of the instructions (VirtualMachine::run_slice),
+ * then it goes to the back of the run queue; a session waiting for the input is not queued until the input arrives
+ * (provide_input, close_input from any thread), so the waiting sessions cost only their memory
+ */
+class Scheduler {
+private:
+    /**
+     * Struct for running program
+     */
+    typedef struct Session {
+        /** Program (shared by the sessions) */
+        std::shared_ptr<const Program> program;
+        /** Output of the last slice (the virtual machine writes to it) */
+        std::string output;
+        /** Virtual machine */
+        std::unique_ptr<VirtualMachine> virtual_machine;
+        /** Id */
+        std::uint64_t id;
+        /** Coroutine running the virtual machine (suspended unless it is running or queued) */
+        std::coroutine_handle<SessionTask::promise_type> handle;
+        /** Input which arrived and was not passed to the virtual machine yet */
+        std::string pending_input;
+        /** True if the input was closed; False otherwise */
+        bool input_closed;
+        /** True if the coroutine is suspended until the input arrives; False otherwise */
+        bool waiting_input;
+        /** Output callback */
+        SessionOutputCallback on_output;
+        /** Finish callback */
+        SessionFinishCallback on_finish;
+    } Session;
+
+    /** Number of the instructions of a slice */
+    std::uint64_t slice;
+    /** Worker threads */
+    std::vector<std::thread> workers;
+    /** Running sessions (id -> session) */
+    std::map<std::uint64_t, std::unique_ptr<Session>> sessions;
+    /** Coroutines ready to run */
+    std::deque<std::coroutine_handle<SessionTask::promise_type>> queue;
+    /** Lock of the sessions and of the queue */
+    std::mutex mutex;
+    /** Signals a queued coroutine (or stopping) to the workers */
+    std::condition_variable queue_ready;
+    /** Signals the finish of the last session to wait() */
+    std::condition_variable sessions_finished;
+    /** True when the workers should stop; False otherwise */
+    bool stopping;
+    /** Id of the next session */
+    std::uint64_t next_session;
+
+    /**
+     * Awaiter moving the session to the back of the run queue
+     */
+    struct Requeue {
+        /** Scheduler */
+        Scheduler *scheduler;
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<SessionTask::promise_type> handle) const;
+        void await_resume() const noexcept {
+        }
+    };
+
+    /**
+     * Awaiter suspending the session until the input arrives (it does not suspend if the input has arrived meanwhile)
+     */
+    struct WaitInput {
+        /** Scheduler */
+        Scheduler *scheduler;
+        /** Session */
+        Session *session;
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+        bool await_suspend(std::coroutine_handle<SessionTask::promise_type> handle) const;
+        void await_resume() const noexcept {
+        }
+    };
+
+    /**
+     * Coroutine running the session until its program finishes
+     * @param session Session
+     * @return Coroutine (suspended at the start)
+     */
+    SessionTask run_session(Session *session);
+    /**
+     * Removes the finished session and passes its result to the finish callback
+     * @param session Session (destroyed)
+     * @param result Result of the session
+     */
+    void finish(Session *session, const SessionResult &result);
+    /**
+     * Runs the queued coroutines until the scheduler stops
+     */
+    void work();
+
+public:
+    /**
+     * Constructor, starts the worker threads
+     * @param workers Number of the worker threads
+     * @param slice Number of the instructions of a slice
+     */
+    explicit Scheduler(unsigned workers, std::uint64_t slice = DEFAULT_SLICE);
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+    /**
+     * Destructor, stops the worker threads and drops the unfinished sessions
+     */
+    ~Scheduler();
+
+    /**
+     * Starts the session running the program
+     * @param program Program (shared by the sessions)
+     * @param on_output Callback receiving the output of the session
+     * @param on_finish Callback receiving the result of the session
+     * @param stack_size Size of the stack (in cells)
+     * @param heap_size Maximum size of the heap (in cells)
+     * @return Id of the session
+     */
+    std::uint64_t start(std::shared_ptr<const Program> program, SessionOutputCallback on_output, SessionFinishCallback on_finish,
+                        std::size_t stack_size = DEFAULT_SESSION_STACK_SIZE, std::size_t heap_size = DEFAULT_HEAP_SIZE);
+    /**
+     * Appends the input of the session (may be called from any thread)
+     * @param session Id of the session
+     * @param data Input
+     * @return True if the session is running; False otherwise
+     */
+    bool provide_input(std::uint64_t session, const std::string &data);
+    /**
+     * Ends the input of the session, its reads return the input terminator afterwards (may be called from any thread)
+     * @param session Id of the session
+     * @return True if the session is running; False otherwise
+     */
+    bool close_input(std::uint64_t session);
+    /**
+     * Waits until all sessions finish
+     */
+    void wait();
+};
@@ -0,0 +1,429 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "Server.h"
+
+/** Maximum length of the request or response line (in bytes) */
+const std::size_t MAX_LINE_SIZE = 4096;
+/** Interval of the checks of the wall-clock limits and of the stopping (in milliseconds) */
+const int WATCH_INTERVAL = 10;
+
+/**
+ * Struct for reading of the lines and of the data from the socket
+ */
+typedef struct SocketReader {
+    /** Socket */
+    int fd;
+    /** Received data not read yet */
+    std::string buffer;
+} SocketReader;
+
+/**
+ * Receives more data from the socket
+ * @param reader Reader of the socket
+ * @return True if some data was received; False if the connection was closed, failed or timed out
+ */
+static bool receive(SocketReader &reader) {
+    char block[16384];
+    auto result = ::recv(reader.fd, block, sizeof(block), 0);
+    while (result < 0 && errno == EINTR)
+        result = ::recv(reader.fd, block, sizeof(block), 0);
+    if (result <= 0)
+        return false;
+    reader.buffer.append(block, static_cast<std::size_t>(result));
+    return true;
+}
+
+/**
+ * Reads line from the socket
+ * @param reader Reader of the socket
+ * @param line Line without the line feed (output)
+ * @return True if the line was read; False if the connection was closed or the line is too long
+ */
+static bool read_line(SocketReader &reader, std::string &line) {
+    std::size_t end;
+    while ((end = reader.buffer.find('\n')) == std::string::npos) {
+        if (reader.buffer.size() > MAX_LINE_SIZE || !receive(reader))
+            return false;
+    }
+    line = reader.buffer.substr(0, end);
+    reader.buffer.erase(0, end + 1);
+    return true;
+}
+
+/**
+ * Reads data of the given size from the socket
+ * @param reader Reader of the socket
+ * @param size Size of the data (in bytes)
+ * @param data Data (output)
+ * @return True if the data was read; False if the connection was closed
+ */
+static bool read_data(SocketReader &reader, std::size_t size, std::string &data) {
+    while (reader.buffer.size() < size) {
+        if (!receive(reader))
+            return false;
+    }
+    data = reader.buffer.substr(0, size);
+    reader.buffer.erase(0, size);
+    return true;
+}
+
+/**
+ * Sends all data to the socket
+ * @param fd Socket
+ * @param data Data
+ * @return True if sent; False if the connection failed
+ */
+static bool send_all(int fd, const std::string &data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        /* Closed connection must not kill the process by SIGPIPE */
+        auto result = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0)
+            return false;
+        sent += static_cast<std::size_t>(result);
+    }
+    return true;
+}
+
+/**
+ * Parses positive number
+ * @param text Text of the number
+ * @param value Parsed value (output)
+ * @return True if the text is a positive number; False otherwise
+ */
+static bool parse_number(const std::string &text, std::uint64_t &value) {
+    if (text.empty() || !std::all_of(text.begin(), text.end(), [](char character) { return character >= '0' && character <= '9'; }))
+        return false;
+    try {
+        value = std::stoull(text);
+    } catch (const std::exception &) {
+        return false;
+    }
+    return value > 0;
+}
+
+/**
+ * Parses the request line, the requested limits lower the limits
+ * @param line Request line
+ * @param program_size Size of the program (output)
+ * @param input_size Size of the input (output)
+ * @param limits Limits of the job (input and output)
+ * @return Error message (empty if the request is valid)
+ */
+static std::string parse_request(const std::string &line, std::uint64_t &program_size, std::uint64_t &input_size, JobLimits &limits) {
+    auto line_stream = std::istringstream(line);
+    std::string command, program, input;
+    if (!(line_stream >> command >> program >> input) || command != "RUN")
+        return "expected RUN <program bytes> <input bytes>";
+    if (!parse_number(program, program_size) || program_size > MAX_REQUEST_SIZE)
+        return "invalid program size";
+    input_size = 0;
+    if (input != "0" && (!parse_number(input, input_size) || input_size > MAX_REQUEST_SIZE))
+        return "invalid input size";
+
+    std::string option;
+    while (line_stream >> option) {
+        auto separator = option.find('=');
+        std::uint64_t value;
+        if (separator == std::string::npos || !parse_number(option.substr(separator + 1), value))
+            return "invalid option \"" + option + "\"";
+        auto name = option.substr(0, separator);
+        if (name == "fuel")
+            limits.fuel = std::min(limits.fuel, value);
+        else if (name == "time")
+            limits.time_limit = std::min(limits.time_limit, value);
+        else if (name == "stack")
+            limits.stack_size = std::min<std::uint64_t>(limits.stack_size, value);
+        else if (name == "heap")
+            limits.heap_size = std::min<std::uint64_t>(limits.heap_size, value);
+        else
+            return "unknown option \"" + name + "\"";
+    }
+    return "";
+}
+
+/**
+ * Formats the response of the job
+ * @param result Result of the job
+ * @return Response line followed by the output
+ */
+static std::string format_response(const JobResult &result) {
+    auto response = std::ostringstream();
+    response << result.status << " output=" << result.output.size() << " truncated=" << (result.output_truncated ? 1 : 0)
+             << " instructions=" << result.instructions << " time_us=" << result.run_time << " heap_peak_cells=" << result.heap_peak_cells;
+    if (!result.message.empty()) {
+        auto message = result.message;
+        std::replace(message.begin(), message.end(), '\n', ' ');
+        response << " message=" << message;
+    }
+    response << "\n" << result.output;
+    return response.str();
+}
+
+ExecutionServer::ExecutionServer(std::string socket_path, unsigned workers, const JobLimits &limits) :
+    socket_path(std::move(socket_path)), workers(std::max(1u, workers)), limits(limits), listen_fd(-1), stopping(false), connections(),
+    connections_mutex(), connections_ready(), running(), running_mutex(), next_job(0), finished_jobs(0) {
+    /* Empty */
+}
+
+ExecutionServer::~ExecutionServer() {
+    if (this->listen_fd >= 0) {
+        ::close(this->listen_fd);
+        ::unlink(this->socket_path.c_str());
+    }
+}
+
+JobResult ExecutionServer::run_job(const std::string &program_text, const std::string &input, const JobLimits &limits) {
+    auto result = JobResult{"OK", "", false, 0, 0, 0, ""};
+    auto program_stream = std::istringstream(program_text);
+    std::unique_ptr<Program> program;
+    try {
+        program = std::make_unique<Program>(Program::parse(program_stream));
+    } catch (const std::runtime_error &error) {
+        result.status = "LOAD_ERROR";
+        result.message = error.what();
+        return result;
+    }
+
+    /* Output is collected up to one byte over the limit, so the cut is noticed */
+    auto output_limit = limits.output_limit == SIZE_MAX ? SIZE_MAX : limits.output_limit + 1;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        auto virtual_machine = VirtualMachine(*program, InputBuffer(input), OutputBuffer(result.output, output_limit), limits.stack_size,
+                                              limits.heap_size);
+        virtual_machine.set_instruction_limit(limits.fuel);
+        std::uint64_t job;
+        {
+            std::lock_guard lock(this->running_mutex);
+            job = this->next_job++;
+            this->running[job] = {start + std::chrono::milliseconds(limits.time_limit), &virtual_machine};
+        }
+
+        /* Status is decided by the error, the program may fail for another reason after its limit was reached */
+        try {
+            virtual_machine.run();
+        } catch (const InterruptedError &error) {
+            result.status = "TIME_LIMIT";
+            result.message = error.what();
+        } catch (const FuelExhaustedError &error) {
+            result.status = "FUEL_EXHAUSTED";
+            result.message = error.what();
+        } catch (const std::exception &error) {
+            result.status = "RUNTIME_ERROR";
+            result.message = error.what();
+        }
+
+        /* Watchdog must not see the virtual machine after its destruction */
+        {
+            std::lock_guard lock(this->running_mutex);
+            this->running.erase(job);
+        }
+        result.instructions = virtual_machine.get_instruction_counter();
+        result.heap_peak_cells = virtual_machine.get_heap_statistics().peak_live_cells;
+    } catch (const std::bad_alloc &) {
+        /* Stack of the requested size cannot be allocated */
+        result.status = "RUNTIME_ERROR";
+        result.message = "out of memory";
+    }
+    result.run_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    if (result.output.size() > limits.output_limit) {
+        result.output.resize(limits.output_limit);
+        result.output_truncated = true;
+    }
+    this->finished_jobs++;
+    return result;
+}
+
+void ExecutionServer::serve(int fd) {
+    auto reader = SocketReader{fd, ""};
+    std::string line;
+    while (!this->stopping && read_line(reader, line)) {
+        std::uint64_t program_size, input_size;
+        auto limits = this->limits;
+        auto error = parse_request(line, program_size, input_size, limits);
+        if (!error.empty()) {
+            /* Rest of the request cannot be skipped, so the connection is closed */
+            send_all(fd, "BAD_REQUEST message=" + error + "\n");
+            return;
+        }
+
+        std::string program, input;
+        if (!read_data(reader, program_size, program) || !read_data(reader, input_size, input))
+            return;
+        if (!send_all(fd, format_response(this->run_job(program, input, limits))))
+            return;
+    }
+}
+
+void ExecutionServer::watch() {
+    while (!this->stopping) {
+        {
+            std::lock_guard lock(this->running_mutex);
+            auto now = std::chrono::steady_clock::now();
+            for (auto &[job, running_job]: this->running) {
+                if (running_job.first <= now)
+                    running_job.second->interrupt();
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(WATCH_INTERVAL));
+    }
+}
+
+void ExecutionServer::run() {
+    auto address = sockaddr_un{};
+    address.sun_family = AF_UNIX;
+    if (this->socket_path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("socket path \"" + this->socket_path + "\" is too long");
+    std::memcpy(address.sun_path, this->socket_path.c_str(), this->socket_path.size() + 1);
+
+    this->listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (this->listen_fd < 0)
+        throw std::runtime_error(std::string("cannot create socket: ") + std::strerror(errno));
+    /* Socket file left by a previous run is replaced */
+    ::unlink(this->socket_path.c_str());
+    if (::bind(this->listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || ::listen(this->listen_fd, SOMAXCONN) < 0) {
+        auto error = std::string(std::strerror(errno));
+        ::close(this->listen_fd);
+        this->listen_fd = -1;
+        throw std::runtime_error("cannot listen on \"" + this->socket_path + "\": " + error);
+    }
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < this->workers; i++) {
+        threads.emplace_back([this]() {
+            for (;;) {
+                int fd;
+                {
+                    std::unique_lock lock(this->connections_mutex);
+                    this->connections_ready.wait(lock, [this]() { return this->stopping || !this->connections.empty(); });
+                    if (this->connections.empty())
+                        return;
+                    fd = this->connections.front();
+                    this->connections.pop_front();
+                }
+                this->serve(fd);
+                ::close(fd);
+            }
+        });
+    }
+    threads.emplace_back([this]() { this->watch(); });
+
+    /* Accepting is polled, so stop() called by a signal handler is noticed */
+    auto timeout = timeval{REQUEST_TIMEOUT / 1000, (REQUEST_TIMEOUT % 1000) * 1000};
+    while (!this->stopping) {
+        auto listening = pollfd{this->listen_fd, POLLIN, 0};
+        if (::poll(&listening, 1, 100) <= 0)
+            continue;
+        auto fd = ::accept(this->listen_fd, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+        /* Idle or stalled client releases its worker after the timeout */
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        {
+            std::lock_guard lock(this->connections_mutex);
+            this->connections.push_back(fd);
+        }
+        this->connections_ready.notify_one();
+    }
+
+    /* Running jobs are finished, the waiting connections are closed */
+    {
+        std::lock_guard lock(this->connections_mutex);
+        for (auto fd: this->connections)
+            ::close(fd);
+        this->connections.clear();
+    }
+    this->connections_ready.notify_all();
+    for (auto &thread: threads)
+        thread.join();
+}
+
+void ExecutionServer::stop() {
+    this->stopping = true;
+}
+
+std::uint64_t ExecutionServer::get_finished_jobs() const {
+    return this->finished_jobs;
+}
+
+JobResult submit_job(const std::string &socket_path, const std::string &program, const std::string &input, const JobLimits &limits) {
+    auto address = sockaddr_un{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("socket path \"" + socket_path + "\" is too long");
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+        auto error = std::string(std::strerror(errno));
+        if (fd >= 0)
+            ::close(fd);
+        throw std::runtime_error("cannot connect to \"" + socket_path + "\": " + error);
+    }
+
+    /* Zero limits are not requested, the server uses its own */
+    auto request = std::ostringstream();
+    request << "RUN " << program.size() << " " << input.size();
+    if (limits.fuel > 0)
+        request << " fuel=" << limits.fuel;
+    if (limits.time_limit > 0)
+        request << " time=" << limits.time_limit;
+    if (limits.stack_size > 0)
+        request << " stack=" << limits.stack_size;
+    if (limits.heap_size > 0)
+        request << " heap=" << limits.heap_size;
+    request << "\n" << program << input;
+
+    auto reader = SocketReader{fd, ""};
+    std::string line;
+    if (!send_all(fd, request.str()) || !read_line(reader, line)) {
+        ::close(fd);
+        throw std::runtime_error("connection to \"" + socket_path + "\" failed");
+    }
+
+    auto result = JobResult{"", "", false, 0, 0, 0, ""};
+    auto message = line.find(" message=");
+    if (message != std::string::npos) {
+        result.message = line.substr(message + std::strlen(" message="));
+        line.erase(message);
+    }
+    auto line_stream = std::istringstream(line);
+    line_stream >> result.status;
+    std::uint64_t output_size = 0;
+    std::string field;
+    while (line_stream >> field) {
+        auto separator = field.find('=');
+        if (separator == std::string::npos)
+            continue;
+        auto name = field.substr(0, separator);
+        auto value = std::strtoull(field.c_str() + separator + 1, nullptr, 10);
+        if (name == "output")
+            output_size = value;
+        else if (name == "truncated")
+            result.output_truncated = value != 0;
+        else if (name == "instructions")
+            result.instructions = value;
+        else if (name == "time_us")
+            result.run_time = value;
+        else if (name == "heap_peak_cells")
+            result.heap_peak_cells = value;
+    }
+    auto complete = read_data(reader, output_size, result.output);
+    ::close(fd);
+    if (!complete)
+        throw std::runtime_error("connection to \"" + socket_path + "\" failed");
+    return result;
+}
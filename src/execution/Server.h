@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include "VirtualMachine.h"
+
+/** Default maximum number of the executed instructions of a job */
+const std::uint64_t DEFAULT_JOB_FUEL = 1000000000;
+/** Default wall-clock limit of a job (in milliseconds) */
+const std::uint64_t DEFAULT_JOB_TIME_LIMIT = 10000;
+/** Default maximum size of the output of a job (in bytes) */
+const std::size_t DEFAULT_JOB_OUTPUT_LIMIT = 16 << 20;
+/** Maximum size of the program or of the input of a request (in bytes) */
+const std::size_t MAX_REQUEST_SIZE = 64 << 20;
+/** Time a connection may stay idle or wait for the rest of the request (in milliseconds) */
+const int REQUEST_TIMEOUT = 10000;
+
+/**
+ * Struct for limits of a job (the server limits are the maximum, a request may only lower them)
+ */
+typedef struct JobLimits {
+    /** Maximum number of the executed instructions */
+    std::uint64_t fuel;
+    /** Wall-clock limit (in milliseconds) */
+    std::uint64_t time_limit;
+    /** Size of the stack (in cells) */
+    std::size_t stack_size;
+    /** Maximum size of the heap (in cells) */
+    std::size_t heap_size;
+    /** Maximum size of the output (in bytes), the rest is dropped */
+    std::size_t output_limit;
+} JobLimits;
+
+/**
+ * Struct for result of a job
+ */
+typedef struct JobResult {
+    /** Status (OK, RUNTIME_ERROR, FUEL_EXHAUSTED, TIME_LIMIT, LOAD_ERROR) */
+    std::string status;
+    /** Output of the program */
+    std::string output;
+    /** True if the output was cut at the output limit; False otherwise */
+    bool output_truncated;
+    /** Number of the executed instructions */
+    std::uint64_t instructions;
+    /** Run time (in microseconds) */
+    std::uint64_t run_time;
+    /** Maximum of the live heap cells */
+    std::uint64_t heap_peak_cells;
+    /** Error message (empty if the program finished) */
+    std::string message;
+} JobResult;
+
+/**
+ * Class for the server running the compiled programs sent over a Unix socket
+ * Every connection is served by one worker of the pool, it may send more requests one after another:
+ *     RUN <program bytes> <input bytes>[ fuel=<instructions>][ time=<ms>][ stack=<cells>][ heap=<cells>]\n<program><input>
+ * The program is in the format of instructions.txt, every job runs in its own virtual machine (threaded dispatch, no JIT),
+ * the response is
+ *     <status> output=<bytes> truncated=<0|1> instructions=<count> time_us=<microseconds> heap_peak_cells=<cells>[ message=<text>]\n<output>
+ * Malformed request is answered by BAD_REQUEST message=<text> and the connection is closed
+ */
+class ExecutionServer {
+private:
+    /** Path of the Unix socket */
+    std::string socket_path;
+    /** Number of the workers */
+    unsigned workers;
+    /** Maximum limits of the jobs */
+    JobLimits limits;
+    /** Listening socket (-1 if not listening) */
+    int listen_fd;
+    /** True when the server should stop; False otherwise */
+    std::atomic<bool> stopping;
+    /** Accepted connections waiting for a worker */
+    std::deque<int> connections;
+    /** Lock of the connections */
+    std::mutex connections_mutex;
+    /** Signals a new connection (or stopping) to the workers */
+    std::condition_variable connections_ready;
+    /** Running jobs (id -> deadline and virtual machine), watched for the wall-clock limit */
+    std::map<std::uint64_t, std::pair<std::chrono::steady_clock::time_point, VirtualMachine *>> running;
+    /** Lock of the running jobs */
+    std::mutex running_mutex;
+    /** Id of the next job */
+    std::uint64_t next_job;
+    /** Number of the finished jobs */
+    std::atomic<std::uint64_t> finished_jobs;
+
+    /**
+     * Serves requests of the connection until it is closed
+     * @param fd Socket of the connection
+     */
+    void serve(int fd);
+    /**
+     * Interrupts the jobs over their wall-clock limit until the server stops
+     */
+    void watch();
+
+public:
+    /**
+     * Constructor
+     * @param socket_path Path of the Unix socket (an existing socket file is replaced)
+     * @param workers Number of the workers (jobs running in parallel)
+     * @param limits Maximum limits of the jobs
+     */
+    ExecutionServer(std::string socket_path, unsigned workers, const JobLimits &limits);
+    /**
+     * Destructor, closes the socket and removes the socket file
+     */
+    ~ExecutionServer();
+
+    /**
+     * Runs the job
+     * @param program Program text (format of instructions.txt)
+     * @param input Input of the program
+     * @param limits Limits of the job
+     * @return Result of the job
+     */
+    JobResult run_job(const std::string &program, const std::string &input, const JobLimits &limits);
+    /**
+     * Accepts and serves the connections until stop() is called
+     * Throws std::runtime_error if the socket cannot be created
+     */
+    void run();
+    /**
+     * Stops the server (safe to call from a signal handler)
+     */
+    void stop();
+    /**
+     * Get number of the finished jobs
+     * @return Number of the finished jobs
+     */
+    [[nodiscard]] std::uint64_t get_finished_jobs() const;
+};
+
+/**
+ * Sends the job to the server and waits for its result
+ * Throws std::runtime_error if the connection fails
+ * @param socket_path Path of the Unix socket of the server
+ * @param program Program text (format of instructions.txt)
+ * @param input Input of the program
+ * @param limits Requested limits of the job (zero for the limits of the server, output_limit is not requested)
+ * @return Result of the job (status BAD_REQUEST if the server rejected the request)
+ */
+JobResult submit_job(const std::string &socket_path, const std::string &program, const std::string &input, const JobLimits &limits);
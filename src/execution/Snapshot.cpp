@@ -0,0 +1,65 @@
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Snapshot.h"
+
+std::uint64_t hash_instructions(const std::vector<DecodedInstruction> &instructions) {
+    std::uint64_t hash = 0xcbf29ce484222325;
+    auto mix = [&hash](std::uint64_t value, int bytes) {
+        for (auto i = 0; i < bytes; i++) {
+            hash ^= (value >> (8 * i)) & 0xff;
+            hash *= 0x100000001b3;
+        }
+    };
+    for (const auto &instruction: instructions) {
+        mix(instruction.opcode, 1);
+        mix(instruction.level, 1);
+        mix(static_cast<std::uint32_t>(instruction.parameter), 4);
+    }
+    return hash;
+}
+
+void ImageWriter::write_bytes(const void *bytes, std::size_t size) {
+    this->data.append(static_cast<const char *>(bytes), size);
+}
+
+void ImageWriter::save(const std::string &file_name) const {
+    auto file = std::ofstream(file_name, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("cannot open file \"" + file_name + "\"");
+    file.write(this->data.data(), static_cast<std::streamsize>(this->data.size()));
+    if (!file)
+        throw std::runtime_error("cannot write file \"" + file_name + "\"");
+}
+
+ImageReader::ImageReader(const std::string &file_name) : data(nullptr), size(0), position(0) {
+    auto fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open file \"" + file_name + "\"");
+    struct stat status = {};
+    if (fstat(fd, &status) != 0 || status.st_size == 0) {
+        close(fd);
+        throw std::runtime_error("invalid snapshot image \"" + file_name + "\"");
+    }
+    /* Pages are loaded only when they are read, the mapping stays valid after the descriptor is closed */
+    auto memory = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+        throw std::runtime_error("cannot map file \"" + file_name + "\"");
+    this->data = static_cast<const char *>(memory);
+    this->size = static_cast<std::size_t>(status.st_size);
+}
+
+ImageReader::~ImageReader() {
+    munmap(const_cast<char *>(this->data), this->size);
+}
+
+const char *ImageReader::read_bytes(std::size_t size) {
+    if (size > this->size - this->position)
+        throw std::runtime_error("truncated snapshot image");
+    auto bytes = this->data + this->position;
+    this->position += size;
+    return bytes;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Program.h"
+
+/** Magic number at the start of the snapshot image */
+const std::uint64_t SNAPSHOT_MAGIC = 0x31474d4943444159; /* "YADCIMG1" */
+/** Version of the format of the snapshot image */
+const std::uint32_t SNAPSHOT_VERSION = 1;
+
+/**
+ * Computes hash of the instructions (FNV-1a), the snapshot image is restored only for the program it was taken from
+ * @param instructions Decoded instructions
+ * @return Hash of the instructions
+ */
+std::uint64_t hash_instructions(const std::vector<DecodedInstruction> &instructions);
+
+/**
+ * Class for writer of the snapshot image (the values are written in the native byte order, the image is not portable)
+ */
+class ImageWriter {
+private:
+    /** Written bytes */
+    std::string data;
+
+public:
+    /**
+     * Writes value
+     * @tparam T Type of the value (trivially copyable)
+     * @param value Value
+     */
+    template<typename T>
+    void write(const T &value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        this->write_bytes(&value, sizeof(T));
+    }
+    /**
+     * Writes bytes
+     * @param bytes Bytes
+     * @param size Number of the bytes
+     */
+    void write_bytes(const void *bytes, std::size_t size);
+    /**
+     * Writes the image to the file
+     * @param file_name Output file name
+     */
+    void save(const std::string &file_name) const;
+};
+
+/**
+ * Class for reader of the snapshot image mapped to memory (mmap), nothing is read before it is needed
+ * Throws std::runtime_error if the image is shorter than the read value
+ */
+class ImageReader {
+private:
+    /** Mapped image */
+    const char *data;
+    /** Size of the image (in bytes) */
+    std::size_t size;
+    /** Position of the next read byte */
+    std::size_t position;
+
+public:
+    /**
+     * Constructor, maps the file to memory
+     * @param file_name Image file name
+     */
+    explicit ImageReader(const std::string &file_name);
+    ImageReader(const ImageReader &) = delete;
+    ImageReader &operator=(const ImageReader &) = delete;
+    /**
+     * Destructor, unmaps the file
+     */
+    ~ImageReader();
+
+    /**
+     * Reads value
+     * @tparam T Type of the value (trivially copyable)
+     * @return Value
+     */
+    template<typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, this->read_bytes(sizeof(T)), sizeof(T));
+        return value;
+    }
+    /**
+     * Reads bytes (they stay in the mapped image)
+     * @param size Number of the bytes
+     * @return Pointer to the bytes
+     */
+    const char *read_bytes(std::size_t size);
+    /**
+     * Reads array of values
+     * @tparam T Type of the values (trivially copyable)
+     * @param values Values (output, resized to the number of the read values)
+     * @param count Number of the values
+     */
+    template<typename T>
+    void read_array(std::vector<T> &values, std::size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (count > (this->size - this->position) / sizeof(T))
+            throw std::runtime_error("truncated snapshot image");
+        values.resize(count);
+        if (count > 0)
+            std::memcpy(values.data(), this->read_bytes(count * sizeof(T)), count * sizeof(T));
+    }
+};
@@ -0,0 +1,150 @@
+#include "Superinstructions.h"
+
+/**
+ * Enum for matching of the instruction parameter in the pattern
+ */
+enum ParameterMatch {
+    /** Any parameter */
+    MATCH_ANY,
+    /** Parameter equal to the given value */
+    MATCH_VALUE,
+    /** Binary operation of the OPR instruction (all operations but NEG and ODD) */
+    MATCH_BINARY_OPERATION,
+    /** Parameter which is not negative (fractional part of the float literal, ITR cannot fail) */
+    MATCH_NON_NEGATIVE
+};
+
+/**
+ * Struct for one instruction of the superinstruction pattern
+ */
+typedef struct PatternInstruction {
+    /** Instruction (InstructionIndex) */
+    std::uint8_t opcode;
+    /** How the parameter is matched */
+    ParameterMatch match;
+    /** Parameter (only for MATCH_VALUE) */
+    std::int32_t parameter;
+} PatternInstruction;
+
+/**
+ * Struct for superinstruction and the sequence it fuses
+ */
+typedef struct Superinstruction {
+    /** Opcode of the superinstruction */
+    SuperinstructionIndex opcode;
+    /** Fused sequence */
+    std::vector<PatternInstruction> pattern;
+} Superinstruction;
+
+/**
+ * Known superinstructions, longer sequences first (they take precedence when matching)
+ * Selected by static n-gram counting of the programs in examples/ (yadc-vm-bench --ngrams=<n>)
+ */
+static const std::vector<Superinstruction> Superinstructions = {
+    {SI_LOD_LIT_ADD_LIT_STA, {{PL0_LOD, MATCH_ANY, 0}, {PL0_LIT, MATCH_ANY, 0}, {PL0_OPR, MATCH_VALUE, PL0_ADD},
+                              {PL0_LIT, MATCH_ANY, 0}, {PL0_STA, MATCH_ANY, 0}}},
+    {SI_LOD_LIT_OPR_STO, {{PL0_LOD, MATCH_ANY, 0}, {PL0_LIT, MATCH_ANY, 0}, {PL0_OPR, MATCH_BINARY_OPERATION, 0},
+                          {PL0_STO, MATCH_ANY, 0}}},
+    {SI_LOD_LIT_OPR_JMC, {{PL0_LOD, MATCH_ANY, 0}, {PL0_LIT, MATCH_ANY, 0}, {PL0_OPR, MATCH_BINARY_OPERATION, 0},
+                          {PL0_JMC, MATCH_ANY, 0}}},
+    {SI_LOD_LIT_OPR, {{PL0_LOD, MATCH_ANY, 0}, {PL0_LIT, MATCH_ANY, 0}, {PL0_OPR, MATCH_BINARY_OPERATION, 0}}},
+    {SI_LOD_LOD_OPR, {{PL0_LOD, MATCH_ANY, 0}, {PL0_LOD, MATCH_ANY, 0}, {PL0_OPR, MATCH_BINARY_OPERATION, 0}}},
+    {SI_LIT_LIT_ITR, {{PL0_LIT, MATCH_ANY, 0}, {PL0_LIT, MATCH_NON_NEGATIVE, 0}, {PL0_ITR, MATCH_ANY, 0}}},
+    {SI_LIT_ZERO_EQ, {{PL0_LIT, MATCH_VALUE, 0}, {PL0_OPR, MATCH_VALUE, PL0_EQ}}},
+    {SI_LIT_ZERO_ITR, {{PL0_LIT, MATCH_VALUE, 0}, {PL0_ITR, MATCH_ANY, 0}}},
+    {SI_LIT_STO, {{PL0_LIT, MATCH_ANY, 0}, {PL0_STO, MATCH_ANY, 0}}},
+    {SI_LOD_STO, {{PL0_LOD, MATCH_ANY, 0}, {PL0_STO, MATCH_ANY, 0}}},
+    {SI_LOD_LOD, {{PL0_LOD, MATCH_ANY, 0}, {PL0_LOD, MATCH_ANY, 0}}},
+    {SI_STO_STO, {{PL0_STO, MATCH_ANY, 0}, {PL0_STO, MATCH_ANY, 0}}}
+};
+
+/**
+ * Names of the OPR and OPF operations (indexed by Oprs)
+ */
+static const char * const OperationsTable[] = {
+    "?", "NEG", "ADD", "SUB", "MUL", "DIV", "MOD", "ODD", "EQ", "NEQ", "LT", "GEQ", "GRT", "LEQ"
+};
+
+/**
+ * Checks if the instruction matches the instruction of the pattern
+ * @param instruction Instruction
+ * @param pattern Instruction of the pattern
+ * @return True if the instruction matches; False otherwise
+ */
+static bool matches(const DecodedInstruction &instruction, const PatternInstruction &pattern) {
+    if (instruction.opcode != pattern.opcode)
+        return false;
+    switch (pattern.match) {
+        case MATCH_VALUE:
+            return instruction.parameter == pattern.parameter;
+        case MATCH_BINARY_OPERATION:
+            return instruction.parameter >= PL0_ADD && instruction.parameter <= PL0_LEQ && instruction.parameter != PL0_ODD;
+        case MATCH_NON_NEGATIVE:
+            return instruction.parameter >= 0;
+        default:
+            return true;
+    }
+}
+
+std::vector<DecodedInstruction> fuse_superinstructions(const std::vector<DecodedInstruction> &instructions) {
+    auto fused = instructions;
+
+    /* Every address is tried (not only the ones after the previous sequence), so jumps into the middle of the sequence benefit too */
+    for (std::size_t i = 0; i < instructions.size(); i++) {
+        for (const auto &superinstruction : Superinstructions) {
+            const auto &pattern = superinstruction.pattern;
+            if (i + pattern.size() > instructions.size())
+                continue;
+
+            auto match = true;
+            for (std::size_t j = 0; j < pattern.size() && match; j++)
+                match = matches(instructions[i + j], pattern[j]);
+
+            if (match) {
+                fused[i].opcode = superinstruction.opcode;
+                break;
+            }
+        }
+    }
+
+    return fused;
+}
+
+std::size_t superinstruction_length(std::uint8_t opcode) {
+    for (const auto &superinstruction : Superinstructions)
+        if (superinstruction.opcode == opcode)
+            return superinstruction.pattern.size();
+    return 1;
+}
+
+std::string opcode_name(std::uint8_t opcode) {
+    if (opcode < PL0_NUM_OF_INSTRUCTIONS)
+        return InstructionsTable[opcode];
+
+    for (const auto &superinstruction : Superinstructions) {
+        if (superinstruction.opcode != opcode)
+            continue;
+        auto name = std::string();
+        for (const auto &instruction : superinstruction.pattern)
+            name += (name.empty() ? "" : "_") + std::string(InstructionsTable[instruction.opcode]);
+        return name;
+    }
+    if (opcode == SI_BUILTIN)
+        return "BUILTIN";
+    return "?";
+}
+
+void count_ngrams(const std::vector<DecodedInstruction> &instructions, std::size_t n, std::map<std::string, std::uint64_t> &counts) {
+    for (std::size_t i = 0; i + n <= instructions.size(); i++) {
+        auto ngram = std::string();
+        for (std::size_t j = i; j < i + n; j++) {
+            const auto &instruction = instructions[j];
+            if (!ngram.empty())
+                ngram += " ";
+            ngram += InstructionsTable[instruction.opcode];
+            if ((instruction.opcode == PL0_OPR || instruction.opcode == PL0_OPF) && instruction.parameter >= PL0_NEG && instruction.parameter <= PL0_LEQ)
+                ngram += std::string(":") + OperationsTable[instruction.parameter];
+        }
+        counts[ngram]++;
+    }
+}
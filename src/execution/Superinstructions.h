@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "Program.h"
+
+/**
+ * Enum for superinstructions - fused sequences of the instructions emitted by the InstructionsGenerator
+ * Superinstruction replaces opcode of the first instruction of the sequence, operands stay in the original instructions
+ * (the following instructions are left untouched, so jumps into the middle of the sequence still work)
+ */
+enum SuperinstructionIndex {
+    /** LOD x; LIT k; OPR op; LIT c; STA with op == ADD (store of the string character, ^(x + k) = c) */
+    SI_LOD_LIT_ADD_LIT_STA = PL0_NUM_OF_INSTRUCTIONS,
+    /** LOD x; LIT k; OPR op; STO y (e.g. i = i + 1) */
+    SI_LOD_LIT_OPR_STO,
+    /** LOD x; LIT k; OPR op; JMC target (condition of the loop or if statement) */
+    SI_LOD_LIT_OPR_JMC,
+    /** LOD x; LIT k; OPR op */
+    SI_LOD_LIT_OPR,
+    /** LOD x; LOD y; OPR op */
+    SI_LOD_LOD_OPR,
+    /** LIT w; LIT f; ITR with f >= 0 (float literal, e.g. 2.5) */
+    SI_LIT_LIT_ITR,
+    /** LIT 0; OPR EQ (logical not) */
+    SI_LIT_ZERO_EQ,
+    /** LIT 0; ITR (cast of int to float) */
+    SI_LIT_ZERO_ITR,
+    /** LIT k; STO x */
+    SI_LIT_STO,
+    /** LOD x; STO y */
+    SI_LOD_STO,
+    /** LOD x; LOD y (load of the float, both of its cells) */
+    SI_LOD_LOD,
+    /** STO x; STO y (store of the float, both of its cells) */
+    SI_STO_STO,
+    /** Entry of the builtin function run natively (run_intrinsic), it replaces the INT of the entry, which keeps its operands */
+    SI_BUILTIN,
+    SI_NUM_OF_OPCODES
+};
+
+/**
+ * Fuses the known instruction sequences into superinstructions
+ * @param instructions Decoded instructions
+ * @return Instructions with the same length and addresses, first instructions of the fused sequences have superinstruction opcodes
+ */
+std::vector<DecodedInstruction> fuse_superinstructions(const std::vector<DecodedInstruction> &instructions);
+
+/**
+ * Get number of instructions fused into the superinstruction
+ * @param opcode Opcode (InstructionIndex or SuperinstructionIndex)
+ * @return Number of instructions (1 for the ordinary instructions)
+ */
+std::size_t superinstruction_length(std::uint8_t opcode);
+
+/**
+ * Get name of the opcode (superinstruction name is composed of the fused instruction names)
+ * @param opcode Opcode (InstructionIndex or SuperinstructionIndex)
+ * @return Name of the opcode
+ */
+std::string opcode_name(std::uint8_t opcode);
+
+/**
+ * Counts all instruction n-grams of the program (static counting)
+ * OPR and OPF are distinguished by their operation, e.g. "LOD LIT OPR:ADD STO"
+ * @param instructions Decoded instructions
+ * @param n Length of the n-grams
+ * @param counts Counts of the n-grams (output, counts are added to the existing ones)
+ */
+void count_ngrams(const std::vector<DecodedInstruction> &instructions, std::size_t n, std::map<std::string, std::uint64_t> &counts);
@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <utility>
+#include "Verifier.h"
+#include "DecimalFloat.h"
+
+/**
+ * Struct for stack effect of the instruction
+ */
+typedef struct StackEffect {
+    /** Number of the cells the instruction needs on the stack (of its function) */
+    std::int64_t pops;
+    /** Number of the cells left on the stack instead of them */
+    std::int64_t pushes;
+} StackEffect;
+
+/**
+ * Checks the operation of the OPR instruction
+ * @param operation Operation
+ * @return True if the operation is valid; False otherwise
+ */
+static bool is_valid_operation(std::int32_t operation) {
+    return operation >= PL0_NEG && operation <= PL0_LEQ;
+}
+
+/**
+ * Checks the operation of the OPF instruction
+ * @param operation Operation
+ * @return True if the operation is valid; False otherwise
+ */
+static bool is_valid_float_operation(std::int32_t operation) {
+    return is_valid_operation(operation) && operation != PL0_ODD;
+}
+
+/**
+ * Get stack effect of the instruction (the effect of CAL on its caller is none, RET leaves the function)
+ * @param instruction Instruction
+ * @return Stack effect
+ */
+static StackEffect stack_effect(const DecodedInstruction &instruction) {
+    switch (instruction.opcode) {
+        case PL0_LIT:
+        case PL0_LOD:
+        case PL0_REA:
+            return {0, 1};
+        case PL0_OPR:
+            if (instruction.parameter == PL0_NEG || instruction.parameter == PL0_ODD)
+                return {1, 1};
+            return {2, 1};
+        case PL0_STO:
+        case PL0_JMC:
+        case PL0_WRI:
+        case PL0_DEL:
+            return {1, 0};
+        case PL0_INT:
+            if (instruction.parameter >= 0)
+                return {0, instruction.parameter};
+            return {-static_cast<std::int64_t>(instruction.parameter), 0};
+        case PL0_NEW:
+        case PL0_LDA:
+            return {1, 1};
+        case PL0_STA:
+            return {2, 0};
+        case PL0_PLD:
+            return {2, 1};
+        case PL0_PST:
+            return {3, 0};
+        case PL0_ITR:
+            return {2, 2};
+        case PL0_RTI:
+            return {2, 1};
+        case PL0_OPF:
+            if (instruction.parameter == PL0_NEG)
+                return {2, 2};
+            if (decimal_float_is_comparison(instruction.parameter))
+                return {4, 1};
+            return {4, 2};
+        default:
+            /* CAL, JMP, RET */
+            return {0, 0};
+    }
+}
+
+/**
+ * Checks opcodes, operations and jump targets of the instructions and collects the entries of the functions
+ * @param instructions Decoded instructions
+ * @param entries Entries of the functions (output, the address 0 first)
+ * @return Reason of the failure (empty if the instructions are valid)
+ */
+static std::string check_instructions(const std::vector<DecodedInstruction> &instructions, std::vector<std::uint32_t> &entries) {
+    const auto size = static_cast<std::int64_t>(instructions.size());
+    entries.push_back(0);
+    for (std::uint32_t i = 0; i < instructions.size(); i++) {
+        const auto &instruction = instructions[i];
+        if (instruction.opcode >= PL0_NUM_OF_INSTRUCTIONS)
+            return "invalid instruction " + std::to_string(instruction.opcode) + " at " + std::to_string(i);
+        if (instruction.opcode == PL0_OPR && !is_valid_operation(instruction.parameter))
+            return "invalid operation " + std::to_string(instruction.parameter) + " at " + std::to_string(i);
+        if (instruction.opcode == PL0_OPF && !is_valid_float_operation(instruction.parameter))
+            return "invalid float operation " + std::to_string(instruction.parameter) + " at " + std::to_string(i);
+        if (instruction.opcode == PL0_JMP || instruction.opcode == PL0_JMC || instruction.opcode == PL0_CAL) {
+            if (instruction.parameter < 0 || instruction.parameter >= size)
+                return "jump target " + std::to_string(instruction.parameter) + " out of range at " + std::to_string(i);
+        }
+        if (instruction.opcode == PL0_CAL)
+            entries.push_back(static_cast<std::uint32_t>(instruction.parameter));
+    }
+    std::sort(entries.begin() + 1, entries.end());
+    entries.erase(std::unique(entries.begin() + 1, entries.end()), entries.end());
+    return "";
+}
+
+/**
+ * Get maximum growth of the stack from the check at the instruction until the next checks
+ * (the next INT allocating the cells, CAL checks the called function, RET checks the return site)
+ * @param instructions Decoded instructions
+ * @param start Address of the check
+ * @param growths Growths of the stack before the instructions (all INT64_MIN, restored on return)
+ * @param growth Maximum growth (output)
+ * @return Reason of the failure (empty if the growth is bounded)
+ */
+static std::string measure_growth(const std::vector<DecodedInstruction> &instructions, std::uint32_t start, std::vector<std::int64_t> &growths,
+                                  std::int64_t &growth) {
+    std::vector<std::uint32_t> pending = {start};
+    std::vector<std::uint32_t> visited = {start};
+    std::string error;
+    growths[start] = 0;
+    growth = 0;
+    while (!pending.empty() && error.empty()) {
+        auto address = pending.back();
+        pending.pop_back();
+        const auto &instruction = instructions[address];
+        auto effect = stack_effect(instruction);
+        auto next_growth = growths[address] - effect.pops + effect.pushes;
+        growth = std::max(growth, next_growth);
+        if (next_growth > MAX_VERIFIED_GROWTH) {
+            error = "unbounded stack growth at instruction " + std::to_string(address);
+            break;
+        }
+
+        auto visit = [&](std::uint32_t target) {
+            /* INT allocating the cells checks the stack itself */
+            const auto &target_instruction = instructions[target];
+            if (target_instruction.opcode == PL0_INT && target_instruction.parameter > 0)
+                return;
+            if (next_growth > growths[target]) {
+                if (growths[target] == INT64_MIN)
+                    visited.push_back(target);
+                growths[target] = next_growth;
+                pending.push_back(target);
+            }
+        };
+        if (instruction.opcode == PL0_JMP || instruction.opcode == PL0_JMC)
+            visit(static_cast<std::uint32_t>(instruction.parameter));
+        if (instruction.opcode != PL0_JMP && instruction.opcode != PL0_RET && instruction.opcode != PL0_CAL)
+            visit(address + 1);
+    }
+
+    for (auto address: visited)
+        growths[address] = INT64_MIN;
+    return error;
+}
+
+Verification verify_program(const std::vector<DecodedInstruction> &instructions) {
+    auto result = Verification{false, "", {}};
+    if (instructions.empty()) {
+        result.error = "empty program";
+        return result;
+    }
+
+    std::vector<std::uint32_t> entries;
+    result.error = check_instructions(instructions, entries);
+    if (!result.error.empty())
+        return result;
+
+    /* Minimum depths are propagated along the control flow from the entries of the functions (depth 0),
+     * CAL continues at the return site with its depth (RET restores the top of the stack before CAL) */
+    const auto size = static_cast<std::uint32_t>(instructions.size());
+    std::vector<std::int64_t> depths(size, INT64_MAX);
+    std::vector<bool> return_sites(size, false);
+    std::vector<std::uint32_t> pending;
+    for (auto entry: entries) {
+        depths[entry] = 0;
+        pending.push_back(entry);
+    }
+    while (!pending.empty()) {
+        auto address = pending.back();
+        pending.pop_back();
+        const auto &instruction = instructions[address];
+        auto effect = stack_effect(instruction);
+        if (depths[address] < effect.pops)
+            return {false, "stack underflow at instruction " + std::to_string(address), {}};
+        auto next_depth = depths[address] - effect.pops + effect.pushes;
+
+        auto visit = [&](std::uint32_t target) {
+            if (next_depth < depths[target]) {
+                depths[target] = next_depth;
+                pending.push_back(target);
+            }
+        };
+        if (instruction.opcode == PL0_JMP || instruction.opcode == PL0_JMC)
+            visit(static_cast<std::uint32_t>(instruction.parameter));
+        if (instruction.opcode == PL0_JMP || instruction.opcode == PL0_RET)
+            continue;
+        if (address + 1 == size)
+            return {false, "program runs past the last instruction", {}};
+        if (instruction.opcode == PL0_CAL)
+            return_sites[address + 1] = true;
+        visit(address + 1);
+    }
+
+    /* Growth is measured from every check: entry of a function (CAL), return site (RET) and INT allocating the cells */
+    std::vector<std::int64_t> growths(size, INT64_MIN);
+    result.bounds.resize(size, StackBound{-1, 0, false});
+    for (std::uint32_t i = 0; i < size; i++) {
+        if (depths[i] == INT64_MAX)
+            continue;
+        result.bounds[i].depth = static_cast<std::int32_t>(std::min<std::int64_t>(depths[i], INT32_MAX));
+        result.bounds[i].return_site = return_sites[i];
+        auto entry = std::binary_search(entries.begin() + 1, entries.end(), i) || i == 0;
+        auto allocation = instructions[i].opcode == PL0_INT && instructions[i].parameter > 0;
+        if (!entry && !allocation && !return_sites[i])
+            continue;
+
+        std::int64_t growth;
+        auto error = measure_growth(instructions, i, growths, growth);
+        if (!error.empty())
+            return {false, error, {}};
+        result.bounds[i].headroom = static_cast<std::int32_t>(entry ? std::max<std::int64_t>(growth, 3) : growth);
+    }
+
+    result.verified = true;
+    return result;
+}
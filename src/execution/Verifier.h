@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Program.h"
+
+/** Maximum growth of the stack between two checks accepted by the verifier (in cells) */
+const std::int64_t MAX_VERIFIED_GROWTH = 1 << 20;
+
+/**
+ * Struct for stack bound of the verified instruction
+ * Depth is counted from the top of the stack at the entry of the function (the top before CAL)
+ */
+typedef struct StackBound {
+    /** Minimum depth of the stack before the instruction (-1 if the instruction is unreachable) */
+    std::int32_t depth;
+    /** Maximum growth of the stack from the instruction until the next check (entry of a function, return site, INT),
+     * at least the 3 cells written by CAL at the entry of a function */
+    std::int32_t headroom;
+    /** True if the instruction follows CAL (RET may return to it); False otherwise */
+    bool return_site;
+} StackBound;
+
+/**
+ * Struct for result of the verification of the program
+ */
+typedef struct Verification {
+    /** True if the program passed the verification; False otherwise */
+    bool verified;
+    /** Reason of the failed verification (empty if verified) */
+    std::string error;
+    /** Stack bounds of the instructions (empty if not verified) */
+    std::vector<StackBound> bounds;
+} Verification;
+
+/**
+ * Verifies the program once at load time, a verified program
+ * - has valid opcodes and OPR/OPF operations,
+ * - jumps (JMP, JMC) and calls (CAL) only to the existing instructions and never runs past the last instruction,
+ * - never takes more cells from the stack than its function pushed (the entries are the address 0 and the targets of CAL),
+ * - grows the stack only by a bounded number of cells between the checks (INT allocating the cells is a check, so the builtin
+ *   functions may keep their buffers on the stack)
+ * so the interpreter checks the stack only at CAL, RET and INT and needs no checks of the jump targets and of the program counter
+ * @param instructions Decoded instructions
+ * @return Result of the verification
+ */
+Verification verify_program(const std::vector<DecodedInstruction> &instructions);
@@ -0,0 +1,1408 @@
+#include <limits>
+#include <type_traits>
+#include "VirtualMachine.h"
+#include "DecimalFloat.h"
+#include "Intrinsics.h"
+#include "Snapshot.h"
+
+/**
+ * Checks that the addresses of the memory fit in the cell (before the memory is allocated)
+ * @tparam Cell Type of the cell
+ * @param size Size of the stack or heap (in cells)
+ * @return Size
+ */
+template<typename Cell>
+static std::size_t check_cells(std::size_t size) {
+    if (size > static_cast<std::size_t>(std::numeric_limits<Cell>::max()))
+        throw std::runtime_error("size " + std::to_string(size) + " exceeds the range of the " + std::to_string(8 * sizeof(Cell)) + "-bit cell");
+    return size;
+}
+
+template<typename Cell>
+BasicVirtualMachine<Cell>::BasicVirtualMachine(const Program &program, InputBuffer input, OutputBuffer output, std::size_t stack_size,
+                                               std::size_t heap_size, bool superinstructions) :
+    program(program), stack(check_cells<Cell>(stack_size), stack_size), heap(check_cells<Cell>(heap_size)), input(std::move(input)), output(std::move(output)), p(0), b(0), t(-1),
+    instruction_counter(0), dispatch_counter(0), threaded_code_checked(true), unchecked(false), display_enabled(true), instruction_limit(UINT64_MAX), fuel_limit(UINT64_MAX), slice_limit(UINT64_MAX),
+    slice_state(SLICE_FINISHED), interrupted(false) {
+    this->input.tie(&this->output);
+    /* Superinstructions are fused once, at load time */
+    if (superinstructions)
+        this->code = fuse_superinstructions(program.get_instructions());
+    else
+        this->code = program.get_instructions();
+    /* Builtin functions run natively at their entries, the INT of the entry keeps its operands for the PL/0 code */
+    for (const auto &entry: program.get_builtin_entries()) {
+        this->code[entry.address].opcode = SI_BUILTIN;
+        this->code[entry.address].level = entry.function;
+    }
+    /* Verified program needs the checks only at CAL, RET and INT, the first is the stack of the global code */
+    const auto &verification = program.get_verification();
+    this->unchecked = verification.verified && verification.bounds[0].headroom - 1 < static_cast<cell_t>(stack_size);
+}
+
+template<typename Cell>
+BasicVirtualMachine<Cell>::~BasicVirtualMachine() = default;
+
+template<typename Cell>
+bool BasicVirtualMachine<Cell>::enable_jit(std::uint32_t threshold) {
+    /* Compiled code works on the 64-bit cells */
+    if (!std::is_same_v<Cell, cell_t> || !JitCompiler::is_available())
+        return false;
+    /* Compiled code works on the original instructions, the superinstructions are only interpreted */
+    this->jit = std::make_unique<JitCompiler>(this->program.get_instructions(), threshold);
+    /* Compiled code does not keep the stack bounds of the verified program */
+    this->unchecked = false;
+    return true;
+}
+
+template<typename Cell>
+void BasicVirtualMachine<Cell>::enable_checks() {
+    this->unchecked = false;
+}
+
+template<typename Cell>
+void BasicVirtualMachine<Cell>::disable_display() {
+    this->display_enabled = false;
+}
+
+template<typename Cell>
+bool BasicVirtualMachine<Cell>::is_unchecked() const {
+    return this->unchecked;
+}
+
+template<typename Cell>
+std::uint64_t BasicVirtualMachine<Cell>::get_instruction_counter() const {
+    return this->instruction_counter;
+}
+
+template<typename Cell>
+std::uint64_t BasicVirtualMachine<Cell>::get_dispatch_counter() const {
+    return this->dispatch_counter;
+}
+
+template<typename Cell>
+std::uint32_t BasicVirtualMachine<Cell>::get_compiled_functions() const {
+    return this->jit ? this->jit->get_compiled_functions() : 0;
+}
+
+template<typename Cell>
+Profiler &BasicVirtualMachine<Cell>::enable_profiler() {
+    if (this->profiler)
+        return *this->profiler;
+    /* Profile is reported for the original instructions */
+    this->code = this->program.get_instructions();
+    this->threaded_code.clear();
+    this->jit.reset();
+    this->unchecked = false;
+    this->profiler = std::make_unique<Profiler>(this->program.get_instructions());
+    return *this->profiler;
+}
+
+template<typename Cell>
+HeapProfiler &BasicVirtualMachine<Cell>::enable_heap_profiler() {
+    if constexpr (std::is_same_v<Cell, cell_t>) {
+        this->enable_profiler();
+        if (!this->heap_profiler)
+            this->heap_profiler = std::make_unique<HeapProfiler>(this->heap);
+        return *this->heap_profiler;
+    } else {
+        throw std::runtime_error("allocation profiler needs the 64-bit cells");
+    }
+}
+
+template<typename Cell>
+void BasicVirtualMachine<Cell>::enable_collection() {
+    /* Whole stack is scanned, every dispatch keeps the operand stack (and the virtual registers) in the stack memory */
+    this->heap.enable_collection(&this->stack);
+}
+
+template<typename Cell>
+void BasicVirtualMachine<Cell>::set_instruction_limit(std::uint64_t limit) {
+    this->fuel_limit = limit;
+    this->update_instruction_limit();
+}
+
+template<typename Cell>
+void BasicVirtualMachine<Cell>::interrupt() {
+    /* Flag is set first, so the interpreter which sees the zero limit reports the interruption */
+    this->interrupted = true;
+    this->instruction_limit = 0;
+}
+
+template<typename Cell>
+void BasicVirtualMachine<Cell>::update_instruction_limit() {
+    this->instruction_limit = std::min(this->fuel_limit, this->slice_limit);
+    /* Interruption during the update is not lost */
+    if (this->interrupted)
+        this->instruction_limit = 0;
+}
+
+template<typename Cell>
+bool BasicVirtualMachine<Cell>::limit_reached(std::uint64_t instructions) const {
+    if (this->interrupted)
+        throw InterruptedError("program interrupted");
+    if (instructions > this->fuel_limit)
+        throw FuelExhaustedError("instruction limit exceeded");
+    return true;
+}
+
+template<typename Cell>
+void BasicVirtualMachine<Cell>::provide_input(const std::string &data) {
+    this->input.append(data);
+}
+
+template<typename Cell>
+void BasicVirtualMachine<Cell>::close_input() {
+    this->input.close();
+}
+
+template<typename Cell>
+const HeapStatistics &BasicVirtualMachine<Cell>::get_heap_statistics() const {
+    return this->heap.get_statistics();
+}
+
+template<typename Cell>
+bool BasicVirtualMachine<Cell>::is_interrupted() const {
+    return this->interrupted;
+}
+
+/**
+ * Wrapping arithmetic of the OPR instruction (overflow must not be undefined behaviour)
+ * @tparam Cell Type of the cell
+ * @param left Left operand
+ * @param right Right operand
+ * @return Result of the operation
+ */
+template<typename Cell>
+static inline Cell wrapping_add(Cell left, Cell right) {
+    using Unsigned = std::make_unsigned_t<Cell>;
+    return static_cast<Cell>(static_cast<Unsigned>(static_cast<Unsigned>(left) + static_cast<Unsigned>(right)));
+}
+
+template<typename Cell>
+static inline Cell wrapping_sub(Cell left, Cell right) {
+    using Unsigned = std::make_unsigned_t<Cell>;
+    return static_cast<Cell>(static_cast<Unsigned>(static_cast<Unsigned>(left) - static_cast<Unsigned>(right)));
+}
+
+template<typename Cell>
+static inline Cell wrapping_mul(Cell left, Cell right) {
+    using Unsigned = std::make_unsigned_t<Cell>;
+    return static_cast<Cell>(static_cast<Unsigned>(static_cast<Unsigned>(left) * static_cast<Unsigned>(right)));
+}
+
+/**
+ * Binary operation of the OPR instruction (used by the superinstructions, the operation is their operand)
+ * @tparam Cell Type of the cell
+ * @param operation OPR operation (neither PL0_NEG nor PL0_ODD)
+ * @param left Left operand
+ * @param right Right operand
+ * @return Result of the operation
+ */
+template<typename Cell>
+static inline Cell binary_operation(std::int32_t operation, Cell left, Cell right) {
+    switch (operation) {
+        case PL0_ADD:
+            return wrapping_add<Cell>(left, right);
+        case PL0_SUB:
+            return wrapping_sub<Cell>(left, right);
+        case PL0_MUL:
+            return wrapping_mul<Cell>(left, right);
+        case PL0_DIV:
+            if (right == 0)
+                throw std::runtime_error("division by zero");
+            return right == -1 ? wrapping_sub<Cell>(0, left) : left / right;
+        case PL0_MOD:
+            if (right == 0)
+                throw std::runtime_error("division by zero");
+            return right == -1 ? 0 : left % right;
+        case PL0_EQ:
+            return left == right;
+        case PL0_NEQ:
+            return left != right;
+        case PL0_LT:
+            return left < right;
+        case PL0_GEQ:
+            return left >= right;
+        case PL0_GRT:
+            return left > right;
+        case PL0_LEQ:
+            return left <= right;
+        default:
+            throw std::runtime_error("invalid operation " + std::to_string(operation));
+    }
+}
+
+#if YADC_VM_COMPUTED_GOTO
+/* Handler label, the threaded code jumps directly to it (it is unused by the switch dispatch) */
+#define HANDLER(name) name: __attribute__((unused));
+/* Jump to the next instruction */
+#define NEXT()                                                  \
+    do {                                                        \
+        if constexpr (threaded) {                               \
+            instruction = &threaded_code[p++];                  \
+            counter++;                                          \
+            goto *instruction->handler;                         \
+        } else {                                                \
+            goto dispatch;                                      \
+        }                                                       \
+    } while (0)
+#else
+#define HANDLER(name)
+#define NEXT() goto dispatch
+#endif
+
+/**
+ * Throws error of the stack access out of range (kept out of the interpreter loop)
+ * @tparam Cell Type of the cell
+ * @param address Stack address
+ */
+template<typename Cell>
+[[noreturn]] [[gnu::noinline]] static void throw_address_out_of_range(Cell address) {
+    throw std::runtime_error("stack address " + std::to_string(address) + " out of range");
+}
+
+/**
+ * Throws error of the executed program at the address of the failed instruction (the errors of the limits keep their type)
+ * @param error Error of the instruction
+ * @param address Address of the failed instruction
+ */
+[[noreturn]] static void throw_at_instruction(const std::runtime_error &error, std::uint32_t address) {
+    auto message = std::string(error.what()) + ", at instruction " + std::to_string(address);
+    if (dynamic_cast<const FuelExhaustedError *>(&error) != nullptr)
+        throw FuelExhaustedError(message);
+    if (dynamic_cast<const InterruptedError *>(&error) != nullptr)
+        throw InterruptedError(message);
+    throw RuntimeError(message);
+}
+
+/* Limit of the executed instructions, checked at the jumps, calls and returns (the end of the slice leaves the loop),
+ * the error of the limit is reported at the branch "offset" instructions after the executed one (the jump target is already in p) */
+#define CHECK_LIMIT(offset)                                                     \
+    do {                                                                        \
+        if (counter + fused > instruction_limit.load(std::memory_order_relaxed)) \
+            [[unlikely]] {                                                      \
+            auto target = p;                                                    \
+            p = executed_address() + (offset) + 1;                              \
+            if (this->limit_reached(counter + fused)) {                         \
+                p = target;                                                     \
+                goto native;                                                    \
+            }                                                                   \
+        }                                                                       \
+    } while (0)
+
+/* End of the superinstruction fusing "length" instructions */
+#define FUSED(length)                                           \
+    do {                                                        \
+        p += (length) - 1;                                      \
+        fused += (length) - 1;                                  \
+        NEXT();                                                 \
+    } while (0)
+
+/* Binary operation of the OPR instruction */
+#define BINARY_OPERATION(expression)                            \
+    do {                                                        \
+        check_pop(2);                                           \
+        t--;                                                    \
+        stack[t] = (expression);                                \
+        NEXT();                                                 \
+    } while (0)
+
+/* Arithmetic operation of the OPF instruction (the operation is a constant, so the inlined arithmetic is specialized for it) */
+#define FLOAT_ARITHMETIC(operation)                                                                 \
+    do {                                                                                            \
+        check_pop(4);                                                                               \
+        auto result = decimal_float_arithmetic((operation), BasicDecimalFloat<Cell>{stack[t - 3], stack[t - 2]}, \
+                                               BasicDecimalFloat<Cell>{stack[t - 1], stack[t]});               \
+        t -= 2;                                                                                     \
+        stack[t - 1] = result.mantissa;                                                             \
+        stack[t] = result.exponent;                                                                 \
+        NEXT();                                                                                     \
+    } while (0)
+
+/* Comparison of the OPF instruction */
+#define FLOAT_COMPARISON(operation)                                                                 \
+    do {                                                                                            \
+        check_pop(4);                                                                               \
+        auto result = decimal_float_compare((operation), BasicDecimalFloat<Cell>{stack[t - 3], stack[t - 2]},  \
+                                            BasicDecimalFloat<Cell>{stack[t - 1], stack[t]});                  \
+        t -= 3;                                                                                     \
+        stack[t] = result;                                                                          \
+        NEXT();                                                                                     \
+    } while (0)
+
+template<typename Cell>
+std::size_t BasicVirtualMachine<Cell>::build_display(Cell base) {
+    const auto stack_size = static_cast<Cell>(this->stack.size());
+    std::size_t depth = 0;
+    for (auto frame = base; frame != 0; frame = this->stack[frame]) {
+        if (frame < 0 || frame >= stack_size || static_cast<Cell>(++depth) >= stack_size)
+            throw std::runtime_error("corrupted static link");
+    }
+    if (this->display.size() <= depth + 1)
+        this->display.resize(2 * (depth + 1));
+    if (this->display_links.empty())
+        this->display_links.resize(DISPLAY_LINKS_CAPACITY);
+    for (auto level = depth; level > 0; level--) {
+        this->display[level] = base;
+        base = this->stack[base];
+    }
+    this->display[0] = 0;
+    return depth;
+}
+
+template<typename Cell>
+template<bool threaded, bool profiled, bool checked>
+bool BasicVirtualMachine<Cell>::execute() {
+    using instruction_t = std::conditional_t<threaded, ThreadedInstruction, DecodedInstruction>;
+
+    const auto *code = this->code.data();
+    const auto code_size = static_cast<std::uint32_t>(this->code.size());
+    auto *stack = this->stack.data();
+    const auto stack_size = static_cast<Cell>(this->stack.size());
+    auto *jit = this->jit.get();
+    auto *profiler = this->profiler.get();
+    auto *heap_profiler = this->heap_profiler.get();
+    const auto &instruction_limit = this->instruction_limit;
+    /* Stack bounds of the verified program (used only by the unchecked loop) */
+    [[maybe_unused]] const auto *bounds = this->program.get_verification().bounds.data();
+    auto done = false;
+
+#if YADC_VM_COMPUTED_GOTO
+    if constexpr (threaded) {
+        /* Pre-decode every instruction into the address of its handler and its operands */
+        /* Threaded code of the other loop jumps to its handlers */
+        if (this->threaded_code_checked != checked)
+            this->threaded_code.clear();
+        if (this->threaded_code.empty()) {
+            this->threaded_code_checked = checked;
+            /* Ordered by the InstructionIndex and SuperinstructionIndex enums */
+            static const void *const handlers[SI_NUM_OF_OPCODES] = {
+                &&handler_lit,
+                &&handler_invalid_operation,
+                &&handler_lod,
+                &&handler_sto,
+                &&handler_cal,
+                &&handler_int,
+                &&handler_jmp,
+                &&handler_jmc,
+                &&handler_ret,
+                &&handler_rea,
+                &&handler_wri,
+                &&handler_new,
+                &&handler_del,
+                &&handler_lda,
+                &&handler_sta,
+                &&handler_pld,
+                &&handler_pst,
+                &&handler_itr,
+                &&handler_rti,
+                &&handler_opf,
+                &&handler_lod_lit_add_lit_sta,
+                &&handler_lod_lit_opr_sto,
+                &&handler_lod_lit_opr_jmc,
+                &&handler_lod_lit_opr,
+                &&handler_lod_lod_opr,
+                &&handler_lit_lit_itr,
+                &&handler_lit_zero_eq,
+                &&handler_lit_zero_itr,
+                &&handler_lit_sto,
+                &&handler_lod_sto,
+                &&handler_lod_lod,
+                &&handler_sto_sto,
+                &&handler_builtin
+            };
+            /* OPR is split into one handler per operation, so no second dispatch is needed */
+            /* Ordered by the Oprs enum */
+            static const void *const operation_handlers[PL0_LEQ + 1] = {
+                &&handler_invalid_operation,
+                &&handler_opr_neg,
+                &&handler_opr_add,
+                &&handler_opr_sub,
+                &&handler_opr_mul,
+                &&handler_opr_div,
+                &&handler_opr_mod,
+                &&handler_opr_odd,
+                &&handler_opr_eq,
+                &&handler_opr_neq,
+                &&handler_opr_lt,
+                &&handler_opr_geq,
+                &&handler_opr_grt,
+                &&handler_opr_leq
+            };
+            /* OPF is split the same way, the operations without a handler (ODD) go through the generic one */
+            static const void *const float_operation_handlers[PL0_LEQ + 1] = {
+                &&handler_opf,
+                &&handler_opf_neg,
+                &&handler_opf_add,
+                &&handler_opf_sub,
+                &&handler_opf_mul,
+                &&handler_opf_div,
+                &&handler_opf_mod,
+                &&handler_opf,
+                &&handler_opf_eq,
+                &&handler_opf_neq,
+                &&handler_opf_lt,
+                &&handler_opf_geq,
+                &&handler_opf_grt,
+                &&handler_opf_leq
+            };
+
+            this->threaded_code.reserve(code_size + 1);
+            for (std::uint32_t i = 0; i < code_size; i++) {
+                auto handler = handlers[code[i].opcode];
+                if (code[i].opcode == PL0_OPR && code[i].parameter >= PL0_NEG && code[i].parameter <= PL0_LEQ)
+                    handler = operation_handlers[code[i].parameter];
+                if (code[i].opcode == PL0_OPF && code[i].parameter >= PL0_NEG && code[i].parameter <= PL0_LEQ)
+                    handler = float_operation_handlers[code[i].parameter];
+                this->threaded_code.push_back(ThreadedInstruction{handler, code[i].opcode, code[i].level, code[i].parameter});
+            }
+            /* Falling through the end of the program is caught by the sentinel */
+            this->threaded_code.push_back(ThreadedInstruction{&&handler_end_of_program, 0, 0, 0});
+        }
+    }
+    const auto *threaded_code = this->threaded_code.data();
+#endif
+
+    /* Registers are kept in locals, so the compiler can keep them in machine registers */
+    auto p = this->p;
+    auto b = this->b;
+    auto t = this->t;
+    auto counter = this->dispatch_counter;
+    auto fused = this->instruction_counter - this->dispatch_counter;
+    const instruction_t *instruction = nullptr;
+
+    /* Display holds bases of the activation records of the static chain indexed by their static depth (0 = global code),
+     * it is kept by CAL and RET, so a variable of an enclosing function is found without walking the static links */
+    Cell *display = nullptr;
+    std::pair<Cell, std::size_t> *display_links = nullptr;
+    std::size_t depth = 0, links = 0;
+    /* Without the display the depth stays 0, so every nonlocal access walks the static links */
+    const auto display_enabled = this->display_enabled;
+    /* Display is built from the static chain whenever the loop is entered (or the returns went past the entry) */
+    auto reset_display = [&]() {
+        if (!display_enabled)
+            return;
+        depth = this->build_display(b);
+        display = this->display.data();
+        display_links = this->display_links.data();
+        links = 0;
+    };
+    /* Display entry overwritten by the call is restored by the return (the display is rebuilt if the returns went past the entry of the loop) */
+    auto restore_display = [&]() {
+        if (!display_enabled)
+            return;
+        if (links > 0) {
+            links--;
+            display[depth] = display_links[links].first;
+            depth = display_links[links].second;
+        } else if (p != 0) {
+            reset_display();
+        }
+    };
+    /* Walk of the static chain, also used for the levels beyond the global code (the static link of the global code is 0) */
+    auto walk = [&](Cell result, Cell level) {
+        while (level-- > 0) {
+            result = stack[result];
+            if (result < 0 || result >= stack_size)
+                throw std::runtime_error("corrupted static link");
+        }
+        return result;
+    };
+    /* Base of the activation record "level" levels down the static chain */
+    auto base = [&](Cell level) {
+        if (level == 0)
+            return b;
+        if (level > 0 && static_cast<std::size_t>(level) <= depth)
+            return display[depth - level];
+        return walk(b, level);
+    };
+    /* Verified program keeps the stack top in the bounds checked at CAL, RET and INT */
+    auto check_push = [&](Cell cells) {
+        if constexpr (checked) {
+            if (t + cells >= stack_size)
+                throw std::runtime_error("stack overflow");
+        }
+    };
+    auto check_pop = [&](Cell cells) {
+        if constexpr (checked) {
+            if (t - cells < -1)
+                throw std::runtime_error("stack underflow");
+        }
+    };
+    auto check_address = [&](Cell address) {
+        if (address < 0 || address >= stack_size)
+            throw std::runtime_error("stack address " + std::to_string(address) + " out of range");
+        return address;
+    };
+    /* Targets of JMP, JMC and CAL of the verified program are in range */
+    auto check_jump = [&](Cell target) {
+        if constexpr (checked) {
+            if (target < 0 || static_cast<std::uint64_t>(target) >= code_size)
+                throw std::runtime_error("jump target " + std::to_string(target) + " out of range");
+        }
+        return static_cast<std::uint32_t>(target);
+    };
+    /* Address of the executed instruction (p may already hold the jump target) */
+    auto executed_address = [&]() {
+#if YADC_VM_COMPUTED_GOTO
+        if constexpr (threaded)
+            return static_cast<std::uint32_t>(instruction - threaded_code);
+        else
+#endif
+            return static_cast<std::uint32_t>(instruction - code);
+    };
+
+    try {
+        reset_display();
+        NEXT();
+
+#if YADC_VM_COMPUTED_GOTO
+        dispatch: __attribute__((unused));
+#else
+        dispatch:
+#endif
+        if constexpr (!threaded) {
+            /* Verified program never runs past the last instruction */
+            if (checked && p >= code_size)
+                throw std::runtime_error("program counter out of range");
+            instruction = &code[p++];
+            counter++;
+            if constexpr (profiled)
+                profiler->execute(p - 1);
+        }
+
+        switch (instruction->opcode) {
+            case PL0_LIT:
+                HANDLER(handler_lit)
+                check_push(1);
+                stack[++t] = instruction->parameter;
+                NEXT();
+            case PL0_OPR:
+                switch (instruction->parameter) {
+                    case PL0_NEG:
+                        HANDLER(handler_opr_neg)
+                        check_pop(1);
+                        stack[t] = wrapping_sub<Cell>(0, stack[t]);
+                        NEXT();
+                    case PL0_ODD:
+                        HANDLER(handler_opr_odd)
+                        check_pop(1);
+                        stack[t] = stack[t] & 1;
+                        NEXT();
+                    case PL0_ADD:
+                        HANDLER(handler_opr_add)
+                        BINARY_OPERATION(wrapping_add<Cell>(stack[t], stack[t + 1]));
+                    case PL0_SUB:
+                        HANDLER(handler_opr_sub)
+                        BINARY_OPERATION(wrapping_sub<Cell>(stack[t], stack[t + 1]));
+                    case PL0_MUL:
+                        HANDLER(handler_opr_mul)
+                        BINARY_OPERATION(wrapping_mul<Cell>(stack[t], stack[t + 1]));
+                    case PL0_DIV:
+                        HANDLER(handler_opr_div)
+                        check_pop(2);
+                        if (stack[t] == 0)
+                            throw std::runtime_error("division by zero");
+                        /* Division by -1 would overflow for the minimal value */
+                        BINARY_OPERATION(stack[t + 1] == -1 ? wrapping_sub<Cell>(0, stack[t]) : stack[t] / stack[t + 1]);
+                    case PL0_MOD:
+                        HANDLER(handler_opr_mod)
+                        check_pop(2);
+                        if (stack[t] == 0)
+                            throw std::runtime_error("division by zero");
+                        BINARY_OPERATION(stack[t + 1] == -1 ? 0 : stack[t] % stack[t + 1]);
+                    case PL0_EQ:
+                        HANDLER(handler_opr_eq)
+                        BINARY_OPERATION(stack[t] == stack[t + 1]);
+                    case PL0_NEQ:
+                        HANDLER(handler_opr_neq)
+                        BINARY_OPERATION(stack[t] != stack[t + 1]);
+                    case PL0_LT:
+                        HANDLER(handler_opr_lt)
+                        BINARY_OPERATION(stack[t] < stack[t + 1]);
+                    case PL0_GEQ:
+                        HANDLER(handler_opr_geq)
+                        BINARY_OPERATION(stack[t] >= stack[t + 1]);
+                    case PL0_GRT:
+                        HANDLER(handler_opr_grt)
+                        BINARY_OPERATION(stack[t] > stack[t + 1]);
+                    case PL0_LEQ:
+                        HANDLER(handler_opr_leq)
+                        BINARY_OPERATION(stack[t] <= stack[t + 1]);
+                    default:
+                        HANDLER(handler_invalid_operation)
+                        throw std::runtime_error("invalid operation " + std::to_string(instruction->parameter));
+                }
+            case PL0_LOD:
+                HANDLER(handler_lod)
+                check_push(1);
+                stack[t + 1] = stack[check_address(base(instruction->level) + instruction->parameter)];
+                t++;
+                NEXT();
+            case PL0_STO:
+                HANDLER(handler_sto)
+                check_pop(1);
+                stack[check_address(base(instruction->level) + instruction->parameter)] = stack[t--];
+                NEXT();
+            case PL0_CAL:
+                HANDLER(handler_cal)
+                /* Called function of the verified program needs its headroom */
+                if (!checked && t + bounds[instruction->parameter].headroom >= stack_size) [[unlikely]]
+                    goto checks_failed;
+                check_push(3);
+                stack[t + 1] = base(instruction->level);
+                stack[t + 2] = b;
+                stack[t + 3] = p;
+                b = t + 1;
+                p = check_jump(instruction->parameter);
+                CHECK_LIMIT(0);
+                /* Called function is nested in the function of its static link */
+                if (display_enabled && instruction->level <= depth) {
+                    auto callee_depth = depth - instruction->level + 1;
+                    if (callee_depth == this->display.size() || links == this->display_links.size()) {
+                        this->display.resize(2 * this->display.size());
+                        this->display_links.resize(2 * this->display_links.size());
+                        display = this->display.data();
+                        display_links = this->display_links.data();
+                    }
+                    display_links[links++] = {display[callee_depth], depth};
+                    display[callee_depth] = b;
+                    depth = callee_depth;
+                } else {
+                    reset_display();
+                }
+                if constexpr (profiled)
+                    profiler->call(p);
+                /* Hot function continues in the compiled code */
+                if (jit != nullptr && jit->enter_call(p))
+                    goto native;
+                NEXT();
+            case SI_BUILTIN:
+                HANDLER(handler_builtin)
+                /* Builtin function runs natively and returns at once, otherwise its PL/0 code continues by the INT of the entry */
+                if (run_intrinsic(static_cast<BuiltinFunction>(instruction->level), stack, stack_size, b, this->heap, this->input, this->output)) {
+                    t = b - 1;
+                    p = static_cast<std::uint32_t>(stack[b + 2]);
+                    b = stack[b + 1];
+                    restore_display();
+                    if (jit != nullptr && jit->has_native(p))
+                        goto native;
+                    NEXT();
+                }
+                [[fallthrough]];
+            case PL0_INT:
+                HANDLER(handler_int)
+                if (!checked && instruction->parameter > 0 && t + bounds[p - 1].headroom >= stack_size) [[unlikely]]
+                    goto checks_failed;
+                if (instruction->parameter > 0)
+                    check_push(instruction->parameter);
+                else
+                    check_pop(-instruction->parameter);
+                t += instruction->parameter;
+                NEXT();
+            case PL0_JMP:
+                HANDLER(handler_jmp)
+                if constexpr (profiled)
+                    profiler->jump(p - 1);
+                p = check_jump(instruction->parameter);
+                CHECK_LIMIT(0);
+                NEXT();
+            case PL0_JMC:
+                HANDLER(handler_jmc)
+                check_pop(1);
+                if (stack[t--] == 0) {
+                    if constexpr (profiled)
+                        profiler->jump(p - 1);
+                    p = check_jump(instruction->parameter);
+                    CHECK_LIMIT(0);
+                }
+                NEXT();
+            case PL0_RET:
+                HANDLER(handler_ret)
+                if constexpr (checked) {
+                    t = b - 1;
+                    check_address(b);
+                    check_address(b + 2);
+                    p = check_jump(stack[t + 3]);
+                } else {
+                    /* Return address may be overwritten through a pointer, so the return site and its bounds are checked */
+                    check_address(b);
+                    auto return_address = stack[check_address(b + 2)];
+                    if (return_address != 0
+                        && (return_address < 0 || static_cast<std::uint64_t>(return_address) >= code_size || !bounds[return_address].return_site
+                            || b - 1 - bounds[return_address].depth < -1 || b - 1 + bounds[return_address].headroom >= stack_size))
+                        [[unlikely]]
+                        goto checks_failed;
+                    t = b - 1;
+                    p = static_cast<std::uint32_t>(return_address);
+                }
+                b = stack[t + 2];
+                restore_display();
+                if constexpr (profiled)
+                    profiler->ret();
+                /* Return to the address 0 means the end of the program */
+                if (p == 0)
+                    goto finished;
+                CHECK_LIMIT(0);
+                if (jit != nullptr && jit->has_native(p))
+                    goto native;
+                NEXT();
+            case PL0_REA:
+                HANDLER(handler_rea)
+                {
+                    check_push(1);
+                    auto character = this->input.get();
+                    /* Slice ends before the REA, which is executed again when the input arrives */
+                    if (character == INPUT_PENDING) [[unlikely]] {
+                        p--;
+                        counter--;
+                        this->slice_state = SLICE_WAITING_INPUT;
+                        goto native;
+                    }
+                    /* End of input behaves as the input terminator (ASCII 10) */
+                    stack[++t] = character == END_OF_INPUT ? '\n' : character;
+                }
+                NEXT();
+            case PL0_WRI:
+                HANDLER(handler_wri)
+                check_pop(1);
+                this->output.put(static_cast<char>(stack[t--]));
+                NEXT();
+            case PL0_NEW:
+                HANDLER(handler_new)
+                check_pop(1);
+                if constexpr (profiled) {
+                    if (heap_profiler != nullptr) {
+                        auto size = stack[t];
+                        stack[t] = this->heap.allocate(size);
+                        heap_profiler->allocate(p - 1, profiler->current_function(), stack[t], size, counter);
+                        NEXT();
+                    }
+                }
+                stack[t] = this->heap.allocate(stack[t]);
+                NEXT();
+            case PL0_DEL:
+                HANDLER(handler_del)
+                check_pop(1);
+                if constexpr (profiled) {
+                    if (heap_profiler != nullptr)
+                        heap_profiler->free(stack[t], counter);
+                }
+                this->heap.free(stack[t--]);
+                NEXT();
+            case PL0_LDA:
+                HANDLER(handler_lda)
+                check_pop(1);
+                stack[t] = this->heap.load(stack[t]);
+                NEXT();
+            case PL0_STA:
+                HANDLER(handler_sta)
+                check_pop(2);
+                this->heap.store(stack[t - 1], stack[t]);
+                t -= 2;
+                NEXT();
+            case PL0_PLD:
+                HANDLER(handler_pld)
+                {
+                    check_pop(2);
+                    auto address = base(stack[t - 1]) + stack[t];
+                    t--;
+                    stack[t] = stack[check_address(address)];
+                }
+                NEXT();
+            case PL0_PST:
+                HANDLER(handler_pst)
+                {
+                    check_pop(3);
+                    auto address = base(stack[t - 1]) + stack[t];
+                    stack[check_address(address)] = stack[t - 2];
+                    t -= 3;
+                }
+                NEXT();
+            case PL0_ITR:
+                HANDLER(handler_itr)
+                {
+                    check_pop(2);
+                    auto value = decimal_float_from_parts<Cell>(stack[t - 1], stack[t]);
+                    stack[t - 1] = value.mantissa;
+                    stack[t] = value.exponent;
+                }
+                NEXT();
+            case PL0_RTI:
+                HANDLER(handler_rti)
+                check_pop(2);
+                t--;
+                stack[t] = decimal_float_to_part(BasicDecimalFloat<Cell>{stack[t], stack[t + 1]}, instruction->parameter != 0);
+                NEXT();
+            case PL0_OPF:
+                HANDLER(handler_opf)
+                switch (instruction->parameter) {
+                    case PL0_NEG:
+                        HANDLER(handler_opf_neg)
+                        check_pop(2);
+                        stack[t - 1] = wrapping_sub<Cell>(0, stack[t - 1]);
+                        NEXT();
+                    case PL0_ADD:
+                        HANDLER(handler_opf_add)
+                        FLOAT_ARITHMETIC(PL0_ADD);
+                    case PL0_SUB:
+                        HANDLER(handler_opf_sub)
+                        FLOAT_ARITHMETIC(PL0_SUB);
+                    case PL0_MUL:
+                        HANDLER(handler_opf_mul)
+                        FLOAT_ARITHMETIC(PL0_MUL);
+                    case PL0_DIV:
+                        HANDLER(handler_opf_div)
+                        FLOAT_ARITHMETIC(PL0_DIV);
+                    case PL0_MOD:
+                        HANDLER(handler_opf_mod)
+                        FLOAT_ARITHMETIC(PL0_MOD);
+                    case PL0_EQ:
+                        HANDLER(handler_opf_eq)
+                        FLOAT_COMPARISON(PL0_EQ);
+                    case PL0_NEQ:
+                        HANDLER(handler_opf_neq)
+                        FLOAT_COMPARISON(PL0_NEQ);
+                    case PL0_LT:
+                        HANDLER(handler_opf_lt)
+                        FLOAT_COMPARISON(PL0_LT);
+                    case PL0_GEQ:
+                        HANDLER(handler_opf_geq)
+                        FLOAT_COMPARISON(PL0_GEQ);
+                    case PL0_GRT:
+                        HANDLER(handler_opf_grt)
+                        FLOAT_COMPARISON(PL0_GRT);
+                    case PL0_LEQ:
+                        HANDLER(handler_opf_leq)
+                        FLOAT_COMPARISON(PL0_LEQ);
+                    default:
+                        check_pop(4);
+                        throw std::runtime_error("invalid float operation " + std::to_string(instruction->parameter));
+                }
+
+            /* Superinstructions read operands of the fused instructions (they follow in the code)
+             * and leave the stack memory above the top exactly as the fused sequence would */
+            case SI_LOD_LIT_ADD_LIT_STA:
+                HANDLER(handler_lod_lit_add_lit_sta)
+                check_push(2);
+                stack[t + 1] = wrapping_add<Cell>(stack[check_address(base(instruction->level) + instruction->parameter)], instruction[1].parameter);
+                stack[t + 2] = instruction[3].parameter;
+                this->heap.store(stack[t + 1], stack[t + 2]);
+                FUSED(5);
+            case SI_LOD_LIT_OPR_STO:
+                HANDLER(handler_lod_lit_opr_sto)
+                check_push(2);
+                stack[t + 2] = instruction[1].parameter;
+                stack[t + 1] = binary_operation<Cell>(instruction[2].parameter, stack[check_address(base(instruction->level) + instruction->parameter)], stack[t + 2]);
+                stack[check_address(base(instruction[3].level) + instruction[3].parameter)] = stack[t + 1];
+                FUSED(4);
+            case SI_LOD_LIT_OPR_JMC:
+                HANDLER(handler_lod_lit_opr_jmc)
+                check_push(2);
+                stack[t + 2] = instruction[1].parameter;
+                stack[t + 1] = binary_operation<Cell>(instruction[2].parameter, stack[check_address(base(instruction->level) + instruction->parameter)], stack[t + 2]);
+                if (stack[t + 1] == 0) {
+                    p = check_jump(instruction[3].parameter);
+                    fused += 3;
+                    CHECK_LIMIT(3);
+                    NEXT();
+                }
+                FUSED(4);
+            case SI_LOD_LIT_OPR:
+                HANDLER(handler_lod_lit_opr)
+                check_push(2);
+                stack[t + 2] = instruction[1].parameter;
+                stack[t + 1] = binary_operation<Cell>(instruction[2].parameter, stack[check_address(base(instruction->level) + instruction->parameter)], stack[t + 2]);
+                t++;
+                FUSED(3);
+            case SI_LOD_LOD_OPR:
+                HANDLER(handler_lod_lod_opr)
+                check_push(2);
+                stack[t + 1] = stack[check_address(base(instruction->level) + instruction->parameter)];
+                stack[t + 2] = stack[check_address(base(instruction[1].level) + instruction[1].parameter)];
+                stack[t + 1] = binary_operation<Cell>(instruction[2].parameter, stack[t + 1], stack[t + 2]);
+                t++;
+                FUSED(3);
+            case SI_LIT_ZERO_EQ:
+                HANDLER(handler_lit_zero_eq)
+                check_pop(1);
+                check_push(1);
+                stack[t + 1] = 0;
+                stack[t] = stack[t] == 0;
+                FUSED(2);
+            case SI_LIT_LIT_ITR:
+                HANDLER(handler_lit_lit_itr)
+                {
+                    check_push(2);
+                    auto value = decimal_float_from_parts<Cell>(instruction->parameter, instruction[1].parameter);
+                    stack[++t] = value.mantissa;
+                    stack[++t] = value.exponent;
+                }
+                FUSED(3);
+            case SI_LIT_ZERO_ITR:
+                HANDLER(handler_lit_zero_itr)
+                /* Float with no fractional part is the whole part with the exponent 0 */
+                check_pop(1);
+                check_push(1);
+                stack[++t] = 0;
+                FUSED(2);
+            case SI_LIT_STO:
+                HANDLER(handler_lit_sto)
+                check_push(1);
+                stack[t + 1] = instruction->parameter;
+                stack[check_address(base(instruction[1].level) + instruction[1].parameter)] = stack[t + 1];
+                FUSED(2);
+            case SI_LOD_STO:
+                HANDLER(handler_lod_sto)
+                check_push(1);
+                stack[t + 1] = stack[check_address(base(instruction->level) + instruction->parameter)];
+                stack[check_address(base(instruction[1].level) + instruction[1].parameter)] = stack[t + 1];
+                FUSED(2);
+            case SI_LOD_LOD:
+                HANDLER(handler_lod_lod)
+                check_push(2);
+                stack[t + 1] = stack[check_address(base(instruction->level) + instruction->parameter)];
+                t++;
+                stack[t + 1] = stack[check_address(base(instruction[1].level) + instruction[1].parameter)];
+                t++;
+                FUSED(2);
+            case SI_STO_STO:
+                HANDLER(handler_sto_sto)
+                check_pop(2);
+                stack[check_address(base(instruction->level) + instruction->parameter)] = stack[t];
+                stack[check_address(base(instruction[1].level) + instruction[1].parameter)] = stack[t - 1];
+                t -= 2;
+                FUSED(2);
+
+            default:
+                throw std::runtime_error("invalid instruction " + std::to_string(instruction->opcode));
+        }
+
+#if YADC_VM_COMPUTED_GOTO
+        handler_end_of_program: __attribute__((unused));
+        /* The sentinel is not a real instruction */
+        p--;
+        counter--;
+        throw std::runtime_error("program counter out of range");
+#endif
+
+        finished:
+        done = true;
+        goto native;
+
+        /* Failed check of the unchecked loop, the instruction is executed again by the checked loop */
+        checks_failed: __attribute__((unused));
+        p--;
+        counter--;
+        this->unchecked = false;
+        native:;
+    } catch (const std::runtime_error &error) {
+        this->p = p;
+        this->b = b;
+        this->t = t;
+        this->instruction_counter = counter + fused;
+        this->dispatch_counter = counter;
+        throw_at_instruction(error, p - 1);
+    }
+
+    this->p = p;
+    this->b = b;
+    this->t = t;
+    this->instruction_counter = counter + fused;
+    this->dispatch_counter = counter;
+    return done;
+}
+
+template<typename Cell>
+bool BasicVirtualMachine<Cell>::execute_native() {
+    /* Compiler is enabled only for the 64-bit cells (enable_jit) */
+    if constexpr (std::is_same_v<Cell, cell_t>) {
+        auto state = JitState{this->stack.data(), static_cast<cell_t>(this->stack.size()), this->b, this->t, this->instruction_counter, nullptr,
+                              &this->heap, &this->input, &this->output, this->p, JIT_EXIT_INTERPRET};
+        for (;;) {
+            this->jit->execute(state);
+            /* Call of the function which is not compiled yet may make it hot */
+            if (state.exit != JIT_EXIT_CALL || !this->jit->enter_call(state.p))
+                break;
+        }
+
+        this->p = state.p;
+        this->b = state.b;
+        this->t = state.t;
+        this->instruction_counter = state.instruction_counter;
+        return state.exit == JIT_EXIT_FINISHED;
+    } else {
+        return false;
+    }
+}
+
+template<typename Cell>
+void BasicVirtualMachine<Cell>::execute_registers() {
+    /* Register code is translated once, on the first run */
+    if (this->register_code.instructions.empty())
+        this->register_code = translate_to_register_code(this->program.get_instructions());
+
+    const auto *code = this->register_code.instructions.data();
+    const auto &entries = this->register_code.entries;
+    auto *stack = this->stack.data();
+    const auto stack_size = static_cast<Cell>(this->stack.size());
+
+    auto b = this->b;
+    auto t = this->t;
+    auto counter = this->dispatch_counter;
+    auto instructions = this->instruction_counter;
+    const RegisterInstruction *instruction = nullptr;
+
+    auto base = [&](Cell level) {
+        auto result = b;
+        while (level-- > 0) {
+            result = stack[result];
+            if (result < 0 || result >= stack_size)
+                throw std::runtime_error("corrupted static link");
+        }
+        return result;
+    };
+    auto check_address = [&](Cell address) {
+        if (static_cast<std::uint64_t>(address) >= static_cast<std::uint64_t>(stack_size)) [[unlikely]]
+            throw_address_out_of_range(address);
+        return address;
+    };
+    /* Stack cell of the register or variable operand */
+    auto operand_address = [&](const Operand &operand) {
+        if (operand.kind == OPERAND_REGISTER)
+            return check_address(t + 1 + operand.value);
+        return check_address(base(operand.level) + operand.value);
+    };
+    auto load = [&](const Operand &operand) -> Cell {
+        if (operand.kind == OPERAND_CONSTANT)
+            return operand.value;
+        return stack[operand_address(operand)];
+    };
+    auto store = [&](const Operand &operand, Cell value) {
+        stack[operand_address(operand)] = value;
+    };
+    auto jump = [&](std::int32_t target) {
+        if (target < 0)
+            throw std::runtime_error("jump target out of range");
+        /* Register code is not run in slices, so only the instruction limit is reached here */
+        if (instructions > this->instruction_limit.load(std::memory_order_relaxed)) [[unlikely]]
+            this->limit_reached(instructions);
+        return code + target;
+    };
+
+    auto start = this->p < entries.size() ? entries[this->p] : -1;
+    if (start < 0)
+        throw RuntimeError("program counter " + std::to_string(this->p) + " does not start a basic block");
+    auto pc = code + start;
+
+    try {
+        while (true) {
+            instruction = pc++;
+            counter++;
+            instructions += instruction->count;
+
+            switch (instruction->opcode) {
+                case REG_MOVE:
+                    store(instruction->destination, load(instruction->left));
+                    break;
+                case REG_UNARY:
+                    if (instruction->operation == PL0_NEG)
+                        store(instruction->destination, wrapping_sub<Cell>(0, load(instruction->left)));
+                    else
+                        store(instruction->destination, load(instruction->left) & 1);
+                    break;
+                case REG_BINARY:
+                    store(instruction->destination, binary_operation<Cell>(instruction->operation, load(instruction->left), load(instruction->right)));
+                    break;
+                case REG_JUMP:
+                    pc = jump(instruction->target);
+                    break;
+                case REG_JUMP_IF_ZERO:
+                    if (load(instruction->left) == 0)
+                        pc = jump(instruction->target);
+                    break;
+                case REG_ADJUST:
+                    if (t + instruction->target >= stack_size)
+                        throw std::runtime_error("stack overflow");
+                    if (t + instruction->target < -1)
+                        throw std::runtime_error("stack underflow");
+                    t += instruction->target;
+                    break;
+                case REG_CALL:
+                    if (t + 3 >= stack_size)
+                        throw std::runtime_error("stack overflow");
+                    stack[t + 1] = base(instruction->operation);
+                    stack[t + 2] = b;
+                    /* Return address is the PL/0 address, the stack is the same as of the stack machine */
+                    stack[t + 3] = instruction->address + 1;
+                    b = t + 1;
+                    pc = jump(instruction->target);
+                    break;
+                case REG_RETURN: {
+                    t = b - 1;
+                    check_address(b);
+                    check_address(b + 2);
+                    auto return_address = stack[t + 3];
+                    b = stack[t + 2];
+                    if (return_address == 0)
+                        goto finished;
+                    if (return_address < 0 || return_address >= static_cast<Cell>(entries.size()) || entries[return_address] < 0)
+                        throw std::runtime_error("jump target " + std::to_string(return_address) + " out of range");
+                    pc = jump(entries[return_address]);
+                    break;
+                }
+                case REG_READ: {
+                    auto character = this->input.get();
+                    if (character == INPUT_PENDING)
+                        throw std::runtime_error("input is not available yet, the program must run in slices");
+                    store(instruction->destination, character == END_OF_INPUT ? '\n' : character);
+                    break;
+                }
+                case REG_WRITE:
+                    this->output.put(static_cast<char>(load(instruction->left)));
+                    break;
+                case REG_NEW:
+                    store(instruction->destination, this->heap.allocate(load(instruction->left)));
+                    break;
+                case REG_DELETE:
+                    this->heap.free(load(instruction->left));
+                    break;
+                case REG_LOAD_HEAP:
+                    store(instruction->destination, this->heap.load(load(instruction->left)));
+                    break;
+                case REG_STORE_HEAP:
+                    this->heap.store(load(instruction->left), load(instruction->right));
+                    break;
+                case REG_LOAD_INDIRECT: {
+                    auto address = base(load(instruction->left)) + load(instruction->right);
+                    store(instruction->destination, stack[check_address(address)]);
+                    break;
+                }
+                case REG_STORE_INDIRECT: {
+                    auto address = base(load(instruction->left)) + load(instruction->right);
+                    stack[check_address(address)] = load(instruction->destination);
+                    break;
+                }
+                case REG_INT_TO_FLOAT: {
+                    auto value = decimal_float_from_parts<Cell>(load(instruction->left), load(instruction->right));
+                    auto exponent = instruction->destination;
+                    exponent.value++;
+                    store(instruction->destination, value.mantissa);
+                    store(exponent, value.exponent);
+                    break;
+                }
+                case REG_FLOAT_TO_INT:
+                    store(instruction->destination,
+                          decimal_float_to_part(BasicDecimalFloat<Cell>{load(instruction->left), load(instruction->right)}, instruction->operation != 0));
+                    break;
+                case REG_FLOAT:
+                    if (instruction->operation == PL0_NEG) {
+                        if (t - 2 < -1)
+                            throw std::runtime_error("stack underflow");
+                        stack[t - 1] = wrapping_sub<Cell>(0, stack[t - 1]);
+                    } else {
+                        if (t - 4 < -1)
+                            throw std::runtime_error("stack underflow");
+                        auto left = BasicDecimalFloat<Cell>{stack[t - 3], stack[t - 2]};
+                        auto right = BasicDecimalFloat<Cell>{stack[t - 1], stack[t]};
+                        if (decimal_float_is_comparison(instruction->operation)) {
+                            t -= 3;
+                            stack[t] = decimal_float_compare(instruction->operation, left, right);
+                        } else {
+                            auto result = decimal_float_arithmetic(instruction->operation, left, right);
+                            t -= 2;
+                            stack[t - 1] = result.mantissa;
+                            stack[t] = result.exponent;
+                        }
+                    }
+                    break;
+                default:
+                    if (instruction->operation == PL0_NUM_OF_INSTRUCTIONS)
+                        throw std::runtime_error("program counter out of range");
+                    if (instruction->operation == PL0_OPR)
+                        throw std::runtime_error("invalid operation " + std::to_string(instruction->target));
+                    throw std::runtime_error("invalid instruction " + std::to_string(instruction->operation));
+            }
+        }
+        finished:;
+    } catch (const std::runtime_error &error) {
+        this->p = instruction->address + 1;
+        this->b = b;
+        this->t = t;
+        this->instruction_counter = instructions;
+        this->dispatch_counter = counter;
+        throw_at_instruction(error, instruction->address);
+    }
+
+    this->p = 0;
+    this->b = b;
+    this->t = t;
+    this->instruction_counter = instructions;
+    this->dispatch_counter = counter;
+}
+
+template<typename Cell>
+void BasicVirtualMachine<Cell>::run(DispatchMode dispatch_mode) {
+    if (this->profiler) {
+        if (!this->execute<false, true>())
+            throw RuntimeError("input is not available yet, the program must run in slices");
+        if (this->heap_profiler)
+            this->heap_profiler->finish(this->instruction_counter);
+        this->output.flush();
+        return;
+    }
+
+    if (dispatch_mode == DISPATCH_REGISTER) {
+        this->execute_registers();
+        this->output.flush();
+        return;
+    }
+
+    auto finished = false;
+    while (!finished) {
+        finished = this->interpret(dispatch_mode);
+        /* Interpreter left to the compiled code */
+        if (!finished && this->jit)
+            finished = this->execute_native();
+        else if (!finished)
+            throw RuntimeError("input is not available yet, the program must run in slices");
+    }
+    this->output.flush();
+}
+
+template<typename Cell>
+bool BasicVirtualMachine<Cell>::interpret(DispatchMode dispatch_mode) {
+    for (;;) {
+        auto unchecked = this->unchecked;
+        bool finished;
+#if YADC_VM_COMPUTED_GOTO
+        if (dispatch_mode == DISPATCH_THREADED)
+            finished = unchecked ? this->execute<true, false, false>() : this->execute<true>();
+        else
+#endif
+            finished = unchecked ? this->execute<false, false, false>() : this->execute<false>();
+        (void) dispatch_mode;
+        /* Unchecked loop left to the checked loop at the failed check */
+        if (finished || !unchecked || this->unchecked)
+            return finished;
+    }
+}
+
+template<typename Cell>
+SliceState BasicVirtualMachine<Cell>::run_slice(std::uint64_t instructions, DispatchMode dispatch_mode) {
+    /* Compiled code cannot leave in the middle of a function */
+    this->jit.reset();
+    this->slice_limit = UINT64_MAX - this->instruction_counter > instructions ? this->instruction_counter + instructions : UINT64_MAX;
+    this->slice_state = SLICE_YIELDED;
+    this->update_instruction_limit();
+
+    auto finished = false;
+    try {
+        finished = this->profiler ? this->execute<false, true>() : this->interpret(dispatch_mode);
+    } catch (...) {
+        this->slice_limit = UINT64_MAX;
+        this->update_instruction_limit();
+        this->output.flush();
+        throw;
+    }
+    this->slice_limit = UINT64_MAX;
+    this->update_instruction_limit();
+    this->output.flush();
+    if (!finished)
+        return this->slice_state;
+    if (this->heap_profiler)
+        this->heap_profiler->finish(this->instruction_counter);
+    return SLICE_FINISHED;
+}
+
+template<typename Cell>
+void BasicVirtualMachine<Cell>::run_to_main(DispatchMode dispatch_mode) {
+    const auto &instructions = this->program.get_instructions();
+    const auto size = instructions.size();
+    if (size < 2 || instructions[size - 2].opcode != PL0_CAL || instructions[size - 1].opcode != PL0_RET)
+        throw RuntimeError("program does not end by the call of main");
+    if (this->instruction_counter != 0)
+        throw RuntimeError("program has already started");
+    const auto main_address = static_cast<std::uint32_t>(instructions[size - 2].parameter);
+    const auto return_address = static_cast<Cell>(size - 1);
+
+    /* Every slice ends at the first jump, call or return, main is entered by the call returning to the final RET */
+    while (this->p != main_address || this->stack[this->b + 2] != return_address) {
+        auto state = this->run_slice(1, dispatch_mode);
+        if (state == SLICE_FINISHED)
+            throw RuntimeError("program finished before main was called");
+        if (state == SLICE_WAITING_INPUT)
+            throw RuntimeError("global code reads the input before main is called");
+    }
+}
+
+template<typename Cell>
+void BasicVirtualMachine<Cell>::save_snapshot(const std::string &file_name, const std::string &output) const {
+    auto image = ImageWriter();
+    image.write(SNAPSHOT_MAGIC);
+    image.write(SNAPSHOT_VERSION);
+    image.write<std::uint32_t>(sizeof(Cell));
+    image.write(hash_instructions(this->program.get_instructions()));
+    image.write(this->p);
+    image.write(this->b);
+    image.write(this->t);
+    image.write(this->instruction_counter);
+    image.write(this->dispatch_counter);
+
+    /* Cells above the last non-zero cell are zero as in a new stack (the cells above the top may still be read through pointers) */
+    auto cells = this->stack.size();
+    while (cells > 0 && this->stack[cells - 1] == 0)
+        cells--;
+    image.write<std::uint64_t>(cells);
+    image.write_bytes(this->stack.data(), cells * sizeof(Cell));
+    this->heap.save(image);
+    image.write<std::uint64_t>(output.size());
+    image.write_bytes(output.data(), output.size());
+    image.save(file_name);
+}
+
+template<typename Cell>
+void BasicVirtualMachine<Cell>::restore_snapshot(const std::string &file_name) {
+    auto image = ImageReader(file_name);
+    if (image.read<std::uint64_t>() != SNAPSHOT_MAGIC || image.read<std::uint32_t>() != SNAPSHOT_VERSION
+        || image.read<std::uint32_t>() != sizeof(Cell))
+        throw std::runtime_error("invalid snapshot image \"" + file_name + "\"");
+    if (image.read<std::uint64_t>() != hash_instructions(this->program.get_instructions()))
+        throw std::runtime_error("snapshot image \"" + file_name + "\" was taken from another program");
+    if (this->instruction_counter != 0)
+        throw std::runtime_error("program has already started");
+
+    auto p = image.read<std::uint32_t>();
+    auto b = image.read<Cell>();
+    auto t = image.read<Cell>();
+    auto instruction_counter = image.read<std::uint64_t>();
+    auto dispatch_counter = image.read<std::uint64_t>();
+    auto cells = image.read<std::uint64_t>();
+    if (cells > this->stack.size())
+        throw std::runtime_error("stack of the snapshot image (" + std::to_string(cells) + " cells) exceeds the size of the stack");
+    const auto stack_size = static_cast<Cell>(this->stack.size());
+    if (p >= this->program.size() || t < -1 || b < 1 || b > t + 1 || b + 2 >= stack_size)
+        throw std::runtime_error("corrupted snapshot image \"" + file_name + "\"");
+    std::memcpy(this->stack.data(), image.read_bytes(cells * sizeof(Cell)), cells * sizeof(Cell));
+    this->heap.restore(image);
+    auto length = image.read<std::uint64_t>();
+    const auto *output = image.read_bytes(length);
+    for (std::uint64_t i = 0; i < length; i++)
+        this->output.put(output[i]);
+
+    this->p = p;
+    this->b = b;
+    this->t = t;
+    this->instruction_counter = instruction_counter;
+    this->dispatch_counter = dispatch_counter;
+    this->update_instruction_limit();
+    /* Unchecked loop needs the headroom of the called function, CAL checked it before the snapshot for its stack */
+    if (this->unchecked && b - 1 + this->program.get_verification().bounds[p].headroom >= stack_size)
+        this->unchecked = false;
+    if (this->profiler)
+        this->profiler->call(p);
+}
+
+template class BasicVirtualMachine<cell_t>;
+template class BasicVirtualMachine<compact_cell_t>;
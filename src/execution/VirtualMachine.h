@@ -0,0 +1,346 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "BufferedIo.h"
+#include "Cell.h"
+#include "Heap.h"
+#include "HeapProfiler.h"
+#include "Jit.h"
+#include "Profiler.h"
+#include "Program.h"
+#include "RegisterCode.h"
+#include "ReservedMemory.h"
+#include "Superinstructions.h"
+#include "Verifier.h"
+
+/** Default size of the stack (in cells) */
+const std::size_t DEFAULT_STACK_SIZE = 1 << 20;
+/** Initial number of the display entries saved by the calls (doubled when the calls go deeper) */
+const std::size_t DISPLAY_LINKS_CAPACITY = 1024;
+
+/**
+ * Enum for dispatch modes of the interpreter loop
+ */
+enum DispatchMode {
+    /** Portable switch over the opcode */
+    DISPATCH_SWITCH,
+    /** Direct threaded code (GCC labels as values), available when built with YADC_VM_COMPUTED_GOTO */
+    DISPATCH_THREADED,
+    /** Register code translated from the basic blocks (operand stack slots become virtual registers) */
+    DISPATCH_REGISTER
+};
+
+#if YADC_VM_COMPUTED_GOTO
+/** Default dispatch mode */
+const DispatchMode DEFAULT_DISPATCH_MODE = DISPATCH_THREADED;
+#else
+/** Default dispatch mode */
+const DispatchMode DEFAULT_DISPATCH_MODE = DISPATCH_SWITCH;
+#endif
+
+/** Default number of the instructions of a slice (run_slice) */
+const std::uint64_t DEFAULT_SLICE = 100000;
+
+/**
+ * Enum for states of the program after a slice of the execution
+ */
+enum SliceState {
+    /** Program finished */
+    SLICE_FINISHED,
+    /** Slice of the instructions was executed, the program continues by the next slice */
+    SLICE_YIELDED,
+    /** Program waits for more input (REA), it continues by the next slice after provide_input() or close_input() */
+    SLICE_WAITING_INPUT
+};
+
+/**
+ * Struct for pre-decoded instruction of the threaded code
+ */
+typedef struct ThreadedInstruction {
+    /** Address of the instruction handler */
+    const void *handler;
+    /** Opcode (only for the switch shared with the handlers) */
+    std::uint8_t opcode;
+    /** Level */
+    std::uint8_t level;
+    /** Parameter */
+    std::int32_t parameter;
+} ThreadedInstruction;
+
+/**
+ * Exception thrown when the executed program fails (division by zero, stack overflow, ...)
+ */
+class RuntimeError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * Exception thrown when the executed program runs out of its instruction limit (fuel)
+ */
+class FuelExhaustedError : public RuntimeError {
+public:
+    using RuntimeError::RuntimeError;
+};
+
+/**
+ * Exception thrown when the executed program is stopped by the interruption (e.g. its time limit)
+ */
+class InterruptedError : public RuntimeError {
+public:
+    using RuntimeError::RuntimeError;
+};
+
+/**
+ * Class representing the virtual machine executing the extended PL/0 instruction set
+ * Interpreter loops are compiled for each cell type, the 32-bit cells halve the memory of the stack and heap
+ * (the JIT compiler and the allocation profiler are available with the 64-bit cells only)
+ * @tparam Cell Type of the cell of the stack and heap (cell_t or compact_cell_t)
+ */
+template<typename Cell>
+class BasicVirtualMachine {
+private:
+    /** Executed program */
+    const Program &program;
+    /** Executed code (instructions of the program, possibly with superinstructions) */
+    std::vector<DecodedInstruction> code;
+    /** Stack (reserved virtual memory, its pages are committed when the program reaches them) */
+    ReservedMemory<Cell> stack;
+    /** Heap */
+    BasicHeap<Cell> heap;
+    /** Input of the program (REA) */
+    InputBuffer input;
+    /** Output of the program (WRI) */
+    OutputBuffer output;
+    /** Program counter */
+    std::uint32_t p;
+    /** Base of the current activation record */
+    Cell b;
+    /** Top of the stack */
+    Cell t;
+    /** Number of executed instructions */
+    std::uint64_t instruction_counter;
+    /** Number of dispatches (superinstruction is dispatched once) */
+    std::uint64_t dispatch_counter;
+    /** Threaded code (built on the first threaded run) */
+    std::vector<ThreadedInstruction> threaded_code;
+    /** True if the threaded code jumps to the handlers of the checked interpreter loop; False otherwise */
+    bool threaded_code_checked;
+    /** True if the verified program runs on the interpreter loop without the checks of the stack top, of the jump targets
+     * and of the program counter; False otherwise (cleared when the check at CAL, RET or INT fails, the checked loop continues) */
+    bool unchecked;
+    /** Register code (translated on the first register run) */
+    RegisterCode register_code;
+    /** Display of the interpreter loop (bases of the activation records of the static chain by their static depth) */
+    std::vector<Cell> display;
+    /** Display entries overwritten by the calls and static depths of the callers, restored by the returns (stack of the loop) */
+    std::vector<std::pair<Cell, std::size_t>> display_links;
+    /** True if the interpreter loop keeps the display; False if it walks the static links */
+    bool display_enabled;
+    /** JIT compiler of the hot functions (nullptr if disabled) */
+    std::unique_ptr<JitCompiler> jit;
+    /** Profiler of the executed instructions (nullptr if disabled) */
+    std::unique_ptr<Profiler> profiler;
+    /** Profiler of the allocations (nullptr if disabled) */
+    std::unique_ptr<HeapProfiler> heap_profiler;
+    /** Number of the executed instructions checked by the interpreter (minimum of the limits, 0 after interrupt() from another thread) */
+    std::atomic<std::uint64_t> instruction_limit;
+    /** Maximum number of the executed instructions (set_instruction_limit) */
+    std::uint64_t fuel_limit;
+    /** Number of the executed instructions at the end of the slice (UINT64_MAX if not run in slices) */
+    std::uint64_t slice_limit;
+    /** State of the program after the slice (set by the interpreter loop when it leaves before the end of the program) */
+    SliceState slice_state;
+    /** True if the program was stopped by interrupt(); False otherwise */
+    std::atomic<bool> interrupted;
+
+    /**
+     * Builds the display of the interpreter loop from the static chain and drops the saved display entries
+     * @param base Base of the executed activation record
+     * @return Static depth of the executed function (0 for the global code)
+     */
+    std::size_t build_display(Cell base);
+    /**
+     * Interpreter loop
+     * @tparam threaded True for the direct threaded dispatch; False for the switch dispatch
+     * @tparam profiled True if every instruction is reported to the profiler (switch dispatch only)
+     * @tparam checked True if every instruction checks the stack top and the jump targets; False for the verified program
+     * @return True if the program finished; False if the loop left before p (compiled code, end of the slice, checked loop)
+     */
+    template<bool threaded, bool profiled = false, bool checked = true>
+    bool execute();
+    /**
+     * Runs the interpreter loop (unchecked if the program was verified) until the program finishes or the loop leaves
+     * @param dispatch_mode Dispatch mode (switch or threaded)
+     * @return True if the program finished; False if the compiled code continues at p or the slice ended
+     */
+    bool interpret(DispatchMode dispatch_mode);
+    /**
+     * Runs the compiled code until it leaves to the interpreter
+     * @return True if the program finished; False if the interpreter continues at p
+     */
+    bool execute_native();
+    /**
+     * Interpreter loop of the register code
+     */
+    void execute_registers();
+    /**
+     * Sets the instruction limit checked by the interpreter from the instruction limit and the end of the slice
+     */
+    void update_instruction_limit();
+    /**
+     * Handles the instruction limit reached by the interpreter (kept out of the interpreter loop)
+     * Throws InterruptedError if the program was interrupted, FuelExhaustedError if it executed too many instructions
+     * @param instructions Number of the executed instructions
+     * @return True (the end of the slice)
+     */
+    [[gnu::noinline]] bool limit_reached(std::uint64_t instructions) const;
+
+public:
+    /**
+     * Constructor
+     * @param program Program to execute
+     * @param input Input of the program (REA), the output is tied to it
+     * @param output Output of the program (WRI), flushed when the program finishes or waits for the input
+     * @param stack_size Size of the stack (in cells)
+     * @param heap_size Maximum size of the heap (in cells)
+     * @param superinstructions True if the known instruction sequences are fused into superinstructions; False otherwise
+     */
+    BasicVirtualMachine(const Program &program, InputBuffer input, OutputBuffer output,
+                        std::size_t stack_size = DEFAULT_STACK_SIZE, std::size_t heap_size = DEFAULT_HEAP_SIZE,
+                        bool superinstructions = true);
+    /**
+     * Destructor
+     */
+    ~BasicVirtualMachine();
+
+    /**
+     * Enables the JIT compiler of the hot functions (used by the switch and threaded dispatch)
+     * @param threshold Number of calls after which the function is compiled
+     * @return True if enabled; False if the JIT compiler is not available on this platform
+     */
+    bool enable_jit(std::uint32_t threshold = DEFAULT_JIT_THRESHOLD);
+    /**
+     * Runs the verified program on the interpreter loop with all checks (e.g. to measure the unchecked loop)
+     */
+    void enable_checks();
+    /**
+     * Walks the static links to the variables of the enclosing functions instead of keeping the display (e.g. to measure the display)
+     */
+    void disable_display();
+    /**
+     * Checks if the program runs on the interpreter loop without the checks (verified program, no JIT compiler or profiler)
+     * @return True if the interpreter loop is unchecked; False otherwise
+     */
+    [[nodiscard]] bool is_unchecked() const;
+    /**
+     * Enables the instruction-level profiler, the program is then run by the switch dispatch without superinstructions and JIT
+     * @return Profiler (owned by the virtual machine)
+     */
+    Profiler &enable_profiler();
+    /**
+     * Enables the allocation profiler (and the instruction profiler, which attributes the allocations to the functions)
+     * @return Allocation profiler (owned by the virtual machine)
+     */
+    HeapProfiler &enable_heap_profiler();
+    /**
+     * Enables the collection of the heap blocks no longer reachable from the stack (e.g. leaked string literals)
+     */
+    void enable_collection();
+    /**
+     * Limits the number of the executed instructions, the interpreter checks the limit at the jumps, calls and returns
+     * (so it is exceeded by less than the length of the code), the compiled code of the JIT is not limited;
+     * the program which reaches the limit fails with FuelExhaustedError
+     * @param limit Maximum number of the executed instructions
+     */
+    void set_instruction_limit(std::uint64_t limit);
+    /**
+     * Stops the running program at its next jump, call or return with InterruptedError (may be called from another thread)
+     */
+    void interrupt();
+    /**
+     * Appends the input of the program (only to the input in memory created by InputBuffer(), between the slices)
+     * @param data Input
+     */
+    void provide_input(const std::string &data);
+    /**
+     * Ends the input of the program (only the input in memory created by InputBuffer(), between the slices)
+     */
+    void close_input();
+
+    /**
+     * Runs the program until the final return
+     * Throws RuntimeError if the program fails
+     * @param dispatch_mode Dispatch mode of the interpreter loop (threaded falls back to switch if not available, ignored if profiled)
+     */
+    void run(DispatchMode dispatch_mode = DEFAULT_DISPATCH_MODE);
+    /**
+     * Runs the program until it finishes, executes about the number of the instructions (the slice ends at a jump, call or return)
+     * or waits for the input which has not arrived yet, the next call continues where the slice ended (the JIT compiler is disabled)
+     * Throws RuntimeError if the program fails
+     * @param instructions Number of the instructions of the slice
+     * @param dispatch_mode Dispatch mode of the interpreter loop (register dispatch is not resumable, it falls back to switch)
+     * @return State of the program after the slice
+     */
+    SliceState run_slice(std::uint64_t instructions = DEFAULT_SLICE, DispatchMode dispatch_mode = DEFAULT_DISPATCH_MODE);
+    /**
+     * Runs the global code of the program (global variables, string literals) until it calls main, the call of main is the last CAL
+     * of the program followed by the final RET (InstructionsGenerator::generate), the program stops at the entry of main
+     * The input should be the input in memory created by InputBuffer(), so the global code which reads the input is detected
+     * Throws RuntimeError if the program fails, finishes or reads the input before main is called
+     * @param dispatch_mode Dispatch mode of the interpreter loop (register dispatch falls back to switch)
+     */
+    void run_to_main(DispatchMode dispatch_mode = DEFAULT_DISPATCH_MODE);
+    /**
+     * Writes the snapshot image of the program stopped by run_to_main: registers, stack, heap and the output written so far
+     * @param file_name Image file name
+     * @param output Output written by the program before the snapshot (written again when the image is restored)
+     */
+    void save_snapshot(const std::string &file_name, const std::string &output) const;
+    /**
+     * Restores the snapshot image of the same program before the program runs, the program then continues by main
+     * (run, run_slice), the saved output is written to the output first; the image is mapped to memory, not parsed
+     * Throws std::runtime_error if the image is invalid, was taken from another program or does not fit into the stack or the heap
+     * @param file_name Image file name
+     */
+    void restore_snapshot(const std::string &file_name);
+
+    /**
+     * Get number of executed instructions
+     * @return Number of executed instructions
+     */
+    [[nodiscard]] std::uint64_t get_instruction_counter() const;
+    /**
+     * Get number of dispatches (equals to the number of executed instructions without superinstructions)
+     * @return Number of dispatches
+     */
+    [[nodiscard]] std::uint64_t get_dispatch_counter() const;
+    /**
+     * Get number of functions compiled by the JIT compiler
+     * @return Number of compiled functions
+     */
+    [[nodiscard]] std::uint32_t get_compiled_functions() const;
+    /**
+     * Get allocation and fragmentation statistics of the heap
+     * @return Statistics of the heap
+     */
+    [[nodiscard]] const HeapStatistics &get_heap_statistics() const;
+    /**
+     * Get whether the program was stopped by interrupt()
+     * @return True if the program was interrupted; False otherwise
+     */
+    [[nodiscard]] bool is_interrupted() const;
+};
+
+/** Virtual machine with the 64-bit cells */
+typedef BasicVirtualMachine<cell_t> VirtualMachine;
+/** Virtual machine with the 32-bit cells */
+typedef BasicVirtualMachine<compact_cell_t> CompactVirtualMachine;
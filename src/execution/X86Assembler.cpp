@@ -0,0 +1,230 @@
+#include <stdexcept>
+#include "X86Assembler.h"
+
+X86Assembler::X86Assembler(std::uintptr_t address) : code(), address(address) {
+    /* Empty */
+}
+
+const std::vector<std::uint8_t> &X86Assembler::get_code() const {
+    return this->code;
+}
+
+std::size_t X86Assembler::offset() const {
+    return this->code.size();
+}
+
+void X86Assembler::byte(std::uint8_t value) {
+    this->code.push_back(value);
+}
+
+void X86Assembler::dword(std::uint32_t value) {
+    for (auto i = 0; i < 4; i++)
+        this->byte(static_cast<std::uint8_t>(value >> (8 * i)));
+}
+
+void X86Assembler::qword(std::uint64_t value) {
+    for (auto i = 0; i < 8; i++)
+        this->byte(static_cast<std::uint8_t>(value >> (8 * i)));
+}
+
+void X86Assembler::rex(bool wide, int reg, int index, int base, bool force) {
+    std::uint8_t prefix = 0x40 | (wide ? 0x08 : 0) | ((reg & 8) ? 0x04 : 0) | ((index >= 0 && (index & 8)) ? 0x02 : 0) | ((base & 8) ? 0x01 : 0);
+    if (prefix != 0x40 || force)
+        this->byte(prefix);
+}
+
+void X86Assembler::memory_operand(int reg, int base, int index, std::int32_t displacement) {
+    /* Always ModRM with SIB and 32-bit displacement, which encodes every base register (RSP, RBP, R12, R13 included) */
+    this->byte(static_cast<std::uint8_t>(0x80 | ((reg & 7) << 3) | 0x04));
+    if (index == NO_INDEX)
+        this->byte(static_cast<std::uint8_t>((0x04 << 3) | (base & 7)));
+    else
+        this->byte(static_cast<std::uint8_t>((3 << 6) | ((index & 7) << 3) | (base & 7)));
+    this->dword(static_cast<std::uint32_t>(displacement));
+}
+
+void X86Assembler::reference(X86Label &label) {
+    if (label.offset >= 0) {
+        this->dword(static_cast<std::uint32_t>(static_cast<std::int32_t>(label.offset - static_cast<std::ptrdiff_t>(this->code.size() + 4))));
+    } else {
+        label.references.push_back(this->code.size());
+        this->dword(0);
+    }
+}
+
+void X86Assembler::bind(X86Label &label) {
+    label.offset = static_cast<std::ptrdiff_t>(this->code.size());
+    for (auto reference : label.references) {
+        auto displacement = static_cast<std::int32_t>(label.offset - static_cast<std::ptrdiff_t>(reference + 4));
+        for (auto i = 0; i < 4; i++)
+            this->code[reference + i] = static_cast<std::uint8_t>(static_cast<std::uint32_t>(displacement) >> (8 * i));
+    }
+    label.references.clear();
+}
+
+void X86Assembler::mov(X86Register destination, X86Register source) {
+    this->rex(true, source, NO_INDEX, destination);
+    this->byte(0x89);
+    this->byte(static_cast<std::uint8_t>(0xC0 | ((source & 7) << 3) | (destination & 7)));
+}
+
+void X86Assembler::mov_immediate(X86Register destination, std::int64_t value) {
+    if (value >= INT32_MIN && value <= INT32_MAX) {
+        this->rex(true, 0, NO_INDEX, destination);
+        this->byte(0xC7);
+        this->byte(static_cast<std::uint8_t>(0xC0 | (destination & 7)));
+        this->dword(static_cast<std::uint32_t>(value));
+    } else {
+        this->rex(true, 0, NO_INDEX, destination);
+        this->byte(static_cast<std::uint8_t>(0xB8 + (destination & 7)));
+        this->qword(static_cast<std::uint64_t>(value));
+    }
+}
+
+void X86Assembler::load(X86Register destination, X86Register base, int index, std::int32_t displacement) {
+    this->rex(true, destination, index, base);
+    this->byte(0x8B);
+    this->memory_operand(destination, base, index, displacement);
+}
+
+void X86Assembler::store(X86Register base, int index, std::int32_t displacement, X86Register source) {
+    this->rex(true, source, index, base);
+    this->byte(0x89);
+    this->memory_operand(source, base, index, displacement);
+}
+
+void X86Assembler::store_immediate(X86Register base, int index, std::int32_t displacement, std::int32_t value) {
+    this->rex(true, 0, index, base);
+    this->byte(0xC7);
+    this->memory_operand(0, base, index, displacement);
+    this->dword(static_cast<std::uint32_t>(value));
+}
+
+void X86Assembler::store_dword(X86Register base, std::int32_t displacement, X86Register source) {
+    this->rex(false, source, NO_INDEX, base);
+    this->byte(0x89);
+    this->memory_operand(source, base, NO_INDEX, displacement);
+}
+
+void X86Assembler::store_dword_immediate(X86Register base, std::int32_t displacement, std::int32_t value) {
+    this->rex(false, 0, NO_INDEX, base);
+    this->byte(0xC7);
+    this->memory_operand(0, base, NO_INDEX, displacement);
+    this->dword(static_cast<std::uint32_t>(value));
+}
+
+void X86Assembler::lea(X86Register destination, X86Register base, int index, std::int32_t displacement) {
+    this->rex(true, destination, index, base);
+    this->byte(0x8D);
+    this->memory_operand(destination, base, index, displacement);
+}
+
+void X86Assembler::arithmetic(X86Arithmetic operation, X86Register destination, X86Register source) {
+    this->rex(true, source, NO_INDEX, destination);
+    this->byte(static_cast<std::uint8_t>((operation << 3) | 0x01));
+    this->byte(static_cast<std::uint8_t>(0xC0 | ((source & 7) << 3) | (destination & 7)));
+}
+
+void X86Assembler::arithmetic_immediate(X86Arithmetic operation, X86Register destination, std::int32_t value) {
+    this->rex(true, 0, NO_INDEX, destination);
+    this->byte(0x81);
+    this->byte(static_cast<std::uint8_t>(0xC0 | (operation << 3) | (destination & 7)));
+    this->dword(static_cast<std::uint32_t>(value));
+}
+
+void X86Assembler::imul(X86Register destination, X86Register source) {
+    this->rex(true, destination, NO_INDEX, source);
+    this->byte(0x0F);
+    this->byte(0xAF);
+    this->byte(static_cast<std::uint8_t>(0xC0 | ((destination & 7) << 3) | (source & 7)));
+}
+
+void X86Assembler::neg(X86Register destination) {
+    this->rex(true, 0, NO_INDEX, destination);
+    this->byte(0xF7);
+    this->byte(static_cast<std::uint8_t>(0xC0 | (3 << 3) | (destination & 7)));
+}
+
+void X86Assembler::inc(X86Register destination) {
+    this->rex(true, 0, NO_INDEX, destination);
+    this->byte(0xFF);
+    this->byte(static_cast<std::uint8_t>(0xC0 | (destination & 7)));
+}
+
+void X86Assembler::dec(X86Register destination) {
+    this->rex(true, 0, NO_INDEX, destination);
+    this->byte(0xFF);
+    this->byte(static_cast<std::uint8_t>(0xC0 | (1 << 3) | (destination & 7)));
+}
+
+void X86Assembler::test(X86Register left, X86Register right) {
+    this->rex(true, right, NO_INDEX, left);
+    this->byte(0x85);
+    this->byte(static_cast<std::uint8_t>(0xC0 | ((right & 7) << 3) | (left & 7)));
+}
+
+void X86Assembler::cqo() {
+    this->byte(0x48);
+    this->byte(0x99);
+}
+
+void X86Assembler::idiv(X86Register divisor) {
+    this->rex(true, 0, NO_INDEX, divisor);
+    this->byte(0xF7);
+    this->byte(static_cast<std::uint8_t>(0xC0 | (7 << 3) | (divisor & 7)));
+}
+
+void X86Assembler::setcc_rax(X86Condition condition) {
+    /* setcc al; movzx eax, al (upper half of rax is cleared by the 32-bit move) */
+    this->byte(0x0F);
+    this->byte(static_cast<std::uint8_t>(0x90 | condition));
+    this->byte(0xC0);
+    this->byte(0x0F);
+    this->byte(0xB6);
+    this->byte(0xC0);
+}
+
+void X86Assembler::push(X86Register source) {
+    this->rex(false, 0, NO_INDEX, source);
+    this->byte(static_cast<std::uint8_t>(0x50 + (source & 7)));
+}
+
+void X86Assembler::pop(X86Register destination) {
+    this->rex(false, 0, NO_INDEX, destination);
+    this->byte(static_cast<std::uint8_t>(0x58 + (destination & 7)));
+}
+
+void X86Assembler::ret() {
+    this->byte(0xC3);
+}
+
+void X86Assembler::jmp(X86Label &label) {
+    this->byte(0xE9);
+    this->reference(label);
+}
+
+void X86Assembler::jmp(X86Register target) {
+    this->rex(false, 0, NO_INDEX, target);
+    this->byte(0xFF);
+    this->byte(static_cast<std::uint8_t>(0xC0 | (4 << 3) | (target & 7)));
+}
+
+void X86Assembler::jmp_absolute(std::uintptr_t target) {
+    this->byte(0xE9);
+    auto displacement = static_cast<std::int64_t>(target) - static_cast<std::int64_t>(this->address + this->code.size() + 4);
+    if (displacement < INT32_MIN || displacement > INT32_MAX)
+        throw std::runtime_error("jump target too far");
+    this->dword(static_cast<std::uint32_t>(displacement));
+}
+
+void X86Assembler::jcc(X86Condition condition, X86Label &label) {
+    this->byte(0x0F);
+    this->byte(static_cast<std::uint8_t>(0x80 | condition));
+    this->reference(label);
+}
+
+void X86Assembler::call(X86Register target) {
+    this->rex(false, 0, NO_INDEX, target);
+    this->byte(0xFF);
+    this->byte(static_cast<std::uint8_t>(0xC0 | (2 << 3) | (target & 7)));
+}
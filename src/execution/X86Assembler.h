@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Enum for x86-64 general purpose registers (encoding numbers)
+ */
+enum X86Register {
+    X86_RAX = 0,
+    X86_RCX,
+    X86_RDX,
+    X86_RBX,
+    X86_RSP,
+    X86_RBP,
+    X86_RSI,
+    X86_RDI,
+    X86_R8,
+    X86_R9,
+    X86_R10,
+    X86_R11,
+    X86_R12,
+    X86_R13,
+    X86_R14,
+    X86_R15
+};
+
+/**
+ * Enum for x86-64 condition codes (low nibble of the Jcc and SETcc opcodes)
+ */
+enum X86Condition {
+    X86_BELOW = 0x2,
+    X86_ABOVE_OR_EQUAL = 0x3,
+    X86_EQUAL = 0x4,
+    X86_NOT_EQUAL = 0x5,
+    X86_SIGN = 0x8,
+    X86_LESS = 0xC,
+    X86_GREATER_OR_EQUAL = 0xD,
+    X86_LESS_OR_EQUAL = 0xE,
+    X86_GREATER = 0xF
+};
+
+/**
+ * Enum for arithmetic instructions with the common encoding (opcode of the "r/m64, r64" form and /digit of the immediate form)
+ */
+enum X86Arithmetic {
+    X86_ADD = 0,
+    X86_AND = 4,
+    X86_SUB = 5,
+    X86_CMP = 7
+};
+
+/**
+ * Struct for label in the generated code
+ */
+typedef struct X86Label {
+    /** Offset of the label in the code (-1 if not bound yet) */
+    std::ptrdiff_t offset = -1;
+    /** Offsets of the 32-bit relative displacements waiting for the label */
+    std::vector<std::size_t> references;
+} X86Label;
+
+/**
+ * Class representing minimal x86-64 assembler (only the instructions needed by the JIT compiler)
+ * Memory operands are [base + index * 8 + displacement] or [base + displacement] (index NO_INDEX)
+ */
+class X86Assembler {
+private:
+    /** Generated code */
+    std::vector<std::uint8_t> code;
+    /** Address where the code will be placed (for jumps to the absolute addresses) */
+    std::uintptr_t address;
+
+    /**
+     * Emits bytes of the value (little endian)
+     * @param value Value
+     */
+    void byte(std::uint8_t value);
+    void dword(std::uint32_t value);
+    void qword(std::uint64_t value);
+    /**
+     * Emits REX prefix if needed
+     * @param wide True for the 64-bit operand size
+     * @param reg Register in the ModRM reg field
+     * @param index Index register (or NO_INDEX)
+     * @param base Register in the ModRM rm field or SIB base
+     * @param force True if the prefix is emitted even when empty
+     */
+    void rex(bool wide, int reg, int index, int base, bool force = false);
+    /**
+     * Emits ModRM, SIB and 32-bit displacement of the memory operand
+     * @param reg Register or opcode extension in the ModRM reg field
+     * @param base Base register
+     * @param index Index register scaled by 8 (or NO_INDEX)
+     * @param displacement Displacement
+     */
+    void memory_operand(int reg, int base, int index, std::int32_t displacement);
+    /**
+     * Emits 32-bit relative displacement to the label
+     * @param label Label
+     */
+    void reference(X86Label &label);
+
+public:
+    /** No index register in the memory operand */
+    static constexpr int NO_INDEX = -1;
+
+    /**
+     * Constructor
+     * @param address Address where the code will be placed
+     */
+    explicit X86Assembler(std::uintptr_t address);
+
+    /**
+     * Get generated code
+     * @return Generated code
+     */
+    [[nodiscard]] const std::vector<std::uint8_t> &get_code() const;
+    /**
+     * Get current offset in the generated code
+     * @return Offset
+     */
+    [[nodiscard]] std::size_t offset() const;
+
+    /**
+     * Binds the label to the current offset (and resolves the references waiting for it)
+     * @param label Label
+     */
+    void bind(X86Label &label);
+
+    /* Moves: mov, lea (all 64-bit, but store_dword) */
+    void mov(X86Register destination, X86Register source);
+    void mov_immediate(X86Register destination, std::int64_t value);
+    void load(X86Register destination, X86Register base, int index, std::int32_t displacement);
+    void store(X86Register base, int index, std::int32_t displacement, X86Register source);
+    void store_immediate(X86Register base, int index, std::int32_t displacement, std::int32_t value);
+    void store_dword(X86Register base, std::int32_t displacement, X86Register source);
+    void store_dword_immediate(X86Register base, std::int32_t displacement, std::int32_t value);
+    void lea(X86Register destination, X86Register base, int index, std::int32_t displacement);
+
+    /* Arithmetic (all 64-bit) */
+    void arithmetic(X86Arithmetic operation, X86Register destination, X86Register source);
+    void arithmetic_immediate(X86Arithmetic operation, X86Register destination, std::int32_t value);
+    void imul(X86Register destination, X86Register source);
+    void neg(X86Register destination);
+    void inc(X86Register destination);
+    void dec(X86Register destination);
+    void test(X86Register left, X86Register right);
+    void cqo();
+    void idiv(X86Register divisor);
+    /**
+     * Sets rax to 1 if the condition holds, to 0 otherwise
+     * @param condition Condition
+     */
+    void setcc_rax(X86Condition condition);
+
+    /* Stack and control flow */
+    void push(X86Register source);
+    void pop(X86Register destination);
+    void ret();
+    void jmp(X86Label &label);
+    void jmp(X86Register target);
+    void jmp_absolute(std::uintptr_t target);
+    void jcc(X86Condition condition, X86Label &label);
+    void call(X86Register target);
+};
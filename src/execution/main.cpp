@@ -0,0 +1,507 @@
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include "execution/Batch.h"
+#include "execution/Program.h"
+#include "execution/Server.h"
+#include "execution/VirtualMachine.h"
+
+/** Server stopped by SIGINT or SIGTERM (nullptr if not serving) */
+static ExecutionServer *active_server = nullptr;
+
+/**
+ * Prints usage of the program to stderr
+ * @param program_name name of the program
+ */
+void print_usage(const char *program_name) {
+    std::cerr << "Usage: " << program_name << " <instructions file> [options]" << std::endl;
+    std::cerr << "       " << program_name << " --serve=<socket> [--workers=<count>] [--fuel=<instructions>] [--time-limit=<ms>]"
+              << " [--stack=<cells>] [--heap=<cells>] [--output-limit=<bytes>]" << std::endl;
+    std::cerr << "Options:" << std::endl;
+    std::cerr << "    --stack=<cells> - size of the stack (default " << DEFAULT_STACK_SIZE << ")" << std::endl;
+    std::cerr << "    --heap=<cells>  - maximum size of the heap (default " << DEFAULT_HEAP_SIZE << ")" << std::endl;
+    std::cerr << "    --cells=<32|64> - width of the stack and heap cells, the 32-bit cells halve the memory and wrap the arithmetic"
+              << " at 32 bits (default 64)" << std::endl;
+    std::cerr << "    --dispatch=<switch|threaded|register> - dispatch of the interpreter loop (default "
+              << (DEFAULT_DISPATCH_MODE == DISPATCH_THREADED ? "threaded" : "switch") << ")" << std::endl;
+    std::cerr << "    --no-superinstructions - do not fuse instruction sequences into superinstructions" << std::endl;
+    std::cerr << "    --checked       - check the stack and the jumps at every instruction even if the program was verified at load time" << std::endl;
+    std::cerr << "    --no-display    - walk the static links to the variables of the enclosing functions instead of keeping the display" << std::endl;
+    std::cerr << "    --jit[=<calls>] - compile functions called at least <calls> times to x86-64 code (default "
+              << DEFAULT_JIT_THRESHOLD << ")" << std::endl;
+    std::cerr << "    --profile=<file> - count executed instructions (switch dispatch), write folded call stacks"
+              << " for flame graphs to the file and report functions and hot loops to stderr" << std::endl;
+    std::cerr << "    --heap-profile=<file> - attribute allocations to the NEW instructions and functions (switch dispatch), write"
+              << " JSON report to the file and never freed blocks to stderr" << std::endl;
+    std::cerr << "    --functions=<file> - entry addresses of the functions (functions.txt generated by the compiler), the builtin"
+              << " functions run natively (switch and threaded dispatch) and the profile names the functions" << std::endl;
+    std::cerr << "    --no-intrinsics - run the builtin functions as their PL/0 code even if --functions is given" << std::endl;
+    std::cerr << "    --gc            - free the heap blocks no longer reachable from the stack (e.g. string literals)" << std::endl;
+    std::cerr << "    --stats         - print number of executed instructions, run time and heap statistics to stderr" << std::endl;
+    std::cerr << "    --fuel=<instructions> - stop the program after the number of executed instructions" << std::endl;
+    std::cerr << "    --snapshot=<image> - run the global code until main is called, write the stack, heap and program counter"
+              << " to the image and exit" << std::endl;
+    std::cerr << "    --resume=<image> - continue the program from the image written by --snapshot (by the call of main)" << std::endl;
+    std::cerr << "    --batch=<jobs file> - run the program with every input of the jobs file (\"<input file> [<output file>]\" per line,"
+              << " default output file <input file>.out) on the workers and print the status of every job" << std::endl;
+    std::cerr << "    --workers=<count> - number of the worker threads of --batch (default number of the hardware threads)" << std::endl;
+    std::cerr << "    --connect=<socket> - run the program on the server (yadc-vm --serve), --fuel, --time-limit=<ms>, --stack and --heap"
+              << " are requested from the server" << std::endl;
+    std::cerr << "Program input is read from stdin, program output is written to stdout" << std::endl;
+    std::cerr << "Server runs the programs sent to the Unix socket on the workers (default number of the hardware threads)" << std::endl;
+    std::cerr << "with the limits of every job (default " << DEFAULT_JOB_FUEL << " instructions, " << DEFAULT_JOB_TIME_LIMIT << " ms, "
+              << DEFAULT_JOB_OUTPUT_LIMIT << " bytes of output), SIGINT or SIGTERM stops it" << std::endl;
+}
+
+/**
+ * Prints allocation and fragmentation statistics of the heap to stderr
+ * @param statistics Statistics of the heap
+ */
+void print_heap_statistics(const HeapStatistics &statistics) {
+    auto free_cells = statistics.small_free_cells + statistics.large_free_cells;
+    auto fragmentation = statistics.heap_cells == 0 ? 0.0 : 100.0 * static_cast<double>(free_cells) / static_cast<double>(statistics.heap_cells);
+    std::cerr << "Heap allocations: " << statistics.allocations << " (" << statistics.small_allocations << " from size classes), frees: "
+              << statistics.frees << std::endl;
+    std::cerr << "Heap live blocks: " << statistics.live_blocks << ", live cells: " << statistics.live_cells
+              << ", peak live cells: " << statistics.peak_live_cells << std::endl;
+    std::cerr << "Heap size: " << statistics.heap_cells << " cells, free in size classes: " << statistics.small_free_cells
+              << ", free large: " << statistics.large_free_cells << ", unused arena: " << statistics.arena_cells << std::endl;
+    std::cerr << "Heap fragmentation: " << fragmentation << " % free, " << statistics.internal_fragmentation
+              << " cells lost by rounding to size classes" << std::endl;
+    if (statistics.collections > 0)
+        std::cerr << "Heap collections: " << statistics.collections << ", reclaimed blocks: " << statistics.reclaimed_blocks
+                  << " (" << statistics.reclaimed_cells << " cells)" << std::endl;
+}
+
+/**
+ * Parses numeric value of the option in form --name=value
+ * @param argument Command line argument
+ * @param prefix Option prefix (including '=')
+ * @param value Parsed value
+ * @return True if the argument is the option and the value is valid; False otherwise
+ */
+bool parse_size_option(const char *argument, const char *prefix, std::size_t &value) {
+    if (std::strncmp(argument, prefix, std::strlen(prefix)) != 0)
+        return false;
+    try {
+        value = std::stoull(argument + std::strlen(prefix));
+    } catch (const std::exception &) {
+        return false;
+    }
+    return value > 0;
+}
+
+/**
+ * Parses string value of the option in form --name=value
+ * @param argument Command line argument
+ * @param prefix Option prefix (including '=')
+ * @param value Parsed value
+ * @return True if the argument is the option and the value is not empty; False otherwise
+ */
+bool parse_string_option(const char *argument, const char *prefix, std::string &value) {
+    if (std::strncmp(argument, prefix, std::strlen(prefix)) != 0 || argument[std::strlen(prefix)] == '\0')
+        return false;
+    value = argument + std::strlen(prefix);
+    return true;
+}
+
+/**
+ * Reads whole stream
+ * @param input Input stream
+ * @return Content of the stream
+ */
+std::string read_all(std::istream &input) {
+    std::stringstream content;
+    content << input.rdbuf();
+    return content.str();
+}
+
+/**
+ * Stops the server (handler of SIGINT and SIGTERM)
+ */
+void stop_server(int) {
+    if (active_server != nullptr)
+        active_server->stop();
+}
+
+/**
+ * Runs the execution server until SIGINT or SIGTERM
+ * @param argc Argument count
+ * @param argv Argument values (the first option is --serve=<socket>)
+ * @return EXIT_SUCCESS if the server stopped, EXIT_FAILURE otherwise
+ */
+int serve(int argc, char **argv) {
+    auto socket_path = std::string();
+    auto workers = static_cast<std::size_t>(std::max(1u, std::thread::hardware_concurrency()));
+    std::size_t fuel = DEFAULT_JOB_FUEL, time_limit = DEFAULT_JOB_TIME_LIMIT, output_limit = DEFAULT_JOB_OUTPUT_LIMIT;
+    auto stack_size = DEFAULT_STACK_SIZE;
+    auto heap_size = DEFAULT_HEAP_SIZE;
+    auto valid = parse_string_option(argv[1], "--serve=", socket_path);
+    for (auto i = 2; valid && i < argc; i++) {
+        valid = parse_size_option(argv[i], "--workers=", workers) || parse_size_option(argv[i], "--fuel=", fuel)
+                || parse_size_option(argv[i], "--time-limit=", time_limit) || parse_size_option(argv[i], "--stack=", stack_size)
+                || parse_size_option(argv[i], "--heap=", heap_size) || parse_size_option(argv[i], "--output-limit=", output_limit);
+    }
+    if (!valid) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    auto server = ExecutionServer(socket_path, static_cast<unsigned>(workers), JobLimits{fuel, time_limit, stack_size, heap_size, output_limit});
+    active_server = &server;
+    std::signal(SIGINT, stop_server);
+    std::signal(SIGTERM, stop_server);
+    try {
+        std::cerr << "Serving on \"" << socket_path << "\" with " << workers << " workers" << std::endl;
+        server.run();
+    } catch (const std::runtime_error &error) {
+        std::cerr << "Server error: " << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    active_server = nullptr;
+    std::cerr << "Server stopped after " << server.get_finished_jobs() << " jobs" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Runs the program on the execution server, its output is written to stdout
+ * @param socket_path Path of the Unix socket of the server
+ * @param file_name Instructions file
+ * @param limits Requested limits of the job (zero for the limits of the server)
+ * @param print_stats True if the statistics of the job are printed to stderr; False otherwise
+ * @return EXIT_SUCCESS if the program finished successfully, EXIT_FAILURE otherwise
+ */
+int run_remote(const std::string &socket_path, const std::string &file_name, const JobLimits &limits, bool print_stats) {
+    JobResult result;
+    try {
+        auto file = std::ifstream(file_name);
+        if (!file)
+            throw std::runtime_error("cannot open file \"" + file_name + "\"");
+        result = submit_job(socket_path, read_all(file), read_all(std::cin), limits);
+    } catch (const std::runtime_error &error) {
+        std::cerr << "Load error: " << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << result.output << std::flush;
+    if (print_stats) {
+        std::cerr << std::endl << "Status: " << result.status << std::endl;
+        std::cerr << "Executed instructions: " << result.instructions << std::endl;
+        std::cerr << "Run time: " << static_cast<double>(result.run_time) / 1000.0 << " ms" << std::endl;
+        std::cerr << "Heap peak live cells: " << result.heap_peak_cells << std::endl;
+    }
+    if (result.output_truncated)
+        std::cerr << "Warning: output was truncated by the server" << std::endl;
+    if (result.status == "OK")
+        return EXIT_SUCCESS;
+    std::cerr << (result.status == "LOAD_ERROR" || result.status == "BAD_REQUEST" ? "Load error: " : "Runtime error: ") << result.message
+              << " (" << result.status << ")" << std::endl;
+    return EXIT_FAILURE;
+}
+
+/**
+ * Runs the global code of the program until it calls main and writes the snapshot image
+ * @tparam Cell Type of the cell of the virtual machine (the image can be resumed only with the same cells)
+ * @param file_name Instructions file
+ * @param image_name Image file name
+ * @param stack_size Size of the stack (in cells)
+ * @param heap_size Maximum size of the heap (in cells)
+ * @param dispatch_mode Dispatch mode of the interpreter loop
+ * @param print_stats True if the statistics of the global code are printed to stderr; False otherwise
+ * @return EXIT_SUCCESS if the image was written, EXIT_FAILURE otherwise
+ */
+template<typename Cell>
+int take_snapshot(const std::string &file_name, const std::string &image_name, std::size_t stack_size, std::size_t heap_size,
+                  DispatchMode dispatch_mode, bool print_stats) {
+    try {
+        auto program = Program::load(file_name);
+        /* Output of the global code is kept in the image, the input must not be read before main */
+        auto output = std::string();
+        auto virtual_machine = BasicVirtualMachine<Cell>(program, InputBuffer(), OutputBuffer(output), stack_size, heap_size);
+        auto start = std::chrono::steady_clock::now();
+        virtual_machine.run_to_main(dispatch_mode);
+        virtual_machine.save_snapshot(image_name, output);
+        auto end = std::chrono::steady_clock::now();
+
+        if (print_stats) {
+            auto elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+            std::cerr << "Executed instructions: " << virtual_machine.get_instruction_counter() << std::endl;
+            std::cerr << "Snapshot time: " << elapsed << " ms" << std::endl;
+            print_heap_statistics(virtual_machine.get_heap_statistics());
+        }
+    } catch (const RuntimeError &error) {
+        std::cerr << "Runtime error: " << error.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::runtime_error &error) {
+        std::cerr << "Load error: " << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Runs the program with every input of the jobs file on the workers, the program is loaded and verified once
+ * @param file_name Instructions file
+ * @param jobs_file Jobs file
+ * @param functions_file Functions file (empty if the builtin functions are not run natively)
+ * @param settings Settings of the virtual machines
+ * @param workers Number of the worker threads
+ * @return EXIT_SUCCESS if every job finished, EXIT_FAILURE otherwise
+ */
+int batch(const std::string &file_name, const std::string &jobs_file, const std::string &functions_file, const BatchSettings &settings,
+          std::size_t workers) {
+    std::vector<BatchJob> jobs;
+    try {
+        auto program = Program::load(file_name);
+        if (!functions_file.empty()) {
+            auto functions = std::ifstream(functions_file);
+            if (!functions)
+                throw std::runtime_error("cannot open file \"" + functions_file + "\"");
+            program.set_builtin_entries(parse_builtin_entries(functions));
+        }
+        auto jobs_input = std::ifstream(jobs_file);
+        if (!jobs_input)
+            throw std::runtime_error("cannot open file \"" + jobs_file + "\"");
+        jobs = parse_batch_jobs(jobs_input);
+
+        auto start = std::chrono::steady_clock::now();
+        run_batch(program, jobs, settings, static_cast<unsigned>(workers));
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        auto failed = 0;
+        for (const auto &job: jobs) {
+            if (job.status != "OK")
+                failed++;
+            std::cout << job.input_file << ": " << job.status << ", " << job.instructions << " instructions, " << job.run_time << " ms"
+                      << (job.message.empty() ? "" : ", " + job.message) << std::endl;
+        }
+        std::cout << jobs.size() - failed << " finished, " << failed << " failed, " << elapsed << " ms on "
+                  << std::max<std::size_t>(1, std::min(workers, jobs.size())) << " workers" << std::endl;
+        return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (const std::runtime_error &error) {
+        std::cerr << "Load error: " << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
+
+/**
+ * Main function of the virtual machine
+ * @param argc Argument count
+ * @param argv Argument values
+ * @return EXIT_SUCCESS if program finished successfully, EXIT_FAILURE otherwise
+ */
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (std::strncmp(argv[1], "--serve=", std::strlen("--serve=")) == 0)
+        return serve(argc, argv);
+
+    auto stack_size = DEFAULT_STACK_SIZE;
+    auto heap_size = DEFAULT_HEAP_SIZE;
+    auto cells = std::size_t(64);
+    auto dispatch_mode = DEFAULT_DISPATCH_MODE;
+    auto superinstructions = true;
+    auto intrinsics = true;
+    auto checked = false;
+    auto display = true;
+    auto print_stats = false;
+    auto collection = false;
+    auto profile_file = std::string();
+    auto heap_profile_file = std::string();
+    auto functions_file = std::string();
+    auto jit_threshold = std::size_t(0);
+    auto fuel = std::size_t(0);
+    auto time_limit = std::size_t(0);
+    auto connect_socket = std::string();
+    auto snapshot_file = std::string();
+    auto resume_file = std::string();
+    auto batch_file = std::string();
+    auto workers = std::size_t(0);
+    for (auto i = 2; i < argc; i++) {
+        if (parse_size_option(argv[i], "--stack=", stack_size) || parse_size_option(argv[i], "--heap=", heap_size)
+            || parse_size_option(argv[i], "--cells=", cells))
+            continue;
+        if (parse_size_option(argv[i], "--fuel=", fuel) || parse_size_option(argv[i], "--time-limit=", time_limit)
+            || parse_string_option(argv[i], "--connect=", connect_socket))
+            continue;
+        if (std::string(argv[i]) == "--dispatch=switch") {
+            dispatch_mode = DISPATCH_SWITCH;
+            continue;
+        }
+        if (std::string(argv[i]) == "--dispatch=threaded") {
+            dispatch_mode = DISPATCH_THREADED;
+            continue;
+        }
+        if (std::string(argv[i]) == "--no-superinstructions") {
+            superinstructions = false;
+            continue;
+        }
+        if (std::string(argv[i]) == "--no-intrinsics") {
+            intrinsics = false;
+            continue;
+        }
+        if (std::string(argv[i]) == "--checked") {
+            checked = true;
+            continue;
+        }
+        if (std::string(argv[i]) == "--no-display") {
+            display = false;
+            continue;
+        }
+        if (std::string(argv[i]) == "--dispatch=register") {
+            dispatch_mode = DISPATCH_REGISTER;
+            continue;
+        }
+        if (std::string(argv[i]) == "--jit") {
+            jit_threshold = DEFAULT_JIT_THRESHOLD;
+            continue;
+        }
+        if (parse_size_option(argv[i], "--jit=", jit_threshold))
+            continue;
+        if (parse_string_option(argv[i], "--profile=", profile_file) || parse_string_option(argv[i], "--heap-profile=", heap_profile_file)
+            || parse_string_option(argv[i], "--functions=", functions_file))
+            continue;
+        if (parse_string_option(argv[i], "--snapshot=", snapshot_file) || parse_string_option(argv[i], "--resume=", resume_file))
+            continue;
+        if (parse_string_option(argv[i], "--batch=", batch_file) || parse_size_option(argv[i], "--workers=", workers))
+            continue;
+        if (std::string(argv[i]) == "--gc") {
+            collection = true;
+            continue;
+        }
+        if (std::string(argv[i]) == "--stats") {
+            print_stats = true;
+            continue;
+        }
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Wall-clock limit is kept by the server, the snapshot images and the 32-bit cells are local */
+    if ((time_limit > 0 && connect_socket.empty()) || (!connect_socket.empty() && (!snapshot_file.empty() || !resume_file.empty() || cells != 64))
+        || (cells != 32 && cells != 64)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    /* Batch runs every job on the interpreter with the same settings, the output goes to the files of the jobs */
+    auto batch_mode = !batch_file.empty();
+    if ((workers > 0 && !batch_mode) || (batch_mode && (!connect_socket.empty() || !snapshot_file.empty() || !resume_file.empty()
+                                                        || jit_threshold > 0 || !profile_file.empty() || !heap_profile_file.empty() || cells != 64))) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (batch_mode) {
+        auto settings = BatchSettings{stack_size, heap_size, fuel, dispatch_mode, superinstructions, checked, collection};
+        if (workers == 0)
+            workers = std::max(1u, std::thread::hardware_concurrency());
+        return batch(argv[1], batch_file, intrinsics ? functions_file : std::string(), settings, workers);
+    }
+    if (!connect_socket.empty()) {
+        /* Sizes are requested only if given, otherwise the server uses its own */
+        auto limits = JobLimits{fuel, time_limit, stack_size == DEFAULT_STACK_SIZE ? 0 : stack_size, heap_size == DEFAULT_HEAP_SIZE ? 0 : heap_size, 0};
+        return run_remote(connect_socket, argv[1], limits, print_stats);
+    }
+    if (!snapshot_file.empty()) {
+        if (cells == 32)
+            return take_snapshot<compact_cell_t>(argv[1], snapshot_file, stack_size, heap_size, dispatch_mode, print_stats);
+        return take_snapshot<cell_t>(argv[1], snapshot_file, stack_size, heap_size, dispatch_mode, print_stats);
+    }
+
+    try {
+        /* Instructions are decoded once, before the execution */
+        auto program = Program::load(argv[1]);
+        if (!functions_file.empty() && intrinsics) {
+            auto functions = std::ifstream(functions_file);
+            if (!functions)
+                throw std::runtime_error("cannot open file \"" + functions_file + "\"");
+            program.set_builtin_entries(parse_builtin_entries(functions));
+        }
+        /* Interpreter loops are compiled for both cell types, the cell type is chosen by the option */
+        auto run = [&](auto cell) {
+            using Cell = decltype(cell);
+            auto virtual_machine = BasicVirtualMachine<Cell>(program, InputBuffer(STDIN_FILENO), OutputBuffer(STDOUT_FILENO), stack_size,
+                                                             heap_size, superinstructions);
+            if (collection)
+                virtual_machine.enable_collection();
+            if (checked)
+                virtual_machine.enable_checks();
+            if (!display)
+                virtual_machine.disable_display();
+            if (fuel > 0)
+                virtual_machine.set_instruction_limit(fuel);
+            auto profiled = !profile_file.empty() || !heap_profile_file.empty();
+            if (jit_threshold > 0 && (dispatch_mode == DISPATCH_REGISTER || profiled || fuel > 0 || !virtual_machine.enable_jit(jit_threshold)))
+                std::cerr << "Warning: JIT compiler is not available"
+                          << (dispatch_mode == DISPATCH_REGISTER ? " with the register dispatch" : profiled ? " with the profiler"
+                              : fuel > 0 ? " with the instruction limit" : cells == 32 ? " with the 32-bit cells" : "")
+                          << ", the program is interpreted" << std::endl;
+
+            Profiler *profiler = nullptr;
+            HeapProfiler *heap_profiler = nullptr;
+            if (profiled) {
+                profiler = &virtual_machine.enable_profiler();
+                if (!functions_file.empty()) {
+                    auto functions = std::ifstream(functions_file);
+                    if (!functions)
+                        throw std::runtime_error("cannot open file \"" + functions_file + "\"");
+                    profiler->load_function_names(functions);
+                }
+                if (!heap_profile_file.empty())
+                    heap_profiler = &virtual_machine.enable_heap_profiler();
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            if (!resume_file.empty())
+                virtual_machine.restore_snapshot(resume_file);
+            virtual_machine.run(dispatch_mode);
+            auto end = std::chrono::steady_clock::now();
+
+            if (print_stats) {
+                auto elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+                std::cerr << std::endl << "Executed instructions: " << virtual_machine.get_instruction_counter() << std::endl;
+                std::cerr << "Dispatches: " << virtual_machine.get_dispatch_counter() << std::endl;
+                if (jit_threshold > 0)
+                    std::cerr << "Compiled functions: " << virtual_machine.get_compiled_functions() << std::endl;
+                const auto &verification = program.get_verification();
+                std::cerr << "Verified: " << (verification.verified ? "yes" : "no (" + verification.error + ")")
+                          << (virtual_machine.is_unchecked() ? ", unchecked interpreter loop" : "") << std::endl;
+                std::cerr << "Run time: " << elapsed << " ms" << std::endl;
+                print_heap_statistics(virtual_machine.get_heap_statistics());
+            }
+
+            if (!profile_file.empty()) {
+                auto profile = std::ofstream(profile_file);
+                if (!profile)
+                    throw std::runtime_error("cannot open file \"" + profile_file + "\"");
+                profiler->write_folded_stacks(profile);
+                profiler->write_report(std::cerr);
+            }
+            if (heap_profiler != nullptr) {
+                auto heap_profile = std::ofstream(heap_profile_file);
+                if (!heap_profile)
+                    throw std::runtime_error("cannot open file \"" + heap_profile_file + "\"");
+                heap_profiler->write_json(heap_profile, *profiler);
+                heap_profiler->write_report(std::cerr, *profiler);
+            }
+        };
+        if (cells == 32)
+            run(compact_cell_t());
+        else
+            run(cell_t());
+    } catch (const RuntimeError &error) {
+        /* Output of the program was already flushed by the destructor of the virtual machine */
+        std::cerr << "Runtime error: " << error.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::runtime_error &error) {
+        std::cerr << "Load error: " << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
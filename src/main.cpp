@@ -1,7 +1,12 @@
 #include "analysis/SyntaxAnalyzer.h"
 #include "synthesis/SemanticAnalyzer.h"
 #include "synthesis/InstructionsGenerator.h"
+#include "synthesis/CGenerator.h"
+#include "synthesis/AsmGenerator.h"
 #include "synthesis/Optimizer.h"
+#include "execution/Intrinsics.h"
+#include "execution/Program.h"
+#include "execution/VirtualMachine.h"
 
 /**
  * Prints usage of the program to stderr
@@ -9,11 +14,42 @@
  */
 void print_usage(const char *program_name) {
     std::cerr << "Usage: " << program_name << " <input file>" << std::endl;
-    std::cerr << "Usage: " << program_name << " <input file> -o=<optimizations flag>" << std::endl;
+    std::cerr << "Usage: " << program_name << " <input file> -o=<optimizations flag> --emit=<output>" << std::endl;
+    std::cerr << "Usage: " << program_name << " run <input file> [-o=<optimizations flag>]" << std::endl;
     std::cerr << "Optimizations flags:" << std::endl;
     std::cerr << "    0 - no optimizations" << std::endl;
     std::cerr << "    1 - optimizations" << std::endl;
     std::cerr << "Default optimizations flag is 1" << std::endl;
+    std::cerr << "Outputs:" << std::endl;
+    std::cerr << "    pl0 - PL/0 instructions (instructions.txt) and entry addresses of the functions (functions.txt)" << std::endl;
+    std::cerr << "    c   - C source linked with the runtime (program.c)" << std::endl;
+    std::cerr << "    asm - x86-64 assembly linked with the runtime (program.s)" << std::endl;
+    std::cerr << "Default output is pl0" << std::endl;
+    std::cerr << "Run compiles the program and runs it in the virtual machine of the same process (no file is written)," << std::endl;
+    std::cerr << "program input is read from stdin, program output is written to stdout" << std::endl;
+}
+
+/**
+ * Runs the generated instructions in the virtual machine (yadc run), the instructions are handed over in memory
+ * @param instructions Generated instructions
+ * @param function_entries Entry addresses and names of the functions, the builtin functions run natively
+ * @return EXIT_SUCCESS if program finished successfully, EXIT_FAILURE otherwise
+ */
+int run_instructions(const std::vector<Instruction> &instructions, const std::map<uint32_t, std::string> &function_entries) {
+    try {
+        auto program = Program::from_instructions(instructions);
+        program.set_builtin_entries(find_builtin_entries(function_entries));
+        auto virtual_machine = VirtualMachine(program, InputBuffer(STDIN_FILENO), OutputBuffer(STDOUT_FILENO));
+        virtual_machine.run();
+    } catch (const RuntimeError &error) {
+        /* Output of the program was already flushed by the destructor of the virtual machine */
+        std::cerr << "Runtime error: " << error.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::runtime_error &error) {
+        std::cerr << "Load error: " << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
 }
 
 /**
@@ -23,49 +59,103 @@ void print_usage(const char *program_name) {
  * @return EXIT_SUCCESS if program finished successfully, EXIT_FAILURE otherwise
  */
 int main(int argc, char **argv) {
+    /* Run mode compiles the program and runs it, stdout is left to the program */
+    auto run = argc >= 2 && std::string(argv[1]) == "run";
+    auto input_index = run ? 2 : 1;
     /* Check if at least the input file is provided */
-    if (argc != 2 && argc != 3) {
+    if (argc < input_index + 1 || argc > input_index + (run ? 2 : 3)) {
         print_usage(argv[0]);
         return EXIT_FAILURE;
     }
 
     auto optimizations_enabled = true;
-    /* Check if optimizations flag is provided */
-    if (argc == 3) {
-        if (std::string(argv[2]) == "-o=0" || std::string(argv[1]) == "-o=0") {
-            std::cout << "Optimizations disabled" << std::endl;
+    auto emit_c = false;
+    auto emit_asm = false;
+    /* Check if optimizations flag or output is provided */
+    for (auto i = input_index + 1; i < argc; i++) {
+        if (std::string(argv[i]) == "-o=0") {
+            if (!run)
+                std::cout << "Optimizations disabled" << std::endl;
             optimizations_enabled = false;
-        } else if (std::string(argv[2]) == "-o=1" || std::string(argv[1]) == "-o=1") {
-            std::cout << "Optimizations enabled" << std::endl;
-        } else {
+        } else if (std::string(argv[i]) == "-o=1") {
+            if (!run)
+                std::cout << "Optimizations enabled" << std::endl;
+        } else if (run) {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        } else if (std::string(argv[i]) == "--emit=c") {
+            emit_c = true;
+        } else if (std::string(argv[i]) == "--emit=asm") {
+            emit_asm = true;
+        } else if (std::string(argv[i]) != "--emit=pl0") {
             print_usage(argv[0]);
             return EXIT_FAILURE;
         }
     }
 
-    /* Syntax analysis */
-    auto syntax_analyzer = SyntaxAnalyzer(argv[1]);
-    auto program_global_block = syntax_analyzer.analyze();
+    ASTNodeBlock *program_global_block;
+    std::vector<std::string> used_builtin_functions;
+    try {
+        /* Syntax analysis */
+        auto syntax_analyzer = SyntaxAnalyzer(argv[input_index]);
+        program_global_block = syntax_analyzer.analyze().global_block;
 
-    /* Semantic analysis */
-    auto semantic_analyzer = SemanticAnalyzer(program_global_block);
-    semantic_analyzer.analyze();
-    /* Used builtin functions are needed for instructions generation */
-    auto used_builtin_functions = semantic_analyzer.get_used_builtin_functions();
+        /* Semantic analysis */
+        auto semantic_analyzer = SemanticAnalyzer(program_global_block);
+        semantic_analyzer.analyze();
+        /* Used builtin functions are needed for instructions generation */
+        used_builtin_functions = semantic_analyzer.get_used_builtin_functions();
+    } catch (const CompileError &error) {
+        std::cerr << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
 
     /* Optimizations on the AST */
     auto optimizer = Optimizer();
     if (optimizations_enabled)
         optimizer.optimize_ast(program_global_block);
 
+    /* C generation, the output is compiled by a C compiler together with the runtime */
+    if (emit_c) {
+        auto c_generator = CGenerator(program_global_block);
+        c_generator.generate();
+
+        /* Output C source to file (and stdout for debugging) */
+        auto c_file = std::ofstream("program.c");
+        std::cout << c_generator.get_code();
+        c_file << c_generator.get_code();
+        c_file.close();
+
+        return EXIT_SUCCESS;
+    }
+
+    /* Assembly generation, the output is assembled together with the runtime */
+    if (emit_asm) {
+        auto asm_generator = AsmGenerator(program_global_block);
+        asm_generator.generate();
+
+        /* Output assembly to file (and stdout for debugging) */
+        auto asm_file = std::ofstream("program.s");
+        std::cout << asm_generator.get_code();
+        asm_file << asm_generator.get_code();
+        asm_file.close();
+
+        return EXIT_SUCCESS;
+    }
+
     /* Instructions generation */
     auto instructions_generator = InstructionsGenerator(program_global_block, used_builtin_functions);
     instructions_generator.generate();
     auto instructions = instructions_generator.get_instructions();
+    auto function_entries = instructions_generator.get_function_entries();
 
     /* Optimizations on the instructions */
     if (optimizations_enabled)
-        optimizer.optimize_instructions(instructions);
+        optimizer.optimize_instructions(instructions, function_entries);
+
+    /* Instructions are handed over to the virtual machine without the text format */
+    if (run)
+        return run_instructions(instructions, function_entries);
 
     /* Output instructions to file (and stdout for debugging) */
     auto instructions_file = std::ofstream("instructions.txt");
@@ -75,5 +165,11 @@ int main(int argc, char **argv) {
     }
     instructions_file.close();
 
+    /* Output entry addresses of the functions (used by the profiler of the virtual machine and to run the builtin functions natively) */
+    auto functions_file = std::ofstream("functions.txt");
+    for (auto &[address, name]: function_entries)
+        functions_file << address << " " << name << std::endl;
+    functions_file.close();
+
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,331 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "yadc_runtime.h"
+
+/**
+ * Free block of the heap
+ */
+typedef struct yadc_free_block {
+    /** Address of the block (of its header cell) */
+    yadc_cell address;
+    /** Size of the block including the header cell */
+    yadc_cell size;
+} yadc_free_block;
+
+yadc_cell *yadc_heap = NULL;
+size_t yadc_heap_length = 0;
+
+/** Number of cells allocated for the heap memory */
+static size_t heap_capacity = 0;
+/** Sizes of the allocated blocks including the header cell, indexed by the address returned by yadc_new (0 = not allocated) */
+static yadc_cell *allocated_sizes = NULL;
+/** Free blocks ordered by the address */
+static yadc_free_block *free_blocks = NULL;
+/** Number of the free blocks */
+static size_t free_blocks_count = 0;
+/** Capacity of the array of the free blocks */
+static size_t free_blocks_capacity = 0;
+
+_Noreturn void yadc_error(const char *message) {
+    fflush(stdout);
+    fprintf(stderr, "Runtime error: %s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+_Noreturn void yadc_heap_error(yadc_cell address) {
+    char message[64];
+    snprintf(message, sizeof(message), "heap address %lld out of range", (long long) address);
+    yadc_error(message);
+}
+
+int yadc_finish(void) {
+    fflush(stdout);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Reads one character of the input (instruction REA), end of input behaves as the input terminator (ASCII 10)
+ * @return Character
+ */
+static yadc_cell read_character(void) {
+    int character = getchar();
+    return character == EOF ? '\n' : character;
+}
+
+/**
+ * Writes one character to the output (instruction WRI)
+ * @param character Character
+ */
+static void write_character(yadc_cell character) {
+    putchar((unsigned char) (char) character);
+}
+
+/**
+ * Makes sure the heap memory can hold the given number of cells
+ * @param length Number of cells
+ */
+static void reserve_heap(size_t length) {
+    if (length <= heap_capacity)
+        return;
+
+    size_t capacity = heap_capacity == 0 ? 1024 : heap_capacity;
+    while (capacity < length)
+        capacity *= 2;
+    if (capacity > YADC_HEAP_SIZE)
+        capacity = YADC_HEAP_SIZE;
+
+    yadc_cell *memory = realloc(yadc_heap, capacity * sizeof(yadc_cell));
+    yadc_cell *sizes = realloc(allocated_sizes, capacity * sizeof(yadc_cell));
+    if (memory == NULL || sizes == NULL)
+        yadc_error("out of heap memory");
+    memset(memory + heap_capacity, 0, (capacity - heap_capacity) * sizeof(yadc_cell));
+    memset(sizes + heap_capacity, 0, (capacity - heap_capacity) * sizeof(yadc_cell));
+    yadc_heap = memory;
+    allocated_sizes = sizes;
+    heap_capacity = capacity;
+}
+
+/**
+ * Finds the first free block with the address greater or equal to the given one
+ * @param address Address
+ * @return Index of the free block (free_blocks_count if there is none)
+ */
+static size_t lower_bound_free_block(yadc_cell address) {
+    size_t low = 0;
+    size_t high = free_blocks_count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (free_blocks[middle].address < address)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+/**
+ * Inserts a free block at the given index
+ * @param index Index of the free block
+ * @param address Address of the block
+ * @param size Size of the block
+ */
+static void insert_free_block(size_t index, yadc_cell address, yadc_cell size) {
+    if (free_blocks_count == free_blocks_capacity) {
+        size_t capacity = free_blocks_capacity == 0 ? 64 : free_blocks_capacity * 2;
+        yadc_free_block *blocks = realloc(free_blocks, capacity * sizeof(yadc_free_block));
+        if (blocks == NULL)
+            yadc_error("out of heap memory");
+        free_blocks = blocks;
+        free_blocks_capacity = capacity;
+    }
+    memmove(free_blocks + index + 1, free_blocks + index, (free_blocks_count - index) * sizeof(yadc_free_block));
+    free_blocks[index].address = address;
+    free_blocks[index].size = size;
+    free_blocks_count++;
+}
+
+/**
+ * Removes the free block at the given index
+ * @param index Index of the free block
+ */
+static void remove_free_block(size_t index) {
+    memmove(free_blocks + index, free_blocks + index + 1, (free_blocks_count - index - 1) * sizeof(yadc_free_block));
+    free_blocks_count--;
+}
+
+yadc_cell yadc_new(yadc_cell size) {
+    if (size < 0)
+        yadc_error("cannot allocate negative number of cells");
+    yadc_cell block_size = size + 1; /* One more cell for the header */
+
+    /* First fit */
+    for (size_t i = 0; i < free_blocks_count; i++) {
+        yadc_free_block block = free_blocks[i];
+        if (block.size < block_size)
+            continue;
+        if (block.size > block_size) {
+            free_blocks[i].address += block_size;
+            free_blocks[i].size -= block_size;
+        } else {
+            remove_free_block(i);
+        }
+        yadc_heap[block.address] = size;
+        allocated_sizes[block.address + 1] = block_size;
+        return block.address + 1;
+    }
+
+    /* No free block is big enough, grow the heap */
+    yadc_cell block_address = (yadc_cell) yadc_heap_length;
+    if (yadc_heap_length + (size_t) block_size > YADC_HEAP_SIZE)
+        yadc_error("out of heap memory");
+    /* One more cell, so that the address of an empty block at the end of the heap can be marked as allocated */
+    reserve_heap(yadc_heap_length + (size_t) block_size + 1);
+    yadc_heap_length += (size_t) block_size;
+    yadc_heap[block_address] = size;
+    allocated_sizes[block_address + 1] = block_size;
+    return block_address + 1;
+}
+
+void yadc_delete(yadc_cell address) {
+    if (address < 1 || (size_t) address > yadc_heap_length || allocated_sizes[address] == 0) {
+        char message[80];
+        snprintf(message, sizeof(message), "cannot delete heap address %lld (not allocated)", (long long) address);
+        yadc_error(message);
+    }
+    yadc_cell block_address = address - 1;
+    yadc_cell block_size = allocated_sizes[address];
+    allocated_sizes[address] = 0;
+
+    /* Coalesce with the following free block */
+    size_t index = lower_bound_free_block(block_address);
+    if (index < free_blocks_count && free_blocks[index].address == block_address + block_size) {
+        block_size += free_blocks[index].size;
+        remove_free_block(index);
+    }
+    /* Coalesce with the preceding free block */
+    if (index > 0 && free_blocks[index - 1].address + free_blocks[index - 1].size == block_address) {
+        free_blocks[index - 1].size += block_size;
+        return;
+    }
+    insert_free_block(index, block_address, block_size);
+}
+
+yadc_cell yadc_string(const char *characters, yadc_cell length) {
+    yadc_cell string = yadc_new(length);
+    yadc_sta(string - 1, length);
+    for (yadc_cell i = 0; i < length; i++)
+        yadc_heap[string + i] = (signed char) characters[i];
+    return string;
+}
+
+yadc_float yadc_float_operation(yadc_cell operation, yadc_float left, yadc_float right) {
+    switch (operation) {
+        case YADC_OPERATION_ADD:
+            return yadc_float_add(left, right);
+        case YADC_OPERATION_SUB:
+            return yadc_float_sub(left, right);
+        case YADC_OPERATION_MUL:
+            return yadc_float_mul(left, right);
+        case YADC_OPERATION_DIV:
+            return yadc_float_div(left, right);
+        case YADC_OPERATION_MOD:
+            return yadc_float_mod(left, right);
+        default:
+            yadc_error("unknown float operation");
+    }
+}
+
+yadc_cell yadc_float_comparison(yadc_cell operation, yadc_float left, yadc_float right) {
+    switch (operation) {
+        case YADC_OPERATION_EQ:
+            return yadc_float_eq(left, right);
+        case YADC_OPERATION_NEQ:
+            return yadc_float_neq(left, right);
+        case YADC_OPERATION_LT:
+            return yadc_float_lt(left, right);
+        case YADC_OPERATION_GEQ:
+            return yadc_float_geq(left, right);
+        case YADC_OPERATION_GRT:
+            return yadc_float_grt(left, right);
+        case YADC_OPERATION_LEQ:
+            return yadc_float_leq(left, right);
+        default:
+            yadc_error("unknown float comparison");
+    }
+}
+
+yadc_cell yadc_float_part(yadc_float value, yadc_cell whole_part) {
+    return yadc_rti(value, whole_part != 0);
+}
+
+void yadc_print_int(yadc_cell value) {
+    /* Digits are computed backwards, the same way as the PL/0 builtin does it (including negative numbers) */
+    yadc_cell digits[24];
+    int count = 0;
+    do {
+        digits[count++] = yadc_mod(value, 10);
+        value = yadc_div(value, 10);
+    } while (value != 0);
+
+    while (count > 0)
+        write_character(yadc_add(digits[--count], 48));
+}
+
+yadc_cell yadc_read_int(void) {
+    yadc_cell result = 0;
+    for (yadc_cell character = read_character(); character != 10; character = read_character())
+        result = yadc_add(character - 48, yadc_mul(result, 10));
+    return result;
+}
+
+void yadc_print_str(yadc_cell string) {
+    yadc_cell length = yadc_lda(string - 1);
+    yadc_cell i = 0;
+    do {
+        write_character(yadc_lda(string + i));
+        i++;
+    } while (i != length);
+}
+
+yadc_cell yadc_read_str(void) {
+    char *buffer = NULL;
+    size_t length = 0;
+    size_t capacity = 0;
+    for (yadc_cell character = read_character(); character != 10; character = read_character()) {
+        if (length == capacity) {
+            capacity = capacity == 0 ? 64 : capacity * 2;
+            char *resized = realloc(buffer, capacity);
+            if (resized == NULL)
+                yadc_error("out of memory");
+            buffer = resized;
+        }
+        buffer[length++] = (char) character;
+    }
+
+    yadc_cell string = yadc_string(buffer, (yadc_cell) length);
+    free(buffer);
+    return string;
+}
+
+yadc_cell yadc_strcmp(yadc_cell left, yadc_cell right) {
+    yadc_cell length = yadc_lda(left - 1);
+    if (length != yadc_lda(right - 1))
+        return 0;
+    for (yadc_cell i = 0; i < length; i++) {
+        if (yadc_lda(left + i) != yadc_lda(right + i))
+            return 0;
+    }
+    return 1;
+}
+
+yadc_cell yadc_strcat(yadc_cell left, yadc_cell right) {
+    yadc_cell left_length = yadc_lda(left - 1);
+    yadc_cell right_length = yadc_lda(right - 1);
+    yadc_cell length = yadc_add(left_length, right_length);
+
+    yadc_cell string = yadc_new(length);
+    yadc_sta(string - 1, length);
+    for (yadc_cell i = 0; i < left_length; i++)
+        yadc_sta(string + i, yadc_lda(left + i));
+    for (yadc_cell i = 0; i < right_length; i++)
+        yadc_sta(string + left_length + i, yadc_lda(right + i));
+    return string;
+}
+
+yadc_cell yadc_strlen(yadc_cell string) {
+    return yadc_lda(string - 1);
+}
+
+void yadc_print_float(yadc_float value) {
+    yadc_print_int(yadc_rti(value, 1));
+    write_character('.');
+    yadc_print_int(yadc_rti(value, 0));
+}
+
+yadc_float yadc_read_float(void) {
+    yadc_cell whole_part = 0;
+    for (yadc_cell character = read_character(); character != '.'; character = read_character())
+        whole_part = yadc_add(character - 48, yadc_mul(whole_part, 10));
+    return yadc_itr(whole_part, yadc_read_int());
+}
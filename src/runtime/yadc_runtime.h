@@ -0,0 +1,331 @@
+#ifndef YADC_RUNTIME_H
+#define YADC_RUNTIME_H
+
+/*
+ * Runtime of the YADC programs compiled to C (yadc --emit=c) or to x86-64 assembly (yadc --emit=asm)
+ * Implements the parts of the extended PL/0 machine the generated code cannot express directly:
+ * wrapping integer arithmetic, the 2-cell decimal floats, the heap and the builtin functions
+ * The semantics follow yadc-vm, so the compiled program prints the same output as the interpreted one
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Cell of the stack and the heap */
+typedef int64_t yadc_cell;
+
+/**
+ * Decimal float stored in two cells (mantissa * 10^exponent), same as the float of yadc-vm
+ */
+typedef struct yadc_float {
+    /** Mantissa of the float */
+    yadc_cell mantissa;
+    /** Exponent (power of ten) of the float */
+    yadc_cell exponent;
+} yadc_float;
+
+/** Maximum size of the heap (in cells) */
+#define YADC_HEAP_SIZE ((size_t) 1 << 24)
+/** Maximum number of digits added after the decimal point by the float division */
+#define YADC_FLOAT_DIVISION_PRECISION 9
+
+/** Static link of the frame (frame of the lexically enclosing function), stored in the first cell of the frame */
+#define YADC_LINK(frame) ((yadc_cell *) (intptr_t) (frame)[0])
+
+/** Memory of the heap */
+extern yadc_cell *yadc_heap;
+/** Number of cells of the heap in use (including the free blocks) */
+extern size_t yadc_heap_length;
+
+/**
+ * Prints the runtime error to stderr and exits the program
+ * @param message Message of the error
+ */
+_Noreturn void yadc_error(const char *message);
+/**
+ * Reports access to the heap out of range
+ * @param address Address of the cell
+ */
+_Noreturn void yadc_heap_error(yadc_cell address);
+
+/**
+ * Flushes the output of the program
+ * @return Exit status of the program
+ */
+int yadc_finish(void);
+
+/* Integer arithmetic - the cells wrap around on overflow like in yadc-vm */
+
+static inline yadc_cell yadc_add(yadc_cell left, yadc_cell right) {
+    return (yadc_cell) ((uint64_t) left + (uint64_t) right);
+}
+
+static inline yadc_cell yadc_sub(yadc_cell left, yadc_cell right) {
+    return (yadc_cell) ((uint64_t) left - (uint64_t) right);
+}
+
+static inline yadc_cell yadc_mul(yadc_cell left, yadc_cell right) {
+    return (yadc_cell) ((uint64_t) left * (uint64_t) right);
+}
+
+static inline yadc_cell yadc_div(yadc_cell left, yadc_cell right) {
+    if (right == 0)
+        yadc_error("division by zero");
+    /* Division by -1 would overflow for the minimal value */
+    return right == -1 ? yadc_sub(0, left) : left / right;
+}
+
+static inline yadc_cell yadc_mod(yadc_cell left, yadc_cell right) {
+    if (right == 0)
+        yadc_error("division by zero");
+    return right == -1 ? 0 : left % right;
+}
+
+/* Floats (instructions ITR, RTI and OPF) */
+
+/**
+ * Computes 10^exponent (wrapping, 10^64 and higher wrap to zero)
+ * @param exponent Non-negative exponent
+ * @return 10^exponent
+ */
+static inline yadc_cell yadc_power_of_ten(yadc_cell exponent) {
+    if (exponent >= 64)
+        return 0;
+    yadc_cell result = 1;
+    for (yadc_cell i = 0; i < exponent; i++)
+        result = yadc_mul(result, 10);
+    return result;
+}
+
+static inline yadc_float yadc_float_make(yadc_cell mantissa, yadc_cell exponent) {
+    yadc_float value = {mantissa, exponent};
+    return value;
+}
+
+/**
+ * Creates float from its whole and fractional part (instruction ITR), e.g. 3 and 14 -> 314 * 10^-2
+ * @param whole_part Whole part
+ * @param fractional_part Digits of the fractional part
+ * @return Float
+ */
+static inline yadc_float yadc_itr(yadc_cell whole_part, yadc_cell fractional_part) {
+    if (fractional_part < 0)
+        yadc_error("fractional part of float cannot be negative");
+
+    yadc_cell digits = 0;
+    for (yadc_cell rest = fractional_part; rest > 0; rest /= 10)
+        digits++;
+
+    yadc_cell mantissa = yadc_mul(whole_part, yadc_power_of_ten(digits));
+    mantissa = yadc_add(mantissa, whole_part < 0 ? -fractional_part : fractional_part);
+    return yadc_float_make(mantissa, -digits);
+}
+
+/**
+ * Extracts whole or fractional part of the float (instruction RTI)
+ * @param value Float
+ * @param whole_part Nonzero for the whole part, zero for the digits of the fractional part
+ * @return Whole or fractional part
+ */
+static inline yadc_cell yadc_rti(yadc_float value, int whole_part) {
+    if (value.exponent >= 0)
+        return whole_part ? yadc_mul(value.mantissa, yadc_power_of_ten(value.exponent)) : 0;
+
+    /* 10^19 and higher powers are larger than any mantissa, all digits are fractional */
+    if (value.exponent <= -19)
+        return whole_part ? 0 : (value.mantissa < 0 ? yadc_sub(0, value.mantissa) : value.mantissa);
+    yadc_cell divisor = yadc_power_of_ten(-value.exponent);
+    if (whole_part)
+        return value.mantissa / divisor;
+    yadc_cell fractional_part = value.mantissa % divisor;
+    return fractional_part < 0 ? -fractional_part : fractional_part;
+}
+
+/**
+ * Rescales both operands to the same (lower) exponent
+ * @param left Left operand
+ * @param right Right operand
+ */
+static inline void yadc_float_align(yadc_float *left, yadc_float *right) {
+    if (left->exponent > right->exponent) {
+        left->mantissa = yadc_mul(left->mantissa, yadc_power_of_ten(left->exponent - right->exponent));
+        left->exponent = right->exponent;
+    } else if (right->exponent > left->exponent) {
+        right->mantissa = yadc_mul(right->mantissa, yadc_power_of_ten(right->exponent - left->exponent));
+        right->exponent = left->exponent;
+    }
+}
+
+static inline yadc_float yadc_float_add(yadc_float left, yadc_float right) {
+    yadc_float_align(&left, &right);
+    return yadc_float_make(yadc_add(left.mantissa, right.mantissa), left.exponent);
+}
+
+static inline yadc_float yadc_float_sub(yadc_float left, yadc_float right) {
+    yadc_float_align(&left, &right);
+    return yadc_float_make(yadc_sub(left.mantissa, right.mantissa), left.exponent);
+}
+
+static inline yadc_float yadc_float_mul(yadc_float left, yadc_float right) {
+    return yadc_float_make(yadc_mul(left.mantissa, right.mantissa), left.exponent + right.exponent);
+}
+
+static inline yadc_float yadc_float_div(yadc_float left, yadc_float right) {
+    if (right.mantissa == 0)
+        yadc_error("division by zero");
+    /* Add digits after the decimal point until the division is exact (or precision is exhausted), like the virtual machine
+       a digit which would overflow the mantissa is not added */
+    yadc_cell numerator = left.mantissa;
+    yadc_cell exponent = left.exponent - right.exponent;
+    for (int i = 0; i < YADC_FLOAT_DIVISION_PRECISION && numerator % right.mantissa != 0; i++) {
+        if (numerator > INT64_MAX / 10 || numerator < INT64_MIN / 10)
+            break;
+        numerator = yadc_mul(numerator, 10);
+        exponent--;
+    }
+    return yadc_float_make(numerator / right.mantissa, exponent);
+}
+
+static inline yadc_float yadc_float_mod(yadc_float left, yadc_float right) {
+    if (right.mantissa == 0)
+        yadc_error("division by zero");
+    yadc_float_align(&left, &right);
+    return yadc_float_make(left.mantissa % right.mantissa, left.exponent);
+}
+
+/**
+ * Unary minus of a float - the generated PL/0 code negates the top cell of the float (the exponent),
+ * the compiled code does the same to print the same output
+ * @param value Float
+ * @return Float with the negated exponent
+ */
+static inline yadc_float yadc_float_negate_exponent(yadc_float value) {
+    return yadc_float_make(value.mantissa, yadc_sub(0, value.exponent));
+}
+
+static inline yadc_cell yadc_float_eq(yadc_float left, yadc_float right) {
+    yadc_float_align(&left, &right);
+    return left.mantissa == right.mantissa;
+}
+
+static inline yadc_cell yadc_float_neq(yadc_float left, yadc_float right) {
+    yadc_float_align(&left, &right);
+    return left.mantissa != right.mantissa;
+}
+
+static inline yadc_cell yadc_float_lt(yadc_float left, yadc_float right) {
+    yadc_float_align(&left, &right);
+    return left.mantissa < right.mantissa;
+}
+
+static inline yadc_cell yadc_float_geq(yadc_float left, yadc_float right) {
+    yadc_float_align(&left, &right);
+    return left.mantissa >= right.mantissa;
+}
+
+static inline yadc_cell yadc_float_grt(yadc_float left, yadc_float right) {
+    yadc_float_align(&left, &right);
+    return left.mantissa > right.mantissa;
+}
+
+static inline yadc_cell yadc_float_leq(yadc_float left, yadc_float right) {
+    yadc_float_align(&left, &right);
+    return left.mantissa <= right.mantissa;
+}
+
+/* Heap (instructions NEW, DEL, LDA and STA) */
+
+/**
+ * Allocates a block on the heap, the cell in front of the block holds its size
+ * @param size Number of cells to allocate
+ * @return Address of the first cell of the block
+ */
+yadc_cell yadc_new(yadc_cell size);
+/**
+ * Frees a block previously returned by yadc_new
+ * @param address Address of the block
+ */
+void yadc_delete(yadc_cell address);
+
+/**
+ * Loads a cell from the heap
+ * @param address Address of the cell
+ * @return Value of the cell
+ */
+static inline yadc_cell yadc_lda(yadc_cell address) {
+    if (address < 0 || (size_t) address >= yadc_heap_length)
+        yadc_heap_error(address);
+    return yadc_heap[address];
+}
+
+/**
+ * Stores a value into a cell of the heap
+ * @param address Address of the cell
+ * @param value Value to store
+ */
+static inline void yadc_sta(yadc_cell address, yadc_cell value) {
+    if (address < 0 || (size_t) address >= yadc_heap_length)
+        yadc_heap_error(address);
+    yadc_heap[address] = value;
+}
+
+/**
+ * Allocates a string on the heap (string literal)
+ * @param characters Characters of the string
+ * @param length Length of the string
+ * @return Address of the string
+ */
+yadc_cell yadc_string(const char *characters, yadc_cell length);
+
+/* Out of line operations for the assembly backend (the static inline functions cannot be called from assembly) */
+
+/** Operations of yadc_float_operation and yadc_float_comparison, same as the OPR parameters of the PL/0 code */
+#define YADC_OPERATION_ADD 2
+#define YADC_OPERATION_SUB 3
+#define YADC_OPERATION_MUL 4
+#define YADC_OPERATION_DIV 5
+#define YADC_OPERATION_MOD 6
+#define YADC_OPERATION_EQ 8
+#define YADC_OPERATION_NEQ 9
+#define YADC_OPERATION_LT 10
+#define YADC_OPERATION_GEQ 11
+#define YADC_OPERATION_GRT 12
+#define YADC_OPERATION_LEQ 13
+
+/**
+ * Float arithmetic (instruction OPF)
+ * @param operation Operation (YADC_OPERATION_ADD to YADC_OPERATION_MOD)
+ * @param left Left operand
+ * @param right Right operand
+ * @return Result
+ */
+yadc_float yadc_float_operation(yadc_cell operation, yadc_float left, yadc_float right);
+/**
+ * Float comparison (instruction OPF)
+ * @param operation Operation (YADC_OPERATION_EQ to YADC_OPERATION_LEQ)
+ * @param left Left operand
+ * @param right Right operand
+ * @return 1 if the comparison holds, 0 otherwise
+ */
+yadc_cell yadc_float_comparison(yadc_cell operation, yadc_float left, yadc_float right);
+/**
+ * Extracts whole or fractional part of the float (instruction RTI)
+ * @param value Float
+ * @param whole_part Nonzero for the whole part, zero for the digits of the fractional part
+ * @return Whole or fractional part
+ */
+yadc_cell yadc_float_part(yadc_float value, yadc_cell whole_part);
+
+/* Builtin functions */
+
+void yadc_print_int(yadc_cell value);
+yadc_cell yadc_read_int(void);
+void yadc_print_str(yadc_cell string);
+yadc_cell yadc_read_str(void);
+yadc_cell yadc_strcmp(yadc_cell left, yadc_cell right);
+yadc_cell yadc_strcat(yadc_cell left, yadc_cell right);
+yadc_cell yadc_strlen(yadc_cell string);
+void yadc_print_float(yadc_float value);
+yadc_float yadc_read_float(void);
+
+#endif
@@ -0,0 +1,984 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include "AsmGenerator.h"
+#include "Instructions.h"
+
+/** Runtime functions implementing the builtin functions */
+static const std::map<std::string, std::string> BuiltinFunctionsTable = {
+    {"print_int", "yadc_print_int"},
+    {"read_int", "yadc_read_int"},
+    {"print_str", "yadc_print_str"},
+    {"read_str", "yadc_read_str"},
+    {"strcmp", "yadc_strcmp"},
+    {"strcat", "yadc_strcat"},
+    {"strlen", "yadc_strlen"},
+    {"print_float", "yadc_print_float"},
+    {"read_float", "yadc_read_float"},
+};
+
+/** Registers of the integer arguments of the System V ABI */
+static const char * const ArgumentRegisters[] = {"%rdi", "%rsi", "%rdx", "%rcx", "%r8", "%r9"};
+
+/** Instructions setting %al by the result of the comparison */
+static const std::map<std::string, std::string> ComparisonsTable = {
+    {"==", "sete"},
+    {"!=", "setne"},
+    {"<", "setl"},
+    {">=", "setge"},
+    {">", "setg"},
+    {"<=", "setle"},
+};
+
+/**
+ * Returns kind of the value of the type
+ * @param type Type
+ * @return Kind of the value
+ */
+static AsmValueKind value_kind(ValueType type) {
+    if (type == VOID)
+        return ASM_VOID;
+    return type == FLOAT ? ASM_FLOAT : ASM_CELL;
+}
+
+/**
+ * Returns number of cells of the value of the kind
+ * @param kind Kind of the value
+ * @return Number of cells
+ */
+static uint32_t cells(AsmValueKind kind) {
+    if (kind == ASM_VOID)
+        return 0;
+    return kind == ASM_FLOAT ? 2 : 1;
+}
+
+/**
+ * Returns instruction loading the constant into the register
+ * @param value Constant
+ * @param reg Register
+ * @return Instruction
+ */
+static std::string load_constant(int64_t value, const std::string &reg) {
+    if (value < INT32_MIN || value > INT32_MAX)
+        return "movabsq $" + std::to_string(value) + ", " + reg;
+    return "movq $" + std::to_string(value) + ", " + reg;
+}
+
+/**
+ * Escapes the string for the .ascii directive
+ * @param value String
+ * @return Escaped string
+ */
+static std::string escape(const std::string &value) {
+    std::string escaped;
+    for (unsigned char character : value) {
+        if (character == '"' || character == '\\' || character < 32 || character >= 127) {
+            char octal[5];
+            std::snprintf(octal, sizeof(octal), "\\%03o", character);
+            escaped += octal;
+        } else {
+            escaped += static_cast<char>(character);
+        }
+    }
+    return escaped;
+}
+
+AsmGenerator::AsmGenerator(ASTNodeBlock *global_block) :
+    global_block(global_block), symtab(), functions(), definitions(), contexts(), function_definitions(), strings(),
+    globals_size(0), labels(0), kind(ASM_VOID), code() {
+    /* Empty */
+}
+
+AsmGenerator::~AsmGenerator() = default;
+
+const std::string &AsmGenerator::get_code() const {
+    return this->code;
+}
+
+void AsmGenerator::generate(const std::string &instruction) {
+    this->contexts.back().body += "    " + instruction + "\n";
+}
+
+void AsmGenerator::place_label(const std::string &label) {
+    this->contexts.back().body += label + ":\n";
+}
+
+std::string AsmGenerator::new_label() {
+    return ".L" + std::to_string(++this->labels);
+}
+
+void AsmGenerator::register_label(ASTNodeStatement *node) {
+    /* Labels are local to the function like in C */
+    if (!node->label.empty())
+        this->place_label(".Llabel" + std::to_string(this->contexts.back().function + 1) + "_" + node->label);
+}
+
+AsmValueKind AsmGenerator::evaluate(ASTNodeExpression *node) {
+    node->accept(this);
+    return this->kind;
+}
+
+AsmValueKind AsmGenerator::convert(AsmValueKind from, AsmValueKind to) {
+    if (from == to || from == ASM_VOID || to == ASM_VOID)
+        return from;
+
+    if (to == ASM_FLOAT) {
+        /* ITR of the integer with no fractional digits keeps the integer as the mantissa */
+        this->generate("xorl %edx, %edx");
+    } else {
+        this->generate("movq %rax, %rdi");
+        this->generate("movq %rdx, %rsi");
+        this->generate("movl $1, %edx");
+        this->call("yadc_float_part");
+    }
+    return to;
+}
+
+std::string AsmGenerator::operand(ASTNodeExpression *node) {
+    if (auto int_literal = dynamic_cast<ASTNodeIntLiteral *>(node))
+        return "$" + std::to_string(int_literal->value);
+    if (auto bool_literal = dynamic_cast<ASTNodeBoolLiteral *>(node))
+        return bool_literal->value ? "$1" : "$0";
+    if (auto sizeof_op = dynamic_cast<ASTNodeSizeof *>(node))
+        return "$" + std::to_string(sizeof_val_type(str_to_val_type(sizeof_op->type)));
+    if (auto reference = dynamic_cast<ASTNodeReference *>(node))
+        return "$" + std::to_string(this->symtab.get_symbol(reference->identifier).address);
+    if (auto id = dynamic_cast<ASTNodeIdentifier *>(node)) {
+        /* Variables of the enclosing functions need the static links to be followed */
+        auto level = this->symtab.get_symbol_level(id->name);
+        if (this->symtab.get_symbol(id->name).type.type != float_t.type && (level == 0 || level == this->contexts.back().depth))
+            return this->variable(id->name, 0);
+    }
+    return "";
+}
+
+void AsmGenerator::push(AsmValueKind kind) {
+    if (kind == ASM_VOID)
+        return;
+
+    /* Exponent of the float is on the top like in the PL/0 code */
+    this->generate("pushq %rax");
+    if (kind == ASM_FLOAT)
+        this->generate("pushq %rdx");
+    this->contexts.back().stack_depth += cells(kind);
+}
+
+void AsmGenerator::pop(const std::string &reg) {
+    this->generate("popq " + reg);
+    this->contexts.back().stack_depth--;
+}
+
+void AsmGenerator::call(const std::string &name) {
+    /* Frames are aligned to 16 bytes, odd number of the pushed cells needs a padding */
+    if (this->contexts.back().stack_depth % 2 == 0) {
+        this->generate("call " + name);
+        return;
+    }
+    this->generate("subq $8, %rsp");
+    this->generate("call " + name);
+    this->generate("addq $8, %rsp");
+}
+
+void AsmGenerator::check_heap_address(const std::string &reg) {
+    /* Unsigned comparison catches the negative addresses as well */
+    this->generate("cmpq yadc_heap_length(%rip), " + reg);
+    this->generate("jae .Lheap_error_" + reg.substr(1));
+}
+
+void AsmGenerator::reserve_frame() {
+    auto &scope = this->symtab.get_current_scope();
+    auto size = scope.get_address_base() + scope.get_address_offset();
+    if (this->contexts.size() == 1)
+        this->globals_size = std::max(this->globals_size, size);
+    else
+        this->contexts.back().frame_size = std::max(this->contexts.back().frame_size, size);
+}
+
+std::string AsmGenerator::variable(const std::string &name, uint32_t offset) {
+    auto address = this->symtab.get_symbol(name).address + offset;
+    auto level = this->symtab.get_symbol_level(name);
+    auto &context = this->contexts.back();
+    if (level == context.depth) {
+        this->globals_size = std::max(this->globals_size, address + 1);
+        return "yadc_globals+" + std::to_string(address * 8) + "(%rip)";
+    }
+
+    if (level == 0)
+        context.frame_size = std::max(context.frame_size, address + 1);
+    return std::to_string(-8 * (static_cast<int64_t>(address) + 1)) + "(" + this->frame(level, "%rcx") + ")";
+}
+
+std::string AsmGenerator::frame(uint32_t level, const std::string &reg) {
+    if (level == 0)
+        return "%rbp";
+
+    /* Static link is the first cell of the frame */
+    this->generate("movq -8(%rbp), " + reg);
+    for (auto i = 1u; i < level; i++)
+        this->generate("movq -8(" + reg + "), " + reg);
+    return reg;
+}
+
+void AsmGenerator::store(const std::string &name, AsmValueKind kind) {
+    auto &symbol = this->symtab.get_symbol(name);
+    if (symbol.type.type == float_t.type) {
+        this->convert(kind, ASM_FLOAT);
+        this->generate("movq %rax, " + this->variable(name, 0));
+        this->generate("movq %rdx, " + this->variable(name, 1));
+    } else {
+        this->convert(kind, ASM_CELL);
+        this->generate("movq %rax, " + this->variable(name, 0));
+    }
+}
+
+void AsmGenerator::cell_operation(const std::string &op, const std::string &right) {
+    if (op == "+") {
+        this->generate("addq " + right + ", %rax");
+    } else if (op == "-") {
+        this->generate("subq " + right + ", %rax");
+    } else if (op == "*") {
+        this->generate("imulq " + right + ", %rax");
+    } else if (op == "/" || op == "%") {
+        if (right != "%rcx")
+            this->generate("movq " + right + ", %rcx");
+        /* Division by -1 would overflow for the minimal value */
+        auto minus_one = this->new_label();
+        auto end = this->new_label();
+        this->generate("testq %rcx, %rcx");
+        this->generate("je .Ldivision_by_zero");
+        this->generate("cmpq $-1, %rcx");
+        this->generate("je " + minus_one);
+        this->generate("cqto");
+        this->generate("idivq %rcx");
+        if (op == "%")
+            this->generate("movq %rdx, %rax");
+        this->generate("jmp " + end);
+        this->place_label(minus_one);
+        this->generate(op == "/" ? "negq %rax" : "xorl %eax, %eax");
+        this->place_label(end);
+    } else if (op == "&&" || op == "||") {
+        /* AND: 1 * 1 = 1, 1 * 0 = 0, 0 * 1 = 0, 0 * 0 = 0; OR: 1 + 1 = 2, 1 + 0 = 1, 0 + 1 = 1, 0 + 0 = 0 */
+        this->generate((op == "&&" ? "imulq " : "addq ") + right + ", %rax");
+        this->generate("testq %rax, %rax");
+        this->generate("setne %al");
+        this->generate("movzbl %al, %eax");
+    } else {
+        this->generate("cmpq " + right + ", %rax");
+        this->generate(ComparisonsTable.at(op) + " %al");
+        this->generate("movzbl %al, %eax");
+    }
+}
+
+std::string AsmGenerator::function_prologue(const AsmFunctionContext &context, bool is_nested) {
+    std::string prologue = "    pushq %rbp\n    movq %rsp, %rbp\n";
+    auto frame_size = (context.frame_size + 1) / 2 * 2;
+    if (frame_size > 0)
+        prologue += "    subq $" + std::to_string(frame_size * 8) + ", %rsp\n";
+
+    /* Variables are zeroed (the activation record except the static link is not used) */
+    if (context.frame_size > ACTIVATION_RECORD_SIZE) {
+        auto count = context.frame_size - ACTIVATION_RECORD_SIZE;
+        if (count <= 8) {
+            for (auto address = ACTIVATION_RECORD_SIZE; address < context.frame_size; address++)
+                prologue += "    movq $0, " + std::to_string(-8 * (static_cast<int64_t>(address) + 1)) + "(%rbp)\n";
+        } else {
+            prologue += "    xorl %eax, %eax\n";
+            prologue += "    leaq " + std::to_string(-8 * static_cast<int64_t>(context.frame_size)) + "(%rbp), %rdi\n";
+            prologue += "    movl $" + std::to_string(count) + ", %ecx\n";
+            prologue += "    rep stosq\n";
+        }
+    }
+    if (is_nested)
+        prologue += "    movq %r10, -8(%rbp)\n";
+    return prologue;
+}
+
+void AsmGenerator::generate() {
+    this->symtab.insert_scope(0, ACTIVATION_RECORD_SIZE); /* Offset 3 for activation record */
+    this->symtab.init_builtin_functions();
+
+    for (auto &statement: this->global_block->statements) {
+        auto decl_func = dynamic_cast<ASTNodeDeclFunc *>(statement);
+        if (decl_func && decl_func->block)
+            this->definitions[decl_func->name] = decl_func;
+    }
+
+    /* Global code becomes the main function, global variables live in yadc_globals */
+    this->contexts.push_back(AsmFunctionContext{-1, 0, 0, 0, "", {}, ""});
+    auto number_of_variables = this->global_block->get_number_of_declared_variables();
+    this->symtab.allocate_symbols(number_of_variables, this->global_block->get_sizeof_variables());
+    this->reserve_frame();
+
+    for (auto &statement: this->global_block->statements)
+        statement->accept(this);
+
+    this->call(this->functions[this->symtab.get_symbol("main").address].name);
+    this->call("yadc_finish");
+
+    this->code = "# Generated by yadc, link with the runtime: cc program.s yadc_runtime.c\n";
+    this->code += "    .text\n\n" + this->function_definitions;
+    this->code += "    .globl main\n    .type main, @function\nmain:\n    pushq %rbp\n    movq %rsp, %rbp\n";
+    this->code += this->contexts.back().body + "    popq %rbp\n    ret\n\n";
+    this->contexts.pop_back();
+
+    /* Runtime errors, the stack is aligned for the call of the runtime */
+    this->code += ".Ldivision_by_zero:\n    andq $-16, %rsp\n    leaq .Ldivision_by_zero_message(%rip), %rdi\n    call yadc_error\n";
+    this->code += ".Lheap_error_rax:\n    movq %rax, %rdi\n    andq $-16, %rsp\n    call yadc_heap_error\n";
+    this->code += ".Lheap_error_rcx:\n    movq %rcx, %rdi\n    andq $-16, %rsp\n    call yadc_heap_error\n\n";
+
+    this->code += "    .section .rodata\n.Ldivision_by_zero_message:\n    .string \"division by zero\"\n";
+    for (std::size_t i = 0; i < this->strings.size(); i++)
+        this->code += ".Lstring" + std::to_string(i) + ":\n    .ascii \"" + escape(this->strings[i]) + "\"\n";
+
+    this->code += "\n    .bss\n    .align 8\nyadc_globals:\n    .zero " + std::to_string(std::max(this->globals_size, 1u) * 8) + "\n";
+    this->code += "\n    .section .note.GNU-stack,\"\",@progbits\n";
+}
+
+void AsmGenerator::visit(ASTNodeBlock *node) {
+    auto number_of_variables = node->get_number_of_declared_variables();
+    this->symtab.allocate_symbols(number_of_variables, node->get_sizeof_variables());
+    this->reserve_frame();
+
+    for (auto &statement: node->statements)
+        statement->accept(this);
+}
+
+void AsmGenerator::visit(ASTNodeDeclVar *node) {
+    this->register_label(node);
+
+    auto temp_name = this->symtab.get_first_empty_symbol(sizeof_val_type(str_to_val_type(node->type))).name;
+    this->symtab.change_symbol_name(temp_name, node->name);
+    auto &symbol = this->symtab.get_symbol(node->name);
+    symbol.type = {str_to_val_type(node->type), node->is_pointer, true};
+    symbol.is_const = node->is_const;
+
+    if (node->expression) {
+        symbol.type.is_pointing_to_stack = dynamic_cast<ASTNodeNew *>(node->expression) == nullptr;
+        if (auto *ref = dynamic_cast<ASTNodeReference *>(node->expression))
+            symbol.pointee = &this->symtab.get_symbol(ref->identifier);
+        else
+            symbol.pointee = nullptr;
+
+        auto kind = this->evaluate(node->expression);
+        this->store(node->name, kind);
+    }
+}
+
+void AsmGenerator::visit(ASTNodeDeclFunc *node) {
+    this->register_label(node);
+
+    auto &symbol = this->symtab.get_symbol(node->name);
+    uint32_t index;
+    if (symbol.name.empty()) { /* Function was not yet declared */
+        index = this->functions.size();
+        /* Function declared as a header only gets the signature of its definition */
+        auto definition = node;
+        if (!node->block && this->contexts.size() == 1 && this->definitions.contains(node->name))
+            definition = this->definitions[node->name];
+
+        auto is_nested = this->contexts.size() > 1;
+        auto name = is_nested ? this->functions[this->contexts.back().function].name + "_" + node->name : "f_" + node->name;
+        std::vector<AsmValueKind> parameter_kinds;
+        for (auto &parameter: definition->parameters)
+            parameter_kinds.push_back(value_kind(str_to_val_type(parameter->type)));
+        this->functions.push_back(AsmFunction{name, value_kind(str_to_val_type(definition->return_type)), parameter_kinds, is_nested});
+
+        Type type{str_to_val_type(node->return_type), false, false};
+        this->symtab.insert_symbol(node->name, FUNCTION, type, false, index);
+        auto &func_symbol = this->symtab.get_symbol(node->name);
+        for (auto &parameter: node->parameters) {
+            Type param_type{str_to_val_type(parameter->type), parameter->is_pointer, false};
+            func_symbol.parameters.push_back({parameter->name, VARIABLE, param_type, false});
+        }
+    } else { /* Function was earlier declared as a header only */
+        index = symbol.address;
+    }
+
+    if (!node->block)
+        return;
+
+    this->symtab.insert_scope(0, ACTIVATION_RECORD_SIZE, true); /* Offset 3 for activation record */
+    auto depth = this->contexts.back().depth + 1;
+    this->contexts.push_back(AsmFunctionContext{static_cast<int>(index), depth, 1, 0, this->new_label(), {}, ""});
+
+    for (auto &parameter: node->parameters) {
+        Type type{str_to_val_type(parameter->type), parameter->is_pointer, false};
+        this->symtab.insert_symbol(parameter->name, VARIABLE, type, false);
+    }
+    this->reserve_frame();
+
+    /* Arguments pushed by the caller are copied into the frame like in the PL/0 code (they can be assigned) */
+    auto argument_cells = 0u;
+    for (auto parameter_kind: this->functions[index].parameter_kinds)
+        argument_cells += cells(parameter_kind);
+    auto argument = 0u;
+    for (auto &parameter: node->parameters) {
+        auto parameter_cells = str_to_val_type(parameter->type) == float_t.type ? 2u : 1u;
+        for (auto i = 0u; i < parameter_cells; i++, argument++) {
+            this->generate("movq " + std::to_string(16 + 8 * (argument_cells - 1 - argument)) + "(%rbp), %rax");
+            this->generate("movq %rax, " + this->variable(parameter->name, i));
+        }
+    }
+
+    node->block->accept(this);
+
+    /* PL/0 code of a function without return continues after the function, native function returns zero */
+    auto return_kind = this->functions[index].return_kind;
+    if (return_kind != ASM_VOID && !node->block->contains_return_statement()) {
+        this->generate("xorl %eax, %eax");
+        this->generate("xorl %edx, %edx");
+    }
+
+    this->symtab.remove_scope();
+
+    auto context = std::move(this->contexts.back());
+    this->contexts.pop_back();
+    auto &name = this->functions[index].name;
+    this->function_definitions += "    .type " + name + ", @function\n" + name + ":\n" +
+                                  function_prologue(context, this->functions[index].is_nested) + context.body +
+                                  context.return_label + ":\n    leave\n    ret\n\n";
+}
+
+void AsmGenerator::visit(ASTNodeIf *node) {
+    this->register_label(node);
+
+    auto &current_scope = this->symtab.get_current_scope();
+    auto new_base = current_scope.get_address_base() + current_scope.get_address_offset();
+    this->symtab.insert_scope(new_base, 0, false);
+    this->convert(this->evaluate(node->condition), ASM_CELL);
+
+    auto else_label = this->new_label();
+    this->generate("testq %rax, %rax");
+    this->generate("je " + else_label);
+    node->block->accept(this);
+    this->symtab.remove_scope();
+
+    if (node->else_block) {
+        auto &current_scope = this->symtab.get_current_scope();
+        auto new_base = current_scope.get_address_base() + current_scope.get_address_offset();
+        this->symtab.insert_scope(new_base, 0, false);
+
+        auto end_label = this->new_label();
+        this->generate("jmp " + end_label);
+        this->place_label(else_label);
+        node->else_block->accept(this);
+        this->place_label(end_label);
+        this->symtab.remove_scope();
+    } else {
+        this->place_label(else_label);
+    }
+}
+
+void AsmGenerator::visit(ASTNodeWhile *node) {
+    this->register_label(node);
+
+    auto &current_scope = this->symtab.get_current_scope();
+    auto new_base = current_scope.get_address_base() + current_scope.get_address_offset();
+    this->symtab.insert_scope(new_base, 0, false);
+
+    auto condition_label = this->new_label();
+    auto end_label = this->new_label();
+    this->contexts.back().loops.push_back(AsmLoop{end_label, condition_label});
+
+    if (node->is_do_while) {
+        auto body_label = this->new_label();
+        this->place_label(body_label);
+        node->block->accept(this);
+
+        this->place_label(condition_label);
+        this->convert(this->evaluate(node->condition), ASM_CELL);
+        this->generate("testq %rax, %rax");
+        this->generate((node->is_repeat_until ? "je " : "jne ") + body_label);
+    } else {
+        this->place_label(condition_label);
+        this->convert(this->evaluate(node->condition), ASM_CELL);
+        this->generate("testq %rax, %rax");
+        this->generate((node->is_repeat_until ? "jne " : "je ") + end_label);
+
+        node->block->accept(this);
+        this->generate("jmp " + condition_label);
+    }
+    this->place_label(end_label);
+
+    this->contexts.back().loops.pop_back();
+    this->symtab.remove_scope();
+}
+
+void AsmGenerator::visit(ASTNodeFor *node) {
+    this->register_label(node);
+
+    auto &current_scope = this->symtab.get_current_scope();
+    auto new_base = current_scope.get_address_base() + current_scope.get_address_offset();
+    this->symtab.insert_scope(new_base, 0, false);
+
+    if (auto decl_var = dynamic_cast<ASTNodeDeclVar *>(node->init)) {
+        Type type{str_to_val_type(decl_var->type), decl_var->is_pointer, true};
+        this->symtab.allocate_symbols(1, {type.size});
+        this->reserve_frame();
+    }
+    node->init->accept(this);
+
+    auto condition_label = this->new_label();
+    auto increment_label = this->new_label();
+    auto end_label = this->new_label();
+    this->place_label(condition_label);
+    this->convert(this->evaluate(node->condition), ASM_CELL);
+    this->generate("testq %rax, %rax");
+    this->generate("je " + end_label);
+
+    this->contexts.back().loops.push_back(AsmLoop{end_label, increment_label});
+    node->block->accept(this);
+    this->contexts.back().loops.pop_back();
+
+    this->place_label(increment_label);
+    this->evaluate(node->increment);
+    this->generate("jmp " + condition_label);
+    this->place_label(end_label);
+
+    this->symtab.remove_scope();
+}
+
+void AsmGenerator::visit(ASTNodeBreakContinue *node) {
+    this->register_label(node);
+
+    auto &loop = this->contexts.back().loops.back();
+    this->generate("jmp " + (node->is_break ? loop.break_label : loop.continue_label));
+}
+
+void AsmGenerator::visit(ASTNodeReturn *node) {
+    this->register_label(node);
+
+    auto &context = this->contexts.back();
+    auto return_kind = this->functions[context.function].return_kind;
+    if (node->expression) {
+        this->convert(this->evaluate(node->expression), return_kind);
+    } else if (return_kind != ASM_VOID) {
+        this->generate("xorl %eax, %eax");
+        this->generate("xorl %edx, %edx");
+    }
+    this->generate("jmp " + this->contexts.back().return_label);
+}
+
+void AsmGenerator::visit(ASTNodeGoto *node) {
+    this->register_label(node);
+    this->generate("jmp .Llabel" + std::to_string(this->contexts.back().function + 1) + "_" + node->label_to_go_to);
+}
+
+void AsmGenerator::visit(ASTNodeExpressionStatement *node) {
+    this->register_label(node);
+    this->evaluate(node->expression);
+}
+
+void AsmGenerator::visit(ASTNodeIdentifier *node) {
+    auto &symbol = this->symtab.get_symbol(node->name);
+    this->generate("movq " + this->variable(node->name, 0) + ", %rax");
+    if (symbol.type.type == float_t.type) {
+        this->generate("movq " + this->variable(node->name, 1) + ", %rdx");
+        this->kind = ASM_FLOAT;
+    } else {
+        this->kind = ASM_CELL;
+    }
+}
+
+void AsmGenerator::visit(ASTNodeIntLiteral *node) {
+    this->generate(load_constant(node->value, "%rax"));
+    this->kind = ASM_CELL;
+}
+
+void AsmGenerator::visit(ASTNodeFloatLiteral *node) {
+    /* Parts of the float are computed the same way as in the PL/0 code */
+    auto whole_part = (int) node->value;
+    auto fractional_part = std::to_string(node->value);
+
+    /* Erase everything up to the first dot */
+    fractional_part.erase(0, fractional_part.find('.') + 1);
+    while (fractional_part[fractional_part.length() - 1] == '0')
+        fractional_part.erase(fractional_part.length() - 1, 1);
+    if (fractional_part.empty())
+        fractional_part = "0";
+
+    /* ITR of the literal is evaluated at compile time */
+    int64_t fractional_part_int = std::stoi(fractional_part);
+    int64_t scale = 1;
+    int64_t digits = 0;
+    for (auto rest = fractional_part_int; rest > 0; rest /= 10) {
+        scale *= 10;
+        digits++;
+    }
+    auto mantissa = whole_part * scale + (whole_part < 0 ? -fractional_part_int : fractional_part_int);
+
+    this->generate(load_constant(mantissa, "%rax"));
+    this->generate(load_constant(-digits, "%rdx"));
+    this->kind = ASM_FLOAT;
+}
+
+void AsmGenerator::visit(ASTNodeBoolLiteral *node) {
+    this->generate(node->value ? "movq $1, %rax" : "xorl %eax, %eax");
+    this->kind = ASM_CELL;
+}
+
+void AsmGenerator::visit(ASTNodeStringLiteral *node) {
+    this->generate("leaq .Lstring" + std::to_string(this->strings.size()) + "(%rip), %rdi");
+    this->generate("movq $" + std::to_string(node->value.length()) + ", %rsi");
+    this->call("yadc_string");
+    this->strings.push_back(node->value);
+    this->kind = ASM_CELL;
+}
+
+void AsmGenerator::visit(ASTNodeAssignExpression *node) {
+    if (auto dereference = dynamic_cast<ASTNodeDereference *>(node->lvalue)) {
+        auto &symbol = this->symtab.get_symbol(dereference->identifier);
+        if (symbol.type.is_pointing_to_stack) {
+            /* Value is evaluated before the address (PST) */
+            this->push(this->convert(this->evaluate(node->expression), ASM_CELL));
+            auto level = 0u;
+            if (symbol.pointee)
+                level = this->symtab.get_symbol_level(symbol.pointee->name);
+            this->convert(this->evaluate(node->lvalue), ASM_CELL);
+            this->pop("%rcx");
+
+            if (level == this->contexts.back().depth) {
+                this->generate("leaq yadc_globals(%rip), %rdx");
+                this->generate("movq %rcx, (%rdx,%rax,8)");
+            } else {
+                /* Cell with the address a is at -8 * (a + 1) from the frame pointer */
+                auto frame = this->frame(level, "%rdx");
+                this->generate("negq %rax");
+                this->generate("movq %rcx, -8(" + frame + ",%rax,8)");
+            }
+        } else {
+            /* Address is evaluated before the value (STA) */
+            this->push(this->convert(this->evaluate(node->lvalue), ASM_CELL));
+            this->convert(this->evaluate(node->expression), ASM_CELL);
+            this->pop("%rcx");
+            this->check_heap_address("%rcx");
+            this->generate("movq yadc_heap(%rip), %rdx");
+            this->generate("movq %rax, (%rdx,%rcx,8)");
+        }
+        this->kind = ASM_VOID;
+        return;
+    }
+
+    auto &symbol = this->symtab.get_symbol(node->name);
+    symbol.type.is_pointing_to_stack = dynamic_cast<ASTNodeNew *>(node->expression) == nullptr;
+    if (auto *ref = dynamic_cast<ASTNodeReference *>(node->expression))
+        symbol.pointee = &this->symtab.get_symbol(ref->identifier);
+    else
+        symbol.pointee = nullptr;
+
+    this->store(node->name, this->evaluate(node->expression));
+    this->kind = ASM_VOID;
+}
+
+void AsmGenerator::visit(ASTNodeTernaryOperator *node) {
+    this->convert(this->evaluate(node->condition), ASM_CELL);
+
+    auto false_label = this->new_label();
+    auto end_label = this->new_label();
+    this->generate("testq %rax, %rax");
+    this->generate("je " + false_label);
+    auto true_kind = this->evaluate(node->true_expression);
+    auto true_end = this->contexts.back().body.size();
+    this->generate("jmp " + end_label);
+    this->place_label(false_label);
+    auto false_kind = this->evaluate(node->false_expression);
+
+    /* Integer branch of a float ternary gets the zero exponent */
+    auto kind = true_kind == ASM_FLOAT || false_kind == ASM_FLOAT ? ASM_FLOAT : true_kind;
+    if (kind == ASM_FLOAT && true_kind == ASM_CELL)
+        this->contexts.back().body.insert(true_end, "    xorl %edx, %edx\n");
+    this->convert(false_kind, kind);
+    this->place_label(end_label);
+    this->kind = kind;
+}
+
+void AsmGenerator::visit(ASTNodeBinaryOperator *node) {
+    if (node->is_pointer_arithmetic) {
+        /* Integer operand is multiplied by the size of the pointed type */
+        auto first = node->left;
+        auto second = node->right;
+        uint32_t size = 1;
+        if (auto left_id = dynamic_cast<ASTNodeIdentifier *>(node->left)) {
+            size = this->symtab.get_symbol(left_id->name).type.size;
+        } else if (auto right_id = dynamic_cast<ASTNodeIdentifier *>(node->right)) {
+            size = this->symtab.get_symbol(right_id->name).type.size;
+            first = node->right;
+            second = node->left;
+        }
+
+        this->convert(this->evaluate(first), ASM_CELL);
+        auto right = size == 1 ? this->operand(second) : "";
+        if (right.empty()) {
+            this->push(ASM_CELL);
+            this->convert(this->evaluate(second), ASM_CELL);
+            if (size != 1)
+                this->generate("imulq $" + std::to_string(size) + ", %rax");
+            this->generate("movq %rax, %rcx");
+            this->pop("%rax");
+            right = "%rcx";
+        }
+        this->cell_operation(node->op, right);
+        this->kind = ASM_CELL;
+        return;
+    }
+
+    /* Float arithmetic is detected the same way as in the PL/0 code */
+    bool is_float = node->is_float_arithmetic;
+    if (auto left_id = dynamic_cast<ASTNodeIdentifier *>(node->left)) {
+        if (this->symtab.get_symbol(left_id->name).type.type == float_t.type)
+            is_float = true;
+    } else if (auto left_call = dynamic_cast<ASTNodeCallFunc *>(node->left)) {
+        if (this->symtab.get_symbol(left_call->name).type.type == float_t.type)
+            is_float = true;
+    } else if (dynamic_cast<ASTNodeFloatLiteral *>(node->left))
+        is_float = true;
+    if (auto right_id = dynamic_cast<ASTNodeIdentifier *>(node->right)) {
+        if (this->symtab.get_symbol(right_id->name).type.type == float_t.type)
+            is_float = true;
+    } else if (auto right_call = dynamic_cast<ASTNodeCallFunc *>(node->right)) {
+        if (this->symtab.get_symbol(right_call->name).type.type == float_t.type)
+            is_float = true;
+    } else if (dynamic_cast<ASTNodeFloatLiteral *>(node->right))
+        is_float = true;
+    node->is_float_arithmetic = is_float;
+    node->propagate_float();
+
+    /* It doesn't even make sense to AND or OR floats */
+    auto is_logical = node->op == "&&" || node->op == "||";
+    auto left_kind = this->evaluate(node->left);
+    if (is_logical)
+        left_kind = this->convert(left_kind, ASM_CELL);
+
+    /* Constant or variable on the right is used directly as the operand of the instruction */
+    if ((is_logical || !is_float) && left_kind == ASM_CELL) {
+        auto right = this->operand(node->right);
+        if (!right.empty()) {
+            this->cell_operation(node->op, right);
+            this->kind = ASM_CELL;
+            return;
+        }
+    }
+
+    this->push(left_kind);
+    auto right_kind = this->evaluate(node->right);
+    is_float = !is_logical && (is_float || left_kind == ASM_FLOAT || right_kind == ASM_FLOAT);
+
+    /* Implicit casting */
+    if (!is_float) {
+        this->convert(right_kind, ASM_CELL);
+        this->generate("movq %rax, %rcx");
+        this->pop("%rax");
+        this->cell_operation(node->op, "%rcx");
+        this->kind = ASM_CELL;
+        return;
+    }
+
+    this->convert(right_kind, ASM_FLOAT);
+    this->generate("movq %rax, %rcx");
+    this->generate("movq %rdx, %r8");
+    if (left_kind == ASM_FLOAT) {
+        this->pop("%rdx");
+        this->pop("%rsi");
+    } else {
+        this->pop("%rsi");
+        this->generate("xorl %edx, %edx");
+    }
+    this->generate("movl $" + std::to_string(OperatorsTable.at(node->op)) + ", %edi");
+    if (node->op == "+" || node->op == "-" || node->op == "*" || node->op == "/" || node->op == "%") {
+        this->call("yadc_float_operation");
+        this->kind = ASM_FLOAT;
+    } else {
+        this->call("yadc_float_comparison");
+        this->kind = ASM_CELL;
+    }
+}
+
+void AsmGenerator::visit(ASTNodeUnaryOperator *node) {
+    auto kind = this->evaluate(node->expression);
+
+    if (node->op == "!") { /* NOT: true == 0 => false, false == 0 => true */
+        this->convert(kind, ASM_CELL);
+        this->generate("testq %rax, %rax");
+        this->generate("sete %al");
+        this->generate("movzbl %al, %eax");
+        this->kind = ASM_CELL;
+    } else if (node->op == "-" && kind == ASM_FLOAT) {
+        /* Generated PL/0 code negates the top cell of the float (the exponent) */
+        this->generate("negq %rdx");
+        this->kind = ASM_FLOAT;
+    } else if (node->op == "-") {
+        this->generate("negq %rax");
+        this->kind = ASM_CELL;
+    } else {
+        this->kind = kind;
+    }
+}
+
+ValueType AsmGenerator::cast_source_type(ASTNodeExpression *node) {
+    if (auto id = dynamic_cast<ASTNodeIdentifier *>(node))
+        return this->symtab.get_symbol(id->name).type.type;
+    if (dynamic_cast<ASTNodeIntLiteral *>(node))
+        return int_t.type;
+    if (dynamic_cast<ASTNodeFloatLiteral *>(node))
+        return float_t.type;
+    if (dynamic_cast<ASTNodeBoolLiteral *>(node))
+        return bool_t.type;
+    if (auto bin_op = dynamic_cast<ASTNodeBinaryOperator *>(node)) {
+        auto is_float = bin_op->is_float_arithmetic;
+        if (auto left_id = dynamic_cast<ASTNodeIdentifier *>(bin_op->left)) {
+            if (this->symtab.get_symbol(left_id->name).type.type == float_t.type)
+                is_float = true;
+        }
+        if (auto right_id = dynamic_cast<ASTNodeIdentifier *>(bin_op->right)) {
+            if (this->symtab.get_symbol(right_id->name).type.type == float_t.type)
+                is_float = true;
+        }
+        bin_op->propagate_float();
+        is_float = is_float || bin_op->is_float_arithmetic;
+        return is_float ? float_t.type : int_t.type;
+    }
+    if (auto un_op = dynamic_cast<ASTNodeUnaryOperator *>(node))
+        return un_op->op == "-" ? int_t.type : bool_t.type;
+    if (auto call_func = dynamic_cast<ASTNodeCallFunc *>(node))
+        return this->symtab.get_symbol(call_func->name).type.type;
+    if (auto dereference = dynamic_cast<ASTNodeDereference *>(node))
+        return this->symtab.get_symbol(dereference->identifier).type.type;
+    if (auto reference = dynamic_cast<ASTNodeReference *>(node))
+        return this->symtab.get_symbol(reference->identifier).type.type;
+    if (auto sizeof_op = dynamic_cast<ASTNodeSizeof *>(node))
+        return str_to_val_type(sizeof_op->type);
+    return undefined_t.type;
+}
+
+void AsmGenerator::visit(ASTNodeCast *node) {
+    auto casting_from = this->cast_source_type(node->expression);
+    auto casting_to = str_to_val_type(node->type);
+    auto kind = this->evaluate(node->expression);
+
+    if (casting_to == float_t.type) {
+        this->kind = this->convert(kind, ASM_FLOAT);
+    } else if (casting_to == int_t.type) {
+        this->kind = this->convert(kind, ASM_CELL);
+    } else if (casting_to == bool_t.type && (kind == ASM_FLOAT || casting_from == int_t.type)) {
+        this->convert(kind, ASM_CELL);
+        this->generate("testq %rax, %rax");
+        this->generate("setne %al");
+        this->generate("movzbl %al, %eax");
+        this->kind = ASM_CELL;
+    } else {
+        this->kind = kind;
+    }
+}
+
+void AsmGenerator::visit(ASTNodeCallFunc *node) {
+    auto &symbol = this->symtab.get_symbol(node->name);
+
+    if (auto builtin = BuiltinFunctionsTable.find(node->name); builtin != BuiltinFunctionsTable.end()) {
+        /* Arguments are passed in the registers, all but the last one wait on the machine stack */
+        std::vector<AsmValueKind> argument_kinds;
+        for (std::size_t i = 0; i < node->arguments.size(); i++) {
+            auto argument_kind = this->evaluate(node->arguments[i]);
+            if (i < symbol.parameters.size())
+                argument_kind = this->convert(argument_kind, value_kind(symbol.parameters[i].type.type));
+            argument_kinds.push_back(argument_kind);
+            if (i + 1 < node->arguments.size())
+                this->push(argument_kind);
+        }
+
+        auto argument_cells = 0u;
+        for (auto argument_kind: argument_kinds)
+            argument_cells += cells(argument_kind);
+        for (auto i = argument_kinds.size(); i-- > 0;) {
+            auto first = argument_cells - cells(argument_kinds[i]);
+            if (i + 1 == argument_kinds.size()) {
+                /* Exponent is moved first, the mantissa may go to %rdx */
+                if (argument_kinds[i] == ASM_FLOAT)
+                    this->generate("movq %rdx, " + std::string(ArgumentRegisters[first + 1]));
+                this->generate("movq %rax, " + std::string(ArgumentRegisters[first]));
+            } else {
+                if (argument_kinds[i] == ASM_FLOAT)
+                    this->pop(ArgumentRegisters[first + 1]);
+                this->pop(ArgumentRegisters[first]);
+            }
+            argument_cells = first;
+        }
+
+        this->call(builtin->second);
+        this->kind = value_kind(symbol.type.type);
+        return;
+    }
+
+    /* Arguments are pushed onto the machine stack, padding keeps the call aligned */
+    auto &function = this->functions[symbol.address];
+    auto argument_cells = 0u;
+    for (auto parameter_kind: function.parameter_kinds)
+        argument_cells += cells(parameter_kind);
+    auto &context = this->contexts.back();
+    auto padding = (context.stack_depth + argument_cells) % 2;
+    if (padding) {
+        this->generate("subq $8, %rsp");
+        context.stack_depth++;
+    }
+
+    for (std::size_t i = 0; i < node->arguments.size(); i++) {
+        auto argument_kind = this->evaluate(node->arguments[i]);
+        if (i < function.parameter_kinds.size())
+            argument_kind = this->convert(argument_kind, function.parameter_kinds[i]);
+        this->push(argument_kind);
+    }
+
+    /* Static link is the frame of the function the called function is declared in */
+    if (function.is_nested) {
+        auto frame = this->frame(this->symtab.get_symbol_level(node->name), "%r10");
+        if (frame != "%r10")
+            this->generate("movq " + frame + ", %r10");
+    }
+    this->generate("call " + function.name);
+    if (argument_cells + padding > 0)
+        this->generate("addq $" + std::to_string(8 * (argument_cells + padding)) + ", %rsp");
+    this->contexts.back().stack_depth -= argument_cells + padding;
+    this->kind = function.return_kind;
+}
+
+void AsmGenerator::visit(ASTNodeNew *node) {
+    /* Size of the block is stored in front of it by the runtime */
+    auto size = sizeof_val_type(str_to_val_type(node->type));
+    this->convert(this->evaluate(node->expression), ASM_CELL);
+    if (size != 1)
+        this->generate("imulq $" + std::to_string(size) + ", %rax");
+    this->generate("movq %rax, %rdi");
+    this->call("yadc_new");
+    this->kind = ASM_CELL;
+}
+
+void AsmGenerator::visit(ASTNodeDelete *node) {
+    this->convert(this->evaluate(node->expression), ASM_CELL);
+    this->generate("movq %rax, %rdi");
+    this->call("yadc_delete");
+    this->kind = ASM_VOID;
+}
+
+void AsmGenerator::visit(ASTNodeDereference *node) {
+    if (auto binary_op = dynamic_cast<ASTNodeBinaryOperator *>(node->expression))
+        binary_op->is_pointer_arithmetic = true;
+    this->convert(this->evaluate(node->expression), ASM_CELL);
+
+    /* Lvalue is the address itself, rvalue is always loaded from the heap (same as the PL/0 code) */
+    if (!node->is_lvalue) {
+        this->check_heap_address("%rax");
+        this->generate("movq yadc_heap(%rip), %rcx");
+        this->generate("movq (%rcx,%rax,8), %rax");
+    }
+    this->kind = ASM_CELL;
+}
+
+void AsmGenerator::visit(ASTNodeReference *node) {
+    auto address = this->symtab.get_symbol(node->identifier).address;
+    this->generate("movq $" + std::to_string(address) + ", %rax");
+    this->kind = ASM_CELL;
+}
+
+void AsmGenerator::visit(ASTNodeSizeof *node) {
+    this->generate("movq $" + std::to_string(sizeof_val_type(str_to_val_type(node->type))) + ", %rax");
+    this->kind = ASM_CELL;
+}
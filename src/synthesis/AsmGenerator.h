@@ -0,0 +1,248 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include "AbstractSyntaxTree.h"
+#include "SymbolTable.h"
+
+/**
+ * Enum representing kinds of the values in the registers
+ */
+enum AsmValueKind {
+    ASM_VOID,
+    ASM_CELL, /* Value in %rax */
+    ASM_FLOAT /* Mantissa in %rax, exponent in %rdx */
+};
+
+/**
+ * Structure representing an assembly function generated from a YADC function
+ */
+typedef struct AsmFunction {
+    /** Symbol of the function */
+    std::string name;
+    /** Kind of the return value */
+    AsmValueKind return_kind;
+    /** Kinds of the parameters */
+    std::vector<AsmValueKind> parameter_kinds;
+    /** Flag if the function is nested (gets the frame of the enclosing function as the static link) */
+    bool is_nested;
+} AsmFunction;
+
+/**
+ * Structure representing labels of a loop being generated
+ */
+typedef struct AsmLoop {
+    /** Label jumped to by break */
+    std::string break_label;
+    /** Label jumped to by continue */
+    std::string continue_label;
+} AsmLoop;
+
+/**
+ * Structure representing an assembly function being generated
+ */
+typedef struct AsmFunctionContext {
+    /** Index of the function (-1 for the global code) */
+    int function;
+    /** Number of the function scopes (0 for the global code) */
+    uint32_t depth;
+    /** Size of the frame (in cells) */
+    uint32_t frame_size;
+    /** Number of the cells pushed onto the machine stack by the expression being generated */
+    uint32_t stack_depth;
+    /** Label of the epilogue */
+    std::string return_label;
+    /** Loops being generated */
+    std::vector<AsmLoop> loops;
+    /** Generated instructions */
+    std::string body;
+} AsmFunctionContext;
+
+/**
+ * Class for x86-64 assembly generation (GNU assembler, System V ABI)
+ * Inherits from ASTVisitor to traverse the AST
+ * Every YADC function becomes a native function with its variables in its stack frame, the cell with the address a
+ * is at -8 * (a + 1)(%rbp), so pointers to the stack have the same addresses as in the PL/0 code
+ * Expressions are evaluated in the registers, only the intermediate results of the nested expressions are pushed
+ * The generated code is linked with the runtime (src/runtime/yadc_runtime.c) for the heap, floats and builtin functions
+ */
+class AsmGenerator : public ASTVisitor {
+private:
+    /** Root of the AST */
+    ASTNodeBlock *global_block;
+    /** Symbol table */
+    SymbolTable symtab;
+    /** Generated functions (address of the function symbol is the index) */
+    std::vector<AsmFunction> functions;
+    /** Definitions of the global functions (used for the functions declared as a header only) */
+    std::map<std::string, ASTNodeDeclFunc *> definitions;
+    /** Stack of the functions being generated */
+    std::vector<AsmFunctionContext> contexts;
+    /** Generated definitions of the functions */
+    std::string function_definitions;
+    /** String literals (index is the number of the label) */
+    std::vector<std::string> strings;
+    /** Size of the global variables (in cells) */
+    uint32_t globals_size;
+    /** Number of the generated labels */
+    uint32_t labels;
+    /** Kind of the last generated expression */
+    AsmValueKind kind;
+    /** Generated assembly */
+    std::string code;
+
+    /**
+     * Generate instruction
+     * @param instruction Instruction
+     */
+    void generate(const std::string &instruction);
+    /**
+     * Generate label
+     * @param label Label
+     */
+    void place_label(const std::string &label);
+    /**
+     * Creates a new local label
+     * @return Label
+     */
+    std::string new_label();
+    /**
+     * Generate label of the statement
+     * @param node AST node with label
+     */
+    void register_label(ASTNodeStatement *node);
+    /**
+     * Generate expression, the value is left in the registers
+     * @param node AST node of the expression
+     * @return Kind of the value
+     */
+    AsmValueKind evaluate(ASTNodeExpression *node);
+    /**
+     * Converts the value in the registers (int to float or float to its whole part)
+     * @param from Kind of the value
+     * @param to Wanted kind
+     * @return Kind of the value after the conversion
+     */
+    AsmValueKind convert(AsmValueKind from, AsmValueKind to);
+    /**
+     * Returns operand of the expression which can be used without evaluating it into a register
+     * (constants and variables of the current function or global variables)
+     * @param node AST node of the expression
+     * @return Operand or empty string if the expression has to be evaluated
+     */
+    std::string operand(ASTNodeExpression *node);
+    /**
+     * Pushes the value in the registers onto the machine stack
+     * @param kind Kind of the value
+     */
+    void push(AsmValueKind kind);
+    /**
+     * Pops cell from the machine stack
+     * @param reg Target register
+     */
+    void pop(const std::string &reg);
+    /**
+     * Generates call of a function, the stack is aligned to 16 bytes as required by the ABI
+     * @param name Name of the function
+     */
+    void call(const std::string &name);
+    /**
+     * Generates check of the heap address in %rax (or the given register)
+     * @param reg Register with the address
+     */
+    void check_heap_address(const std::string &reg);
+    /**
+     * Updates size of the frame of the current function by the variables of the current scope
+     */
+    void reserve_frame();
+    /**
+     * Returns memory operand of the cell of the variable, the frame of an enclosing function is loaded into %rcx
+     * @param name Name of the variable
+     * @param offset Offset of the cell (1 for the exponent of the float)
+     * @return Memory operand
+     */
+    std::string variable(const std::string &name, uint32_t offset);
+    /**
+     * Loads frame pointer of the function the given number of levels up the static links
+     * @param level Level
+     * @param reg Target register
+     * @return Register with the frame pointer
+     */
+    std::string frame(uint32_t level, const std::string &reg);
+    /**
+     * Generates store of the value in the registers into the variable
+     * @param name Name of the variable
+     * @param kind Kind of the value
+     */
+    void store(const std::string &name, AsmValueKind kind);
+    /**
+     * Returns source type of the cast the same way the PL/0 generator determines it
+     * @param node Casted expression
+     * @return Source type of the cast
+     */
+    ValueType cast_source_type(ASTNodeExpression *node);
+    /**
+     * Generates the integer binary operation, left operand in %rax, right operand in the given operand
+     * @param op Operator
+     * @param right Right operand
+     */
+    void cell_operation(const std::string &op, const std::string &right);
+    /**
+     * Returns prologue of the function (frame setup and zeroing)
+     * @param context Generated function
+     * @param is_nested Flag if the function is nested (static link in %r10)
+     * @return Instructions
+     */
+    static std::string function_prologue(const AsmFunctionContext &context, bool is_nested);
+
+public:
+    /**
+     * Constructor
+     * @param global_block Root of the AST
+     */
+    explicit AsmGenerator(ASTNodeBlock *global_block);
+    /**
+     * Destructor
+     */
+    ~AsmGenerator() override;
+
+    /**
+     * Generate assembly
+     */
+    void generate();
+    /**
+     * Get generated assembly
+     * @return Assembly (GNU assembler, AT&T syntax)
+     */
+    [[nodiscard]] const std::string &get_code() const;
+
+    /* ASTVisitor methods */
+    void visit(ASTNodeBlock *node) override;
+    void visit(ASTNodeDeclVar *node) override;
+    void visit(ASTNodeDeclFunc *node) override;
+    void visit(ASTNodeIf *node) override;
+    void visit(ASTNodeWhile *node) override;
+    void visit(ASTNodeFor *node) override;
+    void visit(ASTNodeBreakContinue *node) override;
+    void visit(ASTNodeReturn *node) override;
+    void visit(ASTNodeGoto *node) override;
+    void visit(ASTNodeExpressionStatement *node) override;
+    void visit(ASTNodeIdentifier *node) override;
+    void visit(ASTNodeIntLiteral *node) override;
+    void visit(ASTNodeBoolLiteral *node) override;
+    void visit(ASTNodeStringLiteral *node) override;
+    void visit(ASTNodeFloatLiteral *node) override;
+    void visit(ASTNodeAssignExpression *node) override;
+    void visit(ASTNodeTernaryOperator *node) override;
+    void visit(ASTNodeBinaryOperator *node) override;
+    void visit(ASTNodeUnaryOperator *node) override;
+    void visit(ASTNodeCast *node) override;
+    void visit(ASTNodeCallFunc *node) override;
+    void visit(ASTNodeNew *node) override;
+    void visit(ASTNodeDelete *node) override;
+    void visit(ASTNodeDereference *node) override;
+    void visit(ASTNodeReference *node) override;
+    void visit(ASTNodeSizeof *node) override;
+};
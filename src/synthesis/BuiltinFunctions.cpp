@@ -84,6 +84,13 @@ void InstructionsGenerator::init_builtin_functions() {
         auto &read_float_symbol = this->symtab.get_symbol("read_float");
         read_float_symbol.address = read_float_address;
     }
+
+    /* Address 0 is the jump over the builtin functions, so the builtin functions which were not generated have the address 0 */
+    for (auto name: {"print_int", "read_int", "print_str", "read_str", "strcmp", "strcat", "strlen", "print_float", "read_float"}) {
+        auto address = this->symtab.get_symbol(name).address;
+        if (address != 0)
+            this->function_entries[address] = name;
+    }
 }
 
 void InstructionsGenerator::gen_print_int() {
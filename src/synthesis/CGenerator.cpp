@@ -0,0 +1,899 @@
+#include <algorithm>
+#include <cstdio>
+#include "CGenerator.h"
+
+/** Runtime functions implementing the builtin functions */
+static const std::map<std::string, std::string> BuiltinFunctionsTable = {
+    {"print_int", "yadc_print_int"},
+    {"read_int", "yadc_read_int"},
+    {"print_str", "yadc_print_str"},
+    {"read_str", "yadc_read_str"},
+    {"strcmp", "yadc_strcmp"},
+    {"strcat", "yadc_strcat"},
+    {"strlen", "yadc_strlen"},
+    {"print_float", "yadc_print_float"},
+    {"read_float", "yadc_read_float"},
+};
+
+/**
+ * Returns kind of the C value of the type
+ * @param type Type
+ * @return Kind of the C value
+ */
+static CValueKind value_kind(ValueType type) {
+    if (type == VOID)
+        return C_VOID;
+    return type == FLOAT ? C_FLOAT : C_CELL;
+}
+
+/**
+ * Returns C type of the kind
+ * @param kind Kind of the C value
+ * @return C type
+ */
+static std::string c_type(CValueKind kind) {
+    if (kind == C_VOID)
+        return "void";
+    return kind == C_FLOAT ? "yadc_float" : "yadc_cell";
+}
+
+/**
+ * Returns zero of the kind
+ * @param kind Kind of the C value
+ * @return C expression
+ */
+static std::string c_zero(CValueKind kind) {
+    return kind == C_FLOAT ? "yadc_float_make(0, 0)" : "0";
+}
+
+/**
+ * Escapes the string for a C string literal
+ * @param value String
+ * @return Escaped string
+ */
+static std::string escape(const std::string &value) {
+    std::string escaped;
+    for (unsigned char character : value) {
+        if (character == '"' || character == '\\' || character == '?') {
+            escaped += '\\';
+            escaped += static_cast<char>(character);
+        } else if (character == '\n') {
+            escaped += "\\n";
+        } else if (character < 32 || character >= 127) {
+            char octal[5];
+            std::snprintf(octal, sizeof(octal), "\\%03o", character);
+            escaped += octal;
+        } else {
+            escaped += static_cast<char>(character);
+        }
+    }
+    return escaped;
+}
+
+/**
+ * Removes the parentheses around the assignment (for the expression statements)
+ * @param code C code of the assignment
+ * @return C code without the outer parentheses
+ */
+static std::string unparenthesize(const std::string &code) {
+    if (code.size() >= 2 && code.front() == '(' && code.back() == ')')
+        return code.substr(1, code.size() - 2);
+    return code;
+}
+
+/**
+ * Checks if the function needs its variables in a frame array (instead of the C locals),
+ * i.e. a variable is referenced by @ or the function declares nested functions
+ * @param node AST node of the function body
+ * @return True if the function needs the frame; False otherwise
+ */
+static bool needs_frame(ASTNode *node) {
+    if (node == nullptr)
+        return false;
+    if (dynamic_cast<ASTNodeDeclFunc *>(node) || dynamic_cast<ASTNodeReference *>(node))
+        return true;
+
+    if (auto *block = dynamic_cast<ASTNodeBlock *>(node))
+        return std::ranges::any_of(block->statements, [](ASTNodeStatement *statement) { return needs_frame(statement); });
+    if (auto *decl_var = dynamic_cast<ASTNodeDeclVar *>(node))
+        return needs_frame(decl_var->expression);
+    if (auto *if_stmt = dynamic_cast<ASTNodeIf *>(node))
+        return needs_frame(if_stmt->condition) || needs_frame(if_stmt->block) || needs_frame(if_stmt->else_block);
+    if (auto *while_stmt = dynamic_cast<ASTNodeWhile *>(node))
+        return needs_frame(while_stmt->condition) || needs_frame(while_stmt->block);
+    if (auto *for_stmt = dynamic_cast<ASTNodeFor *>(node))
+        return needs_frame(for_stmt->init) || needs_frame(for_stmt->condition) || needs_frame(for_stmt->increment) || needs_frame(for_stmt->block);
+    if (auto *return_stmt = dynamic_cast<ASTNodeReturn *>(node))
+        return needs_frame(return_stmt->expression);
+    if (auto *expression_stmt = dynamic_cast<ASTNodeExpressionStatement *>(node))
+        return needs_frame(expression_stmt->expression);
+    if (auto *assign = dynamic_cast<ASTNodeAssignExpression *>(node))
+        return needs_frame(assign->lvalue) || needs_frame(assign->expression);
+    if (auto *ternary = dynamic_cast<ASTNodeTernaryOperator *>(node))
+        return needs_frame(ternary->condition) || needs_frame(ternary->true_expression) || needs_frame(ternary->false_expression);
+    if (auto *bin_op = dynamic_cast<ASTNodeBinaryOperator *>(node))
+        return needs_frame(bin_op->left) || needs_frame(bin_op->right);
+    if (auto *un_op = dynamic_cast<ASTNodeUnaryOperator *>(node))
+        return needs_frame(un_op->expression);
+    if (auto *cast = dynamic_cast<ASTNodeCast *>(node))
+        return needs_frame(cast->expression);
+    if (auto *call_func = dynamic_cast<ASTNodeCallFunc *>(node))
+        return std::ranges::any_of(call_func->arguments, [](ASTNodeExpression *argument) { return needs_frame(argument); });
+    if (auto *new_expr = dynamic_cast<ASTNodeNew *>(node))
+        return needs_frame(new_expr->expression);
+    if (auto *delete_expr = dynamic_cast<ASTNodeDelete *>(node))
+        return needs_frame(delete_expr->expression);
+    if (auto *dereference = dynamic_cast<ASTNodeDereference *>(node))
+        return needs_frame(dereference->expression);
+    return false;
+}
+
+/**
+ * Generates integer binary operation (OPR)
+ * @param op Operator
+ * @param left Left operand
+ * @param right Right operand
+ * @return C expression
+ */
+static std::string cell_operation(const std::string &op, const std::string &left, const std::string &right) {
+    if (op == "+")
+        return "yadc_add(" + left + ", " + right + ")";
+    if (op == "-")
+        return "yadc_sub(" + left + ", " + right + ")";
+    if (op == "*")
+        return "yadc_mul(" + left + ", " + right + ")";
+    if (op == "/")
+        return "yadc_div(" + left + ", " + right + ")";
+    if (op == "%")
+        return "yadc_mod(" + left + ", " + right + ")";
+    if (op == "&&") /* AND: 1 * 1 = 1, 1 * 0 = 0, 0 * 1 = 0, 0 * 0 = 0 */
+        return "(yadc_mul(" + left + ", " + right + ") != 0)";
+    if (op == "||") /* OR: 1 + 1 = 2, 1 + 0 = 1, 0 + 1 = 1, 0 + 0 = 0 */
+        return "(yadc_add(" + left + ", " + right + ") != 0)";
+    /* Comparisons are the same in C */
+    return "(" + left + " " + op + " " + right + ")";
+}
+
+/**
+ * Generates float binary operation (OPF)
+ * @param op Operator
+ * @param left Left operand
+ * @param right Right operand
+ * @return C expression
+ */
+static std::string float_operation(const std::string &op, const std::string &left, const std::string &right) {
+    static const std::map<std::string, std::string> float_operations = {
+        {"+", "yadc_float_add"},
+        {"-", "yadc_float_sub"},
+        {"*", "yadc_float_mul"},
+        {"/", "yadc_float_div"},
+        {"%", "yadc_float_mod"},
+        {"==", "yadc_float_eq"},
+        {"!=", "yadc_float_neq"},
+        {"<", "yadc_float_lt"},
+        {">=", "yadc_float_geq"},
+        {">", "yadc_float_grt"},
+        {"<=", "yadc_float_leq"},
+    };
+    return float_operations.at(op) + "(" + left + ", " + right + ")";
+}
+
+CGenerator::CGenerator(ASTNodeBlock *global_block) :
+    global_block(global_block), symtab(), functions(), definitions(), contexts(), function_definitions(), globals_size(0),
+    expression(), code() {
+    /* Empty */
+}
+
+CGenerator::~CGenerator() = default;
+
+const std::string &CGenerator::get_code() const {
+    return this->code;
+}
+
+void CGenerator::generate(const std::string &statement) {
+    auto &context = this->contexts.back();
+    context.body += std::string(context.indentation * 4, ' ') + statement + "\n";
+}
+
+void CGenerator::register_label(ASTNodeStatement *node) {
+    if (!node->label.empty())
+        this->generate("label_" + node->label + ":;");
+}
+
+CExpression CGenerator::evaluate(ASTNodeExpression *node) {
+    node->accept(this);
+    return this->expression;
+}
+
+CExpression CGenerator::convert(CExpression value, CValueKind kind) {
+    if (value.kind == kind || value.kind == C_VOID || kind == C_VOID)
+        return value;
+
+    if (kind == C_FLOAT)
+        value.code = "yadc_itr(" + value.code + ", 0)";
+    else
+        value.code = "yadc_rti(" + value.code + ", 1)";
+    value.kind = kind;
+    return value;
+}
+
+std::string CGenerator::sequence(std::vector<CExpression> &operands) {
+    std::string prefix;
+    for (std::size_t i = 0; i + 1 < operands.size(); i++) {
+        /* Operand must be evaluated before the later side effects, its side effects before the later operands */
+        auto is_followed_by_effects = std::any_of(operands.begin() + i + 1, operands.end(), [](const CExpression &operand) { return operand.has_effects; });
+        auto is_followed_by_variables = std::any_of(operands.begin() + i + 1, operands.end(), [](const CExpression &operand) { return !operand.is_constant; });
+        if (operands[i].is_constant || operands[i].kind == C_VOID)
+            continue;
+        if (!is_followed_by_effects && !(operands[i].has_effects && is_followed_by_variables))
+            continue;
+
+        auto temporary = this->temporary(operands[i].kind);
+        prefix += temporary + " = " + operands[i].code + ", ";
+        operands[i].code = temporary;
+    }
+    return prefix;
+}
+
+std::string CGenerator::temporary(CValueKind kind) {
+    auto &context = this->contexts.back();
+    if (kind == C_FLOAT)
+        return "f" + std::to_string(++context.float_temporaries);
+    return "t" + std::to_string(++context.cell_temporaries);
+}
+
+void CGenerator::reserve_frame() {
+    auto &scope = this->symtab.get_current_scope();
+    auto size = scope.get_address_base() + scope.get_address_offset();
+    if (this->contexts.size() == 1)
+        this->globals_size = std::max(this->globals_size, size);
+    else
+        this->contexts.back().frame_size = std::max(this->contexts.back().frame_size, size);
+}
+
+std::string CGenerator::cell(uint32_t address) {
+    auto &context = this->contexts.back();
+    context.frame_size = std::max(context.frame_size, address + 1);
+    if (context.has_frame)
+        return "frame[" + std::to_string(address) + "]";
+
+    context.locals.insert(address);
+    return "s" + std::to_string(address);
+}
+
+std::string CGenerator::variable(const std::string &name, uint32_t offset) {
+    auto address = this->symtab.get_symbol(name).address + offset;
+    if (&this->symtab.get_scope(name) == &this->symtab.get_scope(0)) {
+        this->globals_size = std::max(this->globals_size, address + 1);
+        return "globals[" + std::to_string(address) + "]";
+    }
+
+    auto level = this->symtab.get_symbol_level(name);
+    if (level == 0)
+        return this->cell(address);
+    return this->frame(level) + "[" + std::to_string(address) + "]";
+}
+
+std::string CGenerator::frame(uint32_t level) {
+    if (level == 0)
+        return "frame";
+
+    std::string frame = "link";
+    for (auto i = 1u; i < level; i++)
+        frame = "YADC_LINK(" + frame + ")";
+    return frame;
+}
+
+std::string CGenerator::store(const std::string &name, const CExpression &value) {
+    auto &symbol = this->symtab.get_symbol(name);
+    if (symbol.type.type == float_t.type) {
+        auto temporary = this->temporary(C_FLOAT);
+        return temporary + " = " + convert(value, C_FLOAT).code + ", " +
+               this->variable(name, 0) + " = " + temporary + ".mantissa, " +
+               this->variable(name, 1) + " = " + temporary + ".exponent";
+    }
+    return this->variable(name, 0) + " = " + convert(value, C_CELL).code;
+}
+
+std::string CGenerator::function_declaration(uint32_t index) {
+    auto &function = this->functions[index];
+    std::string parameters;
+    if (function.is_nested)
+        parameters = "yadc_cell *link";
+    for (std::size_t i = 0; i < function.parameter_kinds.size(); i++) {
+        if (!parameters.empty())
+            parameters += ", ";
+        parameters += c_type(function.parameter_kinds[i]) + " p" + std::to_string(i);
+    }
+    if (parameters.empty())
+        parameters = "void";
+    return "static " + c_type(function.return_kind) + " " + function.name + "(" + parameters + ")";
+}
+
+std::string CGenerator::function_prologue(const CFunctionContext &context, bool is_nested) {
+    std::string prologue;
+    if (context.has_frame) {
+        prologue += "    yadc_cell frame[" + std::to_string(std::max(context.frame_size, 1u)) + "] = {0};\n";
+        if (is_nested)
+            prologue += "    frame[0] = (yadc_cell) (intptr_t) link;\n";
+    }
+    for (auto address : context.locals)
+        prologue += "    yadc_cell s" + std::to_string(address) + " = 0;\n";
+    for (auto i = 1u; i <= context.cell_temporaries; i++)
+        prologue += "    yadc_cell t" + std::to_string(i) + ";\n";
+    for (auto i = 1u; i <= context.float_temporaries; i++)
+        prologue += "    yadc_float f" + std::to_string(i) + ";\n";
+    return prologue;
+}
+
+void CGenerator::generate() {
+    this->symtab.insert_scope(0, ACTIVATION_RECORD_SIZE); /* Offset 3 for activation record */
+    this->symtab.init_builtin_functions();
+
+    for (auto &statement: this->global_block->statements) {
+        auto decl_func = dynamic_cast<ASTNodeDeclFunc *>(statement);
+        if (decl_func && decl_func->block)
+            this->definitions[decl_func->name] = decl_func;
+    }
+
+    /* Global code becomes the C main function, global variables live in the array globals */
+    this->contexts.push_back(CFunctionContext{-1, 0, false, 0, {}, 0, 0, 1, ""});
+    auto number_of_variables = this->global_block->get_number_of_declared_variables();
+    this->symtab.allocate_symbols(number_of_variables, this->global_block->get_sizeof_variables());
+    this->reserve_frame();
+
+    for (auto &statement: this->global_block->statements)
+        statement->accept(this);
+
+    auto &main_function = this->functions[this->symtab.get_symbol("main").address];
+    if (main_function.return_kind == C_VOID)
+        this->generate(main_function.name + "();");
+    else
+        this->generate("(void) " + main_function.name + "();");
+    this->generate("return yadc_finish();");
+
+    this->code = "/* Generated by yadc, link with the runtime: cc program.c yadc_runtime.c */\n";
+    this->code += "#include \"yadc_runtime.h\"\n\n";
+    if (this->globals_size > ACTIVATION_RECORD_SIZE)
+        this->code += "static yadc_cell globals[" + std::to_string(this->globals_size) + "];\n\n";
+    for (auto i = 0u; i < this->functions.size(); i++)
+        this->code += this->function_declaration(i) + ";\n";
+    this->code += "\n" + this->function_definitions;
+    this->code += "int main(void) {\n" + function_prologue(this->contexts.back(), false) + this->contexts.back().body + "}\n";
+    this->contexts.pop_back();
+}
+
+void CGenerator::visit(ASTNodeBlock *node) {
+    auto number_of_variables = node->get_number_of_declared_variables();
+    this->symtab.allocate_symbols(number_of_variables, node->get_sizeof_variables());
+    this->reserve_frame();
+
+    for (auto &statement: node->statements)
+        statement->accept(this);
+}
+
+void CGenerator::visit(ASTNodeDeclVar *node) {
+    this->register_label(node);
+
+    auto temp_name = this->symtab.get_first_empty_symbol(sizeof_val_type(str_to_val_type(node->type))).name;
+    this->symtab.change_symbol_name(temp_name, node->name);
+    auto &symbol = this->symtab.get_symbol(node->name);
+    symbol.type = {str_to_val_type(node->type), node->is_pointer, true};
+    symbol.is_const = node->is_const;
+
+    if (node->expression) {
+        symbol.type.is_pointing_to_stack = dynamic_cast<ASTNodeNew *>(node->expression) == nullptr;
+        if (auto *ref = dynamic_cast<ASTNodeReference *>(node->expression))
+            symbol.pointee = &this->symtab.get_symbol(ref->identifier);
+        else
+            symbol.pointee = nullptr;
+
+        auto value = this->evaluate(node->expression);
+        this->generate(this->store(node->name, value) + ";");
+    }
+}
+
+void CGenerator::visit(ASTNodeDeclFunc *node) {
+    this->register_label(node);
+
+    auto &symbol = this->symtab.get_symbol(node->name);
+    uint32_t index;
+    if (symbol.name.empty()) { /* Function was not yet declared */
+        index = this->functions.size();
+        /* Function declared as a header only gets the signature of its definition */
+        auto definition = node;
+        if (!node->block && this->contexts.size() == 1 && this->definitions.contains(node->name))
+            definition = this->definitions[node->name];
+
+        auto is_nested = this->contexts.size() > 1;
+        auto name = is_nested ? this->functions[this->contexts.back().function].name + "_" + node->name : "f_" + node->name;
+        std::vector<CValueKind> parameter_kinds;
+        for (auto &parameter: definition->parameters)
+            parameter_kinds.push_back(value_kind(str_to_val_type(parameter->type)));
+        this->functions.push_back(CFunction{name, value_kind(str_to_val_type(definition->return_type)), parameter_kinds, is_nested});
+
+        Type type{str_to_val_type(node->return_type), false, false};
+        this->symtab.insert_symbol(node->name, FUNCTION, type, false, index);
+        auto &func_symbol = this->symtab.get_symbol(node->name);
+        for (auto &parameter: node->parameters) {
+            Type param_type{str_to_val_type(parameter->type), parameter->is_pointer, false};
+            func_symbol.parameters.push_back({parameter->name, VARIABLE, param_type, false});
+        }
+    } else { /* Function was earlier declared as a header only */
+        index = symbol.address;
+    }
+
+    if (!node->block)
+        return;
+
+    this->symtab.insert_scope(0, ACTIVATION_RECORD_SIZE, true); /* Offset 3 for activation record */
+    auto depth = this->contexts.back().depth + 1;
+    this->contexts.push_back(CFunctionContext{static_cast<int>(index), depth, needs_frame(node->block), 1, {}, 0, 0, 1, ""});
+
+    for (auto &parameter: node->parameters) {
+        Type type{str_to_val_type(parameter->type), parameter->is_pointer, false};
+        this->symtab.insert_symbol(parameter->name, VARIABLE, type, false);
+    }
+    this->reserve_frame();
+
+    /* Parameters are copied into the frame like in the PL/0 code (they can be assigned) */
+    for (std::size_t i = 0; i < node->parameters.size(); i++) {
+        auto parameter = "p" + std::to_string(i);
+        auto &name = node->parameters[i]->name;
+        if (str_to_val_type(node->parameters[i]->type) == float_t.type) {
+            this->generate(this->variable(name, 0) + " = " + parameter + ".mantissa;");
+            this->generate(this->variable(name, 1) + " = " + parameter + ".exponent;");
+        } else {
+            this->generate(this->variable(name, 0) + " = " + parameter + ";");
+        }
+    }
+
+    node->block->accept(this);
+
+    /* PL/0 code of a function without return continues after the function, C function returns zero */
+    auto return_kind = this->functions[index].return_kind;
+    if (return_kind != C_VOID && !node->block->contains_return_statement())
+        this->generate("return " + c_zero(return_kind) + ";");
+
+    this->symtab.remove_scope();
+
+    auto context = std::move(this->contexts.back());
+    this->contexts.pop_back();
+    this->function_definitions += this->function_declaration(index) + " {\n" +
+                                  function_prologue(context, this->functions[index].is_nested) + context.body + "}\n\n";
+}
+
+void CGenerator::visit(ASTNodeIf *node) {
+    this->register_label(node);
+
+    auto &current_scope = this->symtab.get_current_scope();
+    auto new_base = current_scope.get_address_base() + current_scope.get_address_offset();
+    this->symtab.insert_scope(new_base, 0, false);
+    auto condition = convert(this->evaluate(node->condition), C_CELL);
+
+    this->generate("if (" + unparenthesize(condition.code) + ") {");
+    this->contexts.back().indentation++;
+    node->block->accept(this);
+    this->contexts.back().indentation--;
+    this->symtab.remove_scope();
+
+    if (node->else_block) {
+        auto &current_scope = this->symtab.get_current_scope();
+        auto new_base = current_scope.get_address_base() + current_scope.get_address_offset();
+        this->symtab.insert_scope(new_base, 0, false);
+
+        this->generate("} else {");
+        this->contexts.back().indentation++;
+        node->else_block->accept(this);
+        this->contexts.back().indentation--;
+        this->symtab.remove_scope();
+    }
+    this->generate("}");
+}
+
+void CGenerator::visit(ASTNodeWhile *node) {
+    this->register_label(node);
+
+    auto &current_scope = this->symtab.get_current_scope();
+    auto new_base = current_scope.get_address_base() + current_scope.get_address_offset();
+    this->symtab.insert_scope(new_base, 0, false);
+
+    if (node->is_do_while) {
+        this->generate("do {");
+        this->contexts.back().indentation++;
+        node->block->accept(this);
+        this->contexts.back().indentation--;
+
+        auto condition = convert(this->evaluate(node->condition), C_CELL);
+        if (node->is_repeat_until)
+            this->generate("} while (" + condition.code + " == 0);");
+        else
+            this->generate("} while (" + unparenthesize(condition.code) + ");");
+    } else {
+        auto condition = convert(this->evaluate(node->condition), C_CELL);
+        if (node->is_repeat_until)
+            this->generate("while (" + condition.code + " == 0) {");
+        else
+            this->generate("while (" + unparenthesize(condition.code) + ") {");
+
+        this->contexts.back().indentation++;
+        node->block->accept(this);
+        this->contexts.back().indentation--;
+        this->generate("}");
+    }
+
+    this->symtab.remove_scope();
+}
+
+void CGenerator::visit(ASTNodeFor *node) {
+    this->register_label(node);
+
+    auto &current_scope = this->symtab.get_current_scope();
+    auto new_base = current_scope.get_address_base() + current_scope.get_address_offset();
+    this->symtab.insert_scope(new_base, 0, false);
+
+    if (auto decl_var = dynamic_cast<ASTNodeDeclVar *>(node->init)) {
+        Type type{str_to_val_type(decl_var->type), decl_var->is_pointer, true};
+        this->symtab.allocate_symbols(1, {type.size});
+        this->reserve_frame();
+    }
+    node->init->accept(this);
+
+    auto condition = convert(this->evaluate(node->condition), C_CELL);
+
+    /* Header of the loop is inserted after the increment is generated (it follows the block in the PL/0 code) */
+    auto &context = this->contexts.back();
+    auto header_position = context.body.size();
+    context.indentation++;
+    node->block->accept(this);
+    auto increment = this->evaluate(node->increment);
+    this->contexts.back().indentation--;
+
+    auto header = "for (; " + unparenthesize(condition.code) + "; " + unparenthesize(increment.code) + ") {\n";
+    this->contexts.back().body.insert(header_position, std::string(this->contexts.back().indentation * 4, ' ') + header);
+    this->generate("}");
+
+    this->symtab.remove_scope();
+}
+
+void CGenerator::visit(ASTNodeBreakContinue *node) {
+    this->register_label(node);
+    this->generate(node->is_break ? "break;" : "continue;");
+}
+
+void CGenerator::visit(ASTNodeReturn *node) {
+    this->register_label(node);
+
+    auto return_kind = this->functions[this->contexts.back().function].return_kind;
+    if (!node->expression) {
+        this->generate(return_kind == C_VOID ? "return;" : "return " + c_zero(return_kind) + ";");
+        return;
+    }
+
+    auto value = this->evaluate(node->expression);
+    if (return_kind == C_VOID) {
+        this->generate("(void) " + value.code + ";");
+        this->generate("return;");
+    } else {
+        this->generate("return " + convert(value, return_kind).code + ";");
+    }
+}
+
+void CGenerator::visit(ASTNodeGoto *node) {
+    this->register_label(node);
+    this->generate("goto label_" + node->label_to_go_to + ";");
+}
+
+void CGenerator::visit(ASTNodeExpressionStatement *node) {
+    this->register_label(node);
+
+    auto value = this->evaluate(node->expression);
+    if (dynamic_cast<ASTNodeAssignExpression *>(node->expression))
+        this->generate(unparenthesize(value.code) + ";");
+    else if (value.kind == C_VOID)
+        this->generate(value.code + ";");
+    else
+        this->generate("(void) " + value.code + ";");
+}
+
+void CGenerator::visit(ASTNodeIdentifier *node) {
+    auto &symbol = this->symtab.get_symbol(node->name);
+    if (symbol.type.type == float_t.type)
+        this->expression = {"yadc_float_make(" + this->variable(node->name, 0) + ", " + this->variable(node->name, 1) + ")", C_FLOAT, false, false};
+    else
+        this->expression = {this->variable(node->name, 0), C_CELL, false, false};
+}
+
+void CGenerator::visit(ASTNodeIntLiteral *node) {
+    this->expression = {std::to_string(node->value), C_CELL, false, true};
+}
+
+void CGenerator::visit(ASTNodeFloatLiteral *node) {
+    /* Parts of the float are computed the same way as in the PL/0 code */
+    auto whole_part = (int) node->value;
+    auto fractional_part = std::to_string(node->value);
+
+    /* Erase everything up to the first dot */
+    fractional_part.erase(0, fractional_part.find('.') + 1);
+    while (fractional_part[fractional_part.length() - 1] == '0')
+        fractional_part.erase(fractional_part.length() - 1, 1);
+    if (fractional_part.empty())
+        fractional_part = "0";
+
+    auto fractional_part_int = std::stoi(fractional_part);
+    this->expression = {"yadc_itr(" + std::to_string(whole_part) + ", " + std::to_string(fractional_part_int) + ")", C_FLOAT, false, true};
+}
+
+void CGenerator::visit(ASTNodeBoolLiteral *node) {
+    this->expression = {node->value ? "1" : "0", C_CELL, false, true};
+}
+
+void CGenerator::visit(ASTNodeStringLiteral *node) {
+    this->expression = {"yadc_string(\"" + escape(node->value) + "\", " + std::to_string(node->value.length()) + ")", C_CELL, true, false};
+}
+
+void CGenerator::visit(ASTNodeAssignExpression *node) {
+    if (auto dereference = dynamic_cast<ASTNodeDereference *>(node->lvalue)) {
+        auto &symbol = this->symtab.get_symbol(dereference->identifier);
+        if (symbol.type.is_pointing_to_stack) {
+            /* Value is evaluated before the address (PST) */
+            auto value = convert(this->evaluate(node->expression), C_CELL);
+            auto level = 0u;
+            if (symbol.pointee)
+                level = this->symtab.get_symbol_level(symbol.pointee->name);
+            auto address = convert(this->evaluate(node->lvalue), C_CELL);
+
+            std::vector<CExpression> operands{value, address};
+            auto prefix = this->sequence(operands);
+            auto &context = this->contexts.back();
+            std::string store;
+            if (level == context.depth)
+                store = "globals[" + operands[1].code + "] = " + operands[0].code;
+            else if (level > 0 || context.has_frame)
+                store = this->frame(level) + "[" + operands[1].code + "] = " + operands[0].code;
+            else /* Pointer does not point into this function, the function has no frame */
+                store = "yadc_error(\"store through a pointer to a variable of another function\")";
+            this->expression = {"(" + prefix + store + ")", C_VOID, true, false};
+        } else {
+            /* Address is evaluated before the value (STA) */
+            auto address = convert(this->evaluate(node->lvalue), C_CELL);
+            auto value = convert(this->evaluate(node->expression), C_CELL);
+
+            std::vector<CExpression> operands{address, value};
+            auto prefix = this->sequence(operands);
+            this->expression = {"(" + prefix + "yadc_sta(" + operands[0].code + ", " + operands[1].code + "))", C_VOID, true, false};
+        }
+        return;
+    }
+
+    auto &symbol = this->symtab.get_symbol(node->name);
+    symbol.type.is_pointing_to_stack = dynamic_cast<ASTNodeNew *>(node->expression) == nullptr;
+    if (auto *ref = dynamic_cast<ASTNodeReference *>(node->expression))
+        symbol.pointee = &this->symtab.get_symbol(ref->identifier);
+    else
+        symbol.pointee = nullptr;
+
+    auto value = this->evaluate(node->expression);
+    this->expression = {"(" + this->store(node->name, value) + ")", C_VOID, true, false};
+}
+
+void CGenerator::visit(ASTNodeTernaryOperator *node) {
+    auto condition = convert(this->evaluate(node->condition), C_CELL);
+    auto true_value = this->evaluate(node->true_expression);
+    auto false_value = this->evaluate(node->false_expression);
+
+    auto kind = true_value.kind == C_FLOAT || false_value.kind == C_FLOAT ? C_FLOAT : true_value.kind;
+    true_value = convert(true_value, kind);
+    false_value = convert(false_value, kind);
+    this->expression = {"(" + condition.code + " ? " + true_value.code + " : " + false_value.code + ")", kind,
+                        condition.has_effects || true_value.has_effects || false_value.has_effects, false};
+}
+
+void CGenerator::visit(ASTNodeBinaryOperator *node) {
+    if (node->is_pointer_arithmetic) {
+        /* Integer operand is multiplied by the size of the pointed type */
+        std::vector<CExpression> operands;
+        std::string size;
+        if (auto left_id = dynamic_cast<ASTNodeIdentifier *>(node->left)) {
+            size = std::to_string(this->symtab.get_symbol(left_id->name).type.size);
+            operands.push_back(convert(this->evaluate(node->left), C_CELL));
+            operands.push_back(convert(this->evaluate(node->right), C_CELL));
+        } else if (auto right_id = dynamic_cast<ASTNodeIdentifier *>(node->right)) {
+            size = std::to_string(this->symtab.get_symbol(right_id->name).type.size);
+            operands.push_back(convert(this->evaluate(node->right), C_CELL));
+            operands.push_back(convert(this->evaluate(node->left), C_CELL));
+        } else {
+            operands.push_back(convert(this->evaluate(node->left), C_CELL));
+            operands.push_back(convert(this->evaluate(node->right), C_CELL));
+        }
+
+        auto has_effects = operands[0].has_effects || operands[1].has_effects;
+        auto prefix = this->sequence(operands);
+        auto right = size.empty() || size == "1" ? operands[1].code : "yadc_mul(" + operands[1].code + ", " + size + ")";
+        auto code = cell_operation(node->op, operands[0].code, right);
+        this->expression = {prefix.empty() ? code : "(" + prefix + code + ")", C_CELL, has_effects, false};
+        return;
+    }
+
+    /* Float arithmetic is detected the same way as in the PL/0 code */
+    bool is_float = node->is_float_arithmetic;
+    if (auto left_id = dynamic_cast<ASTNodeIdentifier *>(node->left)) {
+        if (this->symtab.get_symbol(left_id->name).type.type == float_t.type)
+            is_float = true;
+    } else if (auto left_call = dynamic_cast<ASTNodeCallFunc *>(node->left)) {
+        if (this->symtab.get_symbol(left_call->name).type.type == float_t.type)
+            is_float = true;
+    } else if (dynamic_cast<ASTNodeFloatLiteral *>(node->left))
+        is_float = true;
+    if (auto right_id = dynamic_cast<ASTNodeIdentifier *>(node->right)) {
+        if (this->symtab.get_symbol(right_id->name).type.type == float_t.type)
+            is_float = true;
+    } else if (auto right_call = dynamic_cast<ASTNodeCallFunc *>(node->right)) {
+        if (this->symtab.get_symbol(right_call->name).type.type == float_t.type)
+            is_float = true;
+    } else if (dynamic_cast<ASTNodeFloatLiteral *>(node->right))
+        is_float = true;
+    node->is_float_arithmetic = is_float;
+    node->propagate_float();
+
+    std::vector<CExpression> operands{this->evaluate(node->left), this->evaluate(node->right)};
+    auto has_effects = operands[0].has_effects || operands[1].has_effects || node->op == "/" || node->op == "%";
+    is_float = is_float || operands[0].kind == C_FLOAT || operands[1].kind == C_FLOAT;
+    /* It doesn't even make sense to AND or OR floats */
+    if (node->op == "&&" || node->op == "||")
+        is_float = false;
+
+    /* Implicit casting */
+    for (auto &operand: operands)
+        operand = convert(operand, is_float ? C_FLOAT : C_CELL);
+    auto prefix = this->sequence(operands);
+
+    std::string code;
+    auto kind = C_CELL;
+    if (is_float) {
+        code = float_operation(node->op, operands[0].code, operands[1].code);
+        if (node->op == "+" || node->op == "-" || node->op == "*" || node->op == "/" || node->op == "%")
+            kind = C_FLOAT;
+    } else {
+        code = cell_operation(node->op, operands[0].code, operands[1].code);
+    }
+    this->expression = {prefix.empty() ? code : "(" + prefix + code + ")", kind, has_effects, false};
+}
+
+void CGenerator::visit(ASTNodeUnaryOperator *node) {
+    auto value = this->evaluate(node->expression);
+
+    if (node->op == "!") { /* NOT: true == 0 => false, false == 0 => true */
+        value = convert(value, C_CELL);
+        this->expression = {"(" + value.code + " == 0)", C_CELL, value.has_effects, false};
+    } else if (node->op == "-" && value.kind == C_FLOAT) {
+        this->expression = {"yadc_float_negate_exponent(" + value.code + ")", C_FLOAT, value.has_effects, false};
+    } else if (node->op == "-") {
+        this->expression = {"yadc_sub(0, " + value.code + ")", C_CELL, value.has_effects, false};
+    } else {
+        this->expression = value;
+    }
+}
+
+ValueType CGenerator::cast_source_type(ASTNodeExpression *node) {
+    if (auto id = dynamic_cast<ASTNodeIdentifier *>(node))
+        return this->symtab.get_symbol(id->name).type.type;
+    if (dynamic_cast<ASTNodeIntLiteral *>(node))
+        return int_t.type;
+    if (dynamic_cast<ASTNodeFloatLiteral *>(node))
+        return float_t.type;
+    if (dynamic_cast<ASTNodeBoolLiteral *>(node))
+        return bool_t.type;
+    if (auto bin_op = dynamic_cast<ASTNodeBinaryOperator *>(node)) {
+        auto is_float = bin_op->is_float_arithmetic;
+        if (auto left_id = dynamic_cast<ASTNodeIdentifier *>(bin_op->left)) {
+            if (this->symtab.get_symbol(left_id->name).type.type == float_t.type)
+                is_float = true;
+        }
+        if (auto right_id = dynamic_cast<ASTNodeIdentifier *>(bin_op->right)) {
+            if (this->symtab.get_symbol(right_id->name).type.type == float_t.type)
+                is_float = true;
+        }
+        bin_op->propagate_float();
+        is_float = is_float || bin_op->is_float_arithmetic;
+        return is_float ? float_t.type : int_t.type;
+    }
+    if (auto un_op = dynamic_cast<ASTNodeUnaryOperator *>(node))
+        return un_op->op == "-" ? int_t.type : bool_t.type;
+    if (auto call_func = dynamic_cast<ASTNodeCallFunc *>(node))
+        return this->symtab.get_symbol(call_func->name).type.type;
+    if (auto dereference = dynamic_cast<ASTNodeDereference *>(node))
+        return this->symtab.get_symbol(dereference->identifier).type.type;
+    if (auto reference = dynamic_cast<ASTNodeReference *>(node))
+        return this->symtab.get_symbol(reference->identifier).type.type;
+    if (auto sizeof_op = dynamic_cast<ASTNodeSizeof *>(node))
+        return str_to_val_type(sizeof_op->type);
+    return undefined_t.type;
+}
+
+void CGenerator::visit(ASTNodeCast *node) {
+    auto casting_from = this->cast_source_type(node->expression);
+    auto casting_to = str_to_val_type(node->type);
+    auto value = this->evaluate(node->expression);
+
+    if (casting_to == float_t.type) {
+        this->expression = convert(value, C_FLOAT);
+    } else if (casting_to == int_t.type) {
+        this->expression = convert(value, C_CELL);
+    } else if (casting_to == bool_t.type && (value.kind == C_FLOAT || casting_from == int_t.type)) {
+        value = convert(value, C_CELL);
+        this->expression = {"(" + value.code + " != 0)", C_CELL, value.has_effects, false};
+    } else {
+        this->expression = value;
+    }
+}
+
+void CGenerator::visit(ASTNodeCallFunc *node) {
+    auto &symbol = this->symtab.get_symbol(node->name);
+
+    std::string name;
+    std::string link;
+    CValueKind return_kind;
+    std::vector<CValueKind> parameter_kinds;
+    if (auto builtin = BuiltinFunctionsTable.find(node->name); builtin != BuiltinFunctionsTable.end()) {
+        name = builtin->second;
+        return_kind = value_kind(symbol.type.type);
+        for (auto &parameter: symbol.parameters)
+            parameter_kinds.push_back(value_kind(parameter.type.type));
+    } else {
+        auto &function = this->functions[symbol.address];
+        name = function.name;
+        return_kind = function.return_kind;
+        parameter_kinds = function.parameter_kinds;
+        /* Static link is the frame of the function the called function is declared in */
+        if (function.is_nested)
+            link = this->frame(this->symtab.get_symbol_level(node->name));
+    }
+
+    std::vector<CExpression> arguments;
+    for (std::size_t i = 0; i < node->arguments.size(); i++) {
+        auto argument = this->evaluate(node->arguments[i]);
+        arguments.push_back(i < parameter_kinds.size() ? convert(argument, parameter_kinds[i]) : argument);
+    }
+    auto prefix = this->sequence(arguments);
+
+    auto code = name + "(" + link;
+    for (std::size_t i = 0; i < arguments.size(); i++)
+        code += (i > 0 || !link.empty() ? ", " : "") + arguments[i].code;
+    code += ")";
+    this->expression = {prefix.empty() ? code : "(" + prefix + code + ")", return_kind, true, false};
+}
+
+void CGenerator::visit(ASTNodeNew *node) {
+    /* Size of the block is stored in front of it by the runtime */
+    auto size = sizeof_val_type(str_to_val_type(node->type));
+    auto count = convert(this->evaluate(node->expression), C_CELL);
+    auto cells = size == 1 ? count.code : "yadc_mul(" + count.code + ", " + std::to_string(size) + ")";
+    this->expression = {"yadc_new(" + cells + ")", C_CELL, true, false};
+}
+
+void CGenerator::visit(ASTNodeDelete *node) {
+    auto address = convert(this->evaluate(node->expression), C_CELL);
+    this->expression = {"yadc_delete(" + address.code + ")", C_VOID, true, false};
+}
+
+void CGenerator::visit(ASTNodeDereference *node) {
+    if (auto binary_op = dynamic_cast<ASTNodeBinaryOperator *>(node->expression))
+        binary_op->is_pointer_arithmetic = true;
+    auto address = convert(this->evaluate(node->expression), C_CELL);
+
+    /* Lvalue is the address itself, rvalue is always loaded from the heap (same as the PL/0 code) */
+    if (node->is_lvalue)
+        this->expression = address;
+    else
+        this->expression = {"yadc_lda(" + address.code + ")", C_CELL, true, false};
+}
+
+void CGenerator::visit(ASTNodeReference *node) {
+    auto address = this->symtab.get_symbol(node->identifier).address;
+    this->expression = {std::to_string(address), C_CELL, false, true};
+}
+
+void CGenerator::visit(ASTNodeSizeof *node) {
+    this->expression = {std::to_string(sizeof_val_type(str_to_val_type(node->type))), C_CELL, false, true};
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include "AbstractSyntaxTree.h"
+#include "SymbolTable.h"
+
+/**
+ * Enum representing kinds of the C values
+ */
+enum CValueKind {
+    C_VOID,
+    C_CELL,
+    C_FLOAT
+};
+
+/**
+ * Structure representing a generated C expression
+ */
+typedef struct CExpression {
+    /** C code of the expression */
+    std::string code;
+    /** Kind of the value of the expression */
+    CValueKind kind;
+    /** Flag if evaluation of the expression has side effects (calls, assignments, heap, runtime errors) */
+    bool has_effects;
+    /** Flag if the expression is a constant */
+    bool is_constant;
+} CExpression;
+
+/**
+ * Structure representing a C function generated from a YADC function
+ */
+typedef struct CFunction {
+    /** Name of the C function */
+    std::string name;
+    /** Kind of the return value */
+    CValueKind return_kind;
+    /** Kinds of the parameters */
+    std::vector<CValueKind> parameter_kinds;
+    /** Flag if the function is nested (gets the frame of the enclosing function as the static link) */
+    bool is_nested;
+} CFunction;
+
+/**
+ * Structure representing a C function being generated
+ */
+typedef struct CFunctionContext {
+    /** Index of the function (-1 for the global code) */
+    int function;
+    /** Number of the function scopes (0 for the global code) */
+    uint32_t depth;
+    /** Flag if the variables live in a frame array (they are referenced by @ or accessed by the nested functions) */
+    bool has_frame;
+    /** Size of the frame (in cells) */
+    uint32_t frame_size;
+    /** Addresses of the variables kept in the C locals (functions without the frame) */
+    std::set<uint32_t> locals;
+    /** Number of the cell temporaries */
+    uint32_t cell_temporaries;
+    /** Number of the float temporaries */
+    uint32_t float_temporaries;
+    /** Indentation of the generated statements */
+    int indentation;
+    /** Generated statements */
+    std::string body;
+} CFunctionContext;
+
+/**
+ * Class for C code generation (ahead-of-time compilation of the program to portable C)
+ * Inherits from ASTVisitor to traverse the AST
+ * Variables have the same addresses as in the PL/0 code, so pointers to the stack work the same way
+ * Every YADC function becomes a C function, nested functions get the frame of the enclosing function as the static link
+ * The generated code is linked with the runtime (src/runtime/yadc_runtime.c)
+ */
+class CGenerator : public ASTVisitor {
+private:
+    /** Root of the AST */
+    ASTNodeBlock *global_block;
+    /** Symbol table */
+    SymbolTable symtab;
+    /** Generated functions (address of the function symbol is the index) */
+    std::vector<CFunction> functions;
+    /** Definitions of the global functions (used for the functions declared as a header only) */
+    std::map<std::string, ASTNodeDeclFunc *> definitions;
+    /** Stack of the functions being generated */
+    std::vector<CFunctionContext> contexts;
+    /** Generated definitions of the functions */
+    std::string function_definitions;
+    /** Size of the global variables (in cells) */
+    uint32_t globals_size;
+    /** Last generated expression */
+    CExpression expression;
+    /** Generated C code */
+    std::string code;
+
+    /**
+     * Generate statement
+     * @param statement C statement
+     */
+    void generate(const std::string &statement);
+    /**
+     * Generate label of the statement
+     * @param node AST node with label
+     */
+    void register_label(ASTNodeStatement *node);
+    /**
+     * Generate expression
+     * @param node AST node of the expression
+     * @return Generated expression
+     */
+    CExpression evaluate(ASTNodeExpression *node);
+    /**
+     * Converts the value of the expression (int to float or float to its whole part)
+     * @param value Expression
+     * @param kind Kind of the value
+     * @return Converted expression
+     */
+    static CExpression convert(CExpression value, CValueKind kind);
+    /**
+     * Preserves the left to right evaluation of the PL/0 code - operands followed by an operand
+     * with side effects are stored into temporaries first
+     * @param operands Operands (their code is replaced by the temporaries)
+     * @return Code storing the operands into the temporaries (empty or ending with ", ")
+     */
+    std::string sequence(std::vector<CExpression> &operands);
+    /**
+     * Creates a new temporary of the current function
+     * @param kind Kind of the temporary
+     * @return Name of the temporary
+     */
+    std::string temporary(CValueKind kind);
+    /**
+     * Updates size of the frame of the current function by the variables of the current scope
+     */
+    void reserve_frame();
+    /**
+     * Returns C lvalue of the cell of the current function
+     * @param address Address of the cell
+     * @return C lvalue
+     */
+    std::string cell(uint32_t address);
+    /**
+     * Returns C lvalue of the cell of the variable
+     * @param name Name of the variable
+     * @param offset Offset of the cell (1 for the exponent of the float)
+     * @return C lvalue
+     */
+    std::string variable(const std::string &name, uint32_t offset);
+    /**
+     * Returns frame of the function the given number of levels up the static links
+     * @param level Level
+     * @return C expression of the frame
+     */
+    std::string frame(uint32_t level);
+    /**
+     * Generates store of the value into the variable
+     * @param name Name of the variable
+     * @param value Stored value
+     * @return C expression of the store (not parenthesized)
+     */
+    std::string store(const std::string &name, const CExpression &value);
+    /**
+     * Returns source type of the cast the same way the PL/0 generator determines it
+     * @param node Casted expression
+     * @return Source type of the cast
+     */
+    ValueType cast_source_type(ASTNodeExpression *node);
+    /**
+     * Returns C declaration of the function
+     * @param index Index of the function
+     * @return C declaration (without the semicolon)
+     */
+    std::string function_declaration(uint32_t index);
+    /**
+     * Returns C declarations of the variables and temporaries of the function
+     * @param context Generated function
+     * @param is_nested Flag if the function is nested
+     * @return C declarations
+     */
+    static std::string function_prologue(const CFunctionContext &context, bool is_nested);
+
+public:
+    /**
+     * Constructor
+     * @param global_block Root of the AST
+     */
+    explicit CGenerator(ASTNodeBlock *global_block);
+    /**
+     * Destructor
+     */
+    ~CGenerator() override;
+
+    /**
+     * Generate C code
+     */
+    void generate();
+    /**
+     * Get generated C code
+     * @return C code
+     */
+    [[nodiscard]] const std::string &get_code() const;
+
+    /* ASTVisitor methods */
+    void visit(ASTNodeBlock *node) override;
+    void visit(ASTNodeDeclVar *node) override;
+    void visit(ASTNodeDeclFunc *node) override;
+    void visit(ASTNodeIf *node) override;
+    void visit(ASTNodeWhile *node) override;
+    void visit(ASTNodeFor *node) override;
+    void visit(ASTNodeBreakContinue *node) override;
+    void visit(ASTNodeReturn *node) override;
+    void visit(ASTNodeGoto *node) override;
+    void visit(ASTNodeExpressionStatement *node) override;
+    void visit(ASTNodeIdentifier *node) override;
+    void visit(ASTNodeIntLiteral *node) override;
+    void visit(ASTNodeBoolLiteral *node) override;
+    void visit(ASTNodeStringLiteral *node) override;
+    void visit(ASTNodeFloatLiteral *node) override;
+    void visit(ASTNodeAssignExpression *node) override;
+    void visit(ASTNodeTernaryOperator *node) override;
+    void visit(ASTNodeBinaryOperator *node) override;
+    void visit(ASTNodeUnaryOperator *node) override;
+    void visit(ASTNodeCast *node) override;
+    void visit(ASTNodeCallFunc *node) override;
+    void visit(ASTNodeNew *node) override;
+    void visit(ASTNodeDelete *node) override;
+    void visit(ASTNodeDereference *node) override;
+    void visit(ASTNodeReference *node) override;
+    void visit(ASTNodeSizeof *node) override;
+};
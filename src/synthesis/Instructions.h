@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+/**
+ * Enum for instructions
+ */
+enum InstructionIndex {
+    PL0_LIT = 0,
+    PL0_OPR,
+    PL0_LOD,
+    PL0_STO,
+    PL0_CAL,
+    PL0_INT,
+    PL0_JMP,
+    PL0_JMC,
+    PL0_RET,
+    PL0_REA,
+    PL0_WRI,
+    PL0_NEW,
+    PL0_DEL,
+    PL0_LDA,
+    PL0_STA,
+    PL0_PLD,
+    PL0_PST,
+    PL0_ITR,
+    PL0_RTI,
+    PL0_OPF,
+    PL0_NUM_OF_INSTRUCTIONS /* This is fine trick, but it is unused in this project :( */
+};
+
+/**
+ * Enum for different OPR parameters
+ */
+enum Oprs {
+    PL0_NEG = 1,
+    PL0_ADD,
+    PL0_SUB,
+    PL0_MUL,
+    PL0_DIV,
+    PL0_MOD,
+    PL0_ODD,
+    PL0_EQ,
+    PL0_NEQ,
+    PL0_LT,
+    PL0_GEQ,
+    PL0_GRT,
+    PL0_LEQ
+};
+
+/**
+ * Map for operators and their OPR parameters
+ */
+static const std::map<std::string, Oprs> OperatorsTable = {
+    {"+", PL0_ADD},
+    {"-", PL0_SUB},
+    {"*", PL0_MUL},
+    {"/", PL0_DIV},
+    {"%", PL0_MOD},
+    {"==", PL0_EQ},
+    {"!=", PL0_NEQ},
+    {"<", PL0_LT},
+    {">=", PL0_GEQ},
+    {">", PL0_GRT},
+    {"<=", PL0_LEQ}
+};
+
+/**
+ * Map for instructions and their names
+ */
+static const char * const InstructionsTable[] = {
+    [PL0_LIT] = "LIT",
+    [PL0_OPR] = "OPR",
+    [PL0_LOD] = "LOD",
+    [PL0_STO] = "STO",
+    [PL0_CAL] = "CAL",
+    [PL0_INT] = "INT",
+    [PL0_JMP] = "JMP",
+    [PL0_JMC] = "JMC",
+    [PL0_RET] = "RET",
+    [PL0_REA] = "REA",
+    [PL0_WRI] = "WRI",
+    [PL0_NEW] = "NEW",
+    [PL0_DEL] = "DEL",
+    [PL0_LDA] = "LDA",
+    [PL0_STA] = "STA",
+    [PL0_PLD] = "PLD",
+    [PL0_PST] = "PST",
+    [PL0_ITR] = "ITR",
+    [PL0_RTI] = "RTI",
+    [PL0_OPF] = "OPF"
+};
+
+/**
+ * Struct for instruction
+ */
+typedef struct Instruction {
+    /** Line number */
+    uint32_t line;
+    /** Instruction */
+    std::string instruction;
+    /** Level */
+    int level;
+    /** Parameter */
+    int parameter;
+} Instruction;
@@ -2,7 +2,7 @@
 
 InstructionsGenerator::InstructionsGenerator(ASTNodeBlock *global_block, std::vector<std::string> &used_builtin_functions) :
     global_block(global_block), used_builtin_functions(used_builtin_functions), instructions(), instruction_counter(0), symtab(),
-    declared_functions(), break_stack(), continue_stack(), sizeof_params_stack(), sizeof_return_type_stack(), sizeof_arguments_stack(),
+    declared_functions(), function_entries(), break_stack(), continue_stack(), sizeof_params_stack(), sizeof_return_type_stack(), sizeof_arguments_stack(),
     labels_to_line(), goto_labels_line() {
     /* Empty */
 }
@@ -21,6 +21,10 @@ std::vector<Instruction> &InstructionsGenerator::get_instructions() {
     return this->instructions;
 }
 
+std::map<uint32_t, std::string> &InstructionsGenerator::get_function_entries() {
+    return this->function_entries;
+}
+
 Instruction &InstructionsGenerator::get_instruction(std::uint32_t index) {
     return this->instructions[index];
 }
@@ -164,6 +168,7 @@ void InstructionsGenerator::visit(ASTNodeDeclFunc *node) {
     }
 
     if (node->block) {
+        this->function_entries[func_address] = node->name;
         this->symtab.insert_scope(0, ACTIVATION_RECORD_SIZE, true); /* Offset 3 for activation record */
         auto &func_symbol = this->symtab.get_symbol(node->name);
         this->generate(PL0_INT, 0, ACTIVATION_RECORD_SIZE);
@@ -6,109 +6,7 @@
 #include <map>
 #include "AbstractSyntaxTree.h"
 #include "SymbolTable.h"
-
-/**
- * Enum for instructions
- */
-enum InstructionIndex {
-    PL0_LIT = 0,
-    PL0_OPR,
-    PL0_LOD,
-    PL0_STO,
-    PL0_CAL,
-    PL0_INT,
-    PL0_JMP,
-    PL0_JMC,
-    PL0_RET,
-    PL0_REA,
-    PL0_WRI,
-    PL0_NEW,
-    PL0_DEL,
-    PL0_LDA,
-    PL0_STA,
-    PL0_PLD,
-    PL0_PST,
-    PL0_ITR,
-    PL0_RTI,
-    PL0_OPF,
-    PL0_NUM_OF_INSTRUCTIONS /* This is fine trick, but it is unused in this project :( */
-};
-
-/**
- * Enum for different OPR parameters
- */
-enum Oprs {
-    PL0_NEG = 1,
-    PL0_ADD,
-    PL0_SUB,
-    PL0_MUL,
-    PL0_DIV,
-    PL0_MOD,
-    PL0_ODD,
-    PL0_EQ,
-    PL0_NEQ,
-    PL0_LT,
-    PL0_GEQ,
-    PL0_GRT,
-    PL0_LEQ
-};
-
-/**
- * Map for operators and their OPR parameters
- */
-static const std::map<std::string, Oprs> OperatorsTable = {
-    {"+", PL0_ADD},
-    {"-", PL0_SUB},
-    {"*", PL0_MUL},
-    {"/", PL0_DIV},
-    {"%", PL0_MOD},
-    {"==", PL0_EQ},
-    {"!=", PL0_NEQ},
-    {"<", PL0_LT},
-    {">=", PL0_GEQ},
-    {">", PL0_GRT},
-    {"<=", PL0_LEQ}
-};
-
-/**
- * Map for instructions and their names
- */
-static const char * const InstructionsTable[] = {
-    [PL0_LIT] = "LIT",
-    [PL0_OPR] = "OPR",
-    [PL0_LOD] = "LOD",
-    [PL0_STO] = "STO",
-    [PL0_CAL] = "CAL",
-    [PL0_INT] = "INT",
-    [PL0_JMP] = "JMP",
-    [PL0_JMC] = "JMC",
-    [PL0_RET] = "RET",
-    [PL0_REA] = "REA",
-    [PL0_WRI] = "WRI",
-    [PL0_NEW] = "NEW",
-    [PL0_DEL] = "DEL",
-    [PL0_LDA] = "LDA",
-    [PL0_STA] = "STA",
-    [PL0_PLD] = "PLD",
-    [PL0_PST] = "PST",
-    [PL0_ITR] = "ITR",
-    [PL0_RTI] = "RTI",
-    [PL0_OPF] = "OPF"
-};
-
-/**
- * Struct for instruction
- */
-typedef struct Instruction {
-    /** Line number */
-    uint32_t line;
-    /** Instruction */
-    std::string instruction;
-    /** Level */
-    int level;
-    /** Parameter */
-    int parameter;
-} Instruction;
+#include "Instructions.h"
 
 /**
  * Class for instructions generation (PL/0 instructions)
@@ -128,6 +26,8 @@ private:
     SymbolTable symtab;
     /** Map for declared functions */
     std::map<std::string, int> declared_functions;
+    /** Map for entry addresses of the generated functions and their names */
+    std::map<uint32_t, std::string> function_entries;
     /** Stack for break statements */
     std::vector<uint32_t> break_stack;
     /** Stack for continue statements */
@@ -219,6 +119,11 @@ public:
      * @return Instructions
      */
     [[nodiscard]] std::vector<Instruction> &get_instructions();
+    /**
+     * Get entry addresses of the generated functions (including the builtin functions)
+     * @return Map for entry addresses and names of the functions
+     */
+    [[nodiscard]] std::map<uint32_t, std::string> &get_function_entries();
 
     /* ASTVisitor methods */
     void visit(ASTNodeBlock *node) override;
@@ -8,7 +8,7 @@ void Optimizer::optimize_ast(ASTNodeBlock *global_block) {
     global_block->accept(this);
 }
 
-void Optimizer::optimize_instructions(std::vector<Instruction> &instructions) {
+void Optimizer::optimize_instructions(std::vector<Instruction> &instructions, std::map<uint32_t, std::string> &function_entries) {
     /* Remove middle steps of jumps leading to unconditional jumps */
     for (int i = 0; i < instructions.size(); i++) {
         auto &instruction = instructions[i];
@@ -42,6 +42,12 @@ void Optimizer::optimize_instructions(std::vector<Instruction> &instructions) {
             instruction.parameter = old_new_map[instruction.parameter];
         }
     }
+
+    /* Entry of a function is never deleted (it is not a jump) */
+    std::map<uint32_t, std::string> new_function_entries;
+    for (auto &[line, name]: function_entries)
+        new_function_entries[old_new_map[line]] = name;
+    function_entries = std::move(new_function_entries);
 }
 
 void Optimizer::visit(ASTNodeBlock *node) {
@@ -49,8 +49,9 @@ public:
     /**
      * Optimize the instructions
      * @param instructions Instructions to optimize
+     * @param function_entries Entry addresses of the functions (updated to the new line numbers)
      */
-    void optimize_instructions(std::vector<Instruction> &instructions);
+    void optimize_instructions(std::vector<Instruction> &instructions, std::map<uint32_t, std::string> &function_entries);
 
     /* Visit methods */
     void visit(ASTNodeBlock *node) override;
@@ -16,8 +16,7 @@ std::vector<std::string> SemanticAnalyzer::get_used_builtin_functions() {
 void SemanticAnalyzer::register_label(ASTNodeStatement *node) {
     if (!node->label.empty()) {
         if (std::find(this->declared_labels.begin(), this->declared_labels.end(), node->label) != this->declared_labels.end()) {
-            std::cerr << "Semantic error: label \"" << node->label << "\" already declared, error on line " << node->line << std::endl;
-            exit(1);
+            throw CompileError("Semantic error: label \"", node->label, "\" already declared, error on line ", node->line);
         }
         this->declared_labels.push_back(node->label);
     }
@@ -35,26 +34,26 @@ void SemanticAnalyzer::analyze() {
     for (auto &used_label : this->used_labels) {
         bool found = std::find(this->declared_labels.begin(), this->declared_labels.end(), used_label.first) != this->declared_labels.end();
         if (!found) {
-            std::cerr << "Semantic error: label \"" << used_label.first << "\" not declared, error on line " << used_label.second << std::endl;
-            exit(1);
+            throw CompileError("Semantic error: label \"", used_label.first, "\" not declared, error on line ", used_label.second);
         }
     }
 
     auto main_func = symtab.get_symbol("main");
     if (main_func == undefined_record) {
-        std::cerr << "Semantic error: main function not found" << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: main function not found");
     }
 
     if (main_func.type != int_t) {
-        std::cerr << "Semantic error: main function must return integer" << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: main function must return integer");
     }
 
     if (!problematic_forward_referenced_functions.empty()) {
+        /* Every function which is not defined is reported, one line each */
+        auto message = std::string();
         for (auto &problematic_forward_referenced_function: problematic_forward_referenced_functions)
-            std::cerr << "Semantic error: function \"" << problematic_forward_referenced_function.first << "\" is not defined, error on line " << problematic_forward_referenced_function.second << std::endl;
-        exit(1);
+            message += (message.empty() ? "" : "\n") + std::string("Semantic error: function \"") + problematic_forward_referenced_function.first
+                       + "\" is not defined, error on line " + std::to_string(problematic_forward_referenced_function.second);
+        throw CompileError(message);
     }
 }
 
@@ -62,29 +61,26 @@ void SemanticAnalyzer::check_expr_type(Type type, ASTNodeExpression *expr, int l
     /* If type is not string, but expression is string literal or string variable or function returning string, error */
     if (type.type != string_t.type && dynamic_cast<ASTNodeStringLiteral *>(expr)) {
         if (is_assignment_check)
-            std::cerr << "Semantic error: cannot assign string literal to non-string variable, error on line " << line << std::endl;
+            throw CompileError("Semantic error: cannot assign string literal to non-string variable, error on line ", line);
         else /* Return type check */
-            std::cerr << "Semantic error: function declared as returning non-string -> cannot return string, error on line " << line << std::endl;
-        exit(1);
+            throw CompileError("Semantic error: function declared as returning non-string -> cannot return string, error on line ", line);
     }
     if (type.type != string_t.type && dynamic_cast<ASTNodeIdentifier *>(expr)) {
         auto &symbol = this->symtab.get_symbol(dynamic_cast<ASTNodeIdentifier *>(expr)->name);
         if (symbol.type.type == string_t.type) {
             if (is_assignment_check)
-                std::cerr << "Semantic error: cannot assign string variable to non-string variable, error on line " << line << std::endl;
+                throw CompileError("Semantic error: cannot assign string variable to non-string variable, error on line ", line);
             else /* Return type check */
-                std::cerr << "Semantic error: function declared as returning non-string -> cannot return string, error on line " << line << std::endl;
-            exit(1);
+                throw CompileError("Semantic error: function declared as returning non-string -> cannot return string, error on line ", line);
         }
     }
     if (type.type != string_t.type && dynamic_cast<ASTNodeCallFunc *>(expr)) {
         auto &symbol = this->symtab.get_symbol(dynamic_cast<ASTNodeCallFunc *>(expr)->name);
         if (symbol.type.type == string_t.type) {
             if (is_assignment_check)
-                std::cerr << "Semantic error: cannot assign function returning string to non-string variable, error on line " << line << std::endl;
+                throw CompileError("Semantic error: cannot assign function returning string to non-string variable, error on line ", line);
             else /* Return type check */
-                std::cerr << "Semantic error: function declared as returning non-string -> cannot return string, error on line " << line << std::endl;
-            exit(1);
+                throw CompileError("Semantic error: function declared as returning non-string -> cannot return string, error on line ", line);
         }
     }
 
@@ -92,29 +88,26 @@ void SemanticAnalyzer::check_expr_type(Type type, ASTNodeExpression *expr, int l
     if (type.type == string_t.type && !type.is_pointer) {
         if (!dynamic_cast<ASTNodeStringLiteral *>(expr) && !dynamic_cast<ASTNodeIdentifier *>(expr) && !dynamic_cast<ASTNodeCallFunc *>(expr)) {
             if (is_assignment_check)
-                std::cerr << "Semantic error: cannot assign non-string expression to string variable, error on line " << line << std::endl;
+                throw CompileError("Semantic error: cannot assign non-string expression to string variable, error on line ", line);
             else /* Return type check */
-                std::cerr << "Semantic error: function declared as returning string -> cannot return non-string, error on line " << line << std::endl;
-            exit(1);
+                throw CompileError("Semantic error: function declared as returning string -> cannot return non-string, error on line ", line);
         }
         if (dynamic_cast<ASTNodeIdentifier *>(expr)) {
             auto &symbol = this->symtab.get_symbol(dynamic_cast<ASTNodeIdentifier *>(expr)->name);
             if (symbol.type.type != string_t.type) {
                 if (is_assignment_check)
-                    std::cerr << "Semantic error: cannot assign non-string variable to string variable, error on line " << line << std::endl;
+                    throw CompileError("Semantic error: cannot assign non-string variable to string variable, error on line ", line);
                 else /* Return type check */
-                    std::cerr << "Semantic error: function declared as returning string -> cannot return non-string, error on line " << line << std::endl;
-                exit(1);
+                    throw CompileError("Semantic error: function declared as returning string -> cannot return non-string, error on line ", line);
             }
         }
         if (dynamic_cast<ASTNodeCallFunc *>(expr)) {
             auto &symbol = this->symtab.get_symbol(dynamic_cast<ASTNodeCallFunc *>(expr)->name);
             if (symbol.type.type != string_t.type) {
                 if (is_assignment_check)
-                    std::cerr << "Semantic error: cannot assign function returning non-string to string variable, error on line " << line << std::endl;
+                    throw CompileError("Semantic error: cannot assign function returning non-string to string variable, error on line ", line);
                 else /* Return type check */
-                    std::cerr << "Semantic error: function declared as returning string -> cannot return non-string, error on line " << line << std::endl;
-                exit(1);
+                    throw CompileError("Semantic error: function declared as returning string -> cannot return non-string, error on line ", line);
             }
         }
     }
@@ -129,8 +122,7 @@ void SemanticAnalyzer::visit(ASTNodeBlock *node) {
         auto current_function = this->current_functions.back();
 
         if (node->statements.empty()) {
-            std::cerr << "Semantic error: function \"" << current_function.first << "\" does not contain a return statement, error on line " << current_function.second << std::endl;
-            exit(1);
+            throw CompileError("Semantic error: function \"", current_function.first, "\" does not contain a return statement, error on line ", current_function.second);
         }
 
         auto last_statement = node->statements.back();
@@ -141,26 +133,22 @@ void SemanticAnalyzer::visit(ASTNodeBlock *node) {
             contains_return_statement = if_statement->contains_return_statement();
 
         if (!contains_return_statement) {
-            std::cerr << "Semantic error: function \"" << current_function.first << "\" does not contain a return statement, error on line " << current_function.second << std::endl;
-            exit(1);
+            throw CompileError("Semantic error: function \"", current_function.first, "\" does not contain a return statement, error on line ", current_function.second);
         }
     }
 }
 
 void SemanticAnalyzer::visit(ASTNodeDeclVar *node) {
     if (this->symtab.get_current_scope().exists(node->name)) {
-        std::cerr << "Semantic error: variable \"" << node->name << "\" already declared in this scope, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: variable \"", node->name, "\" already declared in this scope, error on line ", node->line);
     }
 
     if (str_to_val_type(node->type) == void_t.type) {
-        std::cerr << "Semantic error: variable \"" << node->name << "\" cannot be of type void, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: variable \"", node->name, "\" cannot be of type void, error on line ", node->line);
     }
 
     if (str_to_val_type(node->type) == float_t.type && node->is_pointer) {
-        std::cerr << "Semantic error: float pointer is not supported, due to PL/0 instructions set limitations, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: float pointer is not supported, due to PL/0 instructions set limitations, error on line ", node->line);
     }
 
     node->label = node->ASTNodeStatement::label;
@@ -204,12 +192,10 @@ void SemanticAnalyzer::visit(ASTNodeDeclVar *node) {
         }
 
         if (symbol.type.is_pointer && !is_rvalue_ptr) {
-            std::cerr << "Semantic error: variable \"" << node->name << "\" is a pointer and must be assigned with a reference or new, error on line " << node->line << std::endl;
-            exit(1);
+            throw CompileError("Semantic error: variable \"", node->name, "\" is a pointer and must be assigned with a reference or new, error on line ", node->line);
         }
         else if (!symbol.type.is_pointer && is_rvalue_ptr) {
-            std::cerr << "Semantic error: variable \"" << node->name << "\" is not a pointer, error on line " << node->line << std::endl;
-            exit(1);
+            throw CompileError("Semantic error: variable \"", node->name, "\" is not a pointer, error on line ", node->line);
         }
     }
     else {
@@ -220,8 +206,7 @@ void SemanticAnalyzer::visit(ASTNodeDeclVar *node) {
 void SemanticAnalyzer::visit(ASTNodeDeclFunc *node) {
     auto func_symbol = this->symtab.get_symbol(node->name);
     if (func_symbol != undefined_record && this->declared_functions[node->name]) {
-        std::cerr << "Semantic error: function \"" << node->name << "\" already declared, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: function \"", node->name, "\" already declared, error on line ", node->line);
     }
 
     node->label = node->ASTNodeStatement::label;
@@ -312,8 +297,7 @@ void SemanticAnalyzer::visit(ASTNodeFor *node) {
     this->symtab.insert_scope(0, 0, false); /* No need to care about addressing here */
 
     if (!dynamic_cast<ASTNodeDeclVar *>(node->init) && !dynamic_cast<ASTNodeAssignExpression *>(node->init)) {
-        std::cerr << "Semantic error: invalid for loop initialization, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: invalid for loop initialization, error on line ", node->line);
     }
 
     node->init->accept(this);
@@ -330,8 +314,7 @@ void SemanticAnalyzer::visit(ASTNodeBreakContinue *node) {
     this->register_label(node);
 
     if (!this->current_loop_level) {
-        std::cerr << "Semantic error: break/continue statement outside of loop, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: break/continue statement outside of loop, error on line ", node->line);
     }
 }
 
@@ -362,12 +345,10 @@ void SemanticAnalyzer::visit(ASTNodeExpressionStatement *node) {
 void SemanticAnalyzer::visit(ASTNodeIdentifier *node) {
     auto &symbol = this->symtab.get_symbol(node->name);
     if (symbol == undefined_record) {
-        std::cerr << "Semantic error: variable \"" << node->name << "\" not declared, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: variable \"", node->name, "\" not declared, error on line ", node->line);
     }
     if (!this->defined_variables[node->name]) {
-        std::cerr << "Semantic error: variable \"" << node->name << "\" used before definition, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: variable \"", node->name, "\" used before definition, error on line ", node->line);
     }
 }
 
@@ -392,8 +373,7 @@ void SemanticAnalyzer::visit(ASTNodeAssignExpression *node) {
 
     if (node->lvalue) {
         if (!dynamic_cast<ASTNodeDereference *>(node->lvalue)) {
-            std::cerr << "Semantic error: lvalue required as left operand of assignment, error on line " << node->line << std::endl;
-            exit(1);
+            throw CompileError("Semantic error: lvalue required as left operand of assignment, error on line ", node->line);
         }
         node->lvalue->accept(this);
     }
@@ -403,19 +383,16 @@ void SemanticAnalyzer::visit(ASTNodeAssignExpression *node) {
     this->defined_variables[node->name] = true;
 
     if (dynamic_cast<ASTNodeAssignExpression *>(node->expression)) {
-        std::cerr << "Multi assignment is not supported, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Multi assignment is not supported, error on line ", node->line);
     }
 
     if (!node->lvalue) {
         if (symbol == undefined_record) {
-            std::cerr << "Semantic error: variable \"" << node->name << "\" not declared, error on line " << node->line << std::endl;
-            exit(1);
+            throw CompileError("Semantic error: variable \"", node->name, "\" not declared, error on line ", node->line);
         }
 
         if (symbol.is_const && this->assigned_constants[node->name]) {
-            std::cerr << "Semantic error: variable \"" << node->name << "\" is constant and can only be assigned once, error on line " << node->line << std::endl;
-            exit(1);
+            throw CompileError("Semantic error: variable \"", node->name, "\" is constant and can only be assigned once, error on line ", node->line);
         }
 
         if (symbol.is_const)
@@ -443,12 +420,10 @@ void SemanticAnalyzer::visit(ASTNodeAssignExpression *node) {
     }
 
     if (symbol.type.is_pointer && !is_rvalue_ptr) {
-        std::cerr << "Semantic error: variable \"" << node->name << "\" is a pointer and must be assigned with a reference or new, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: variable \"", node->name, "\" is a pointer and must be assigned with a reference or new, error on line ", node->line);
     }
     else if (!symbol.type.is_pointer && is_rvalue_ptr) {
-        std::cerr << "Semantic error: variable \"" << node->name << "\" is not a pointer, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: variable \"", node->name, "\" is not a pointer, error on line ", node->line);
     }
 
     check_expr_type(symbol.type, node->expression, node->line);
@@ -464,20 +439,17 @@ void SemanticAnalyzer::visit(ASTNodeBinaryOperator *node) {
     if (node->op == "/") {
         if (auto right_lit_i = dynamic_cast<ASTNodeIntLiteral *>(node->right)) {
             if (right_lit_i->value == 0) {
-                std::cerr << "Semantic error: division by zero, error on line " << node->line << std::endl;
-                exit(1);
+                throw CompileError("Semantic error: division by zero, error on line ", node->line);
             }
         }
         else if (auto right_lit_f = dynamic_cast<ASTNodeFloatLiteral *>(node->right)) {
             if (right_lit_f->value == 0.0) {
-                std::cerr << "Semantic error: division by zero, error on line " << node->line << std::endl;
-                exit(1);
+                throw CompileError("Semantic error: division by zero, error on line ", node->line);
             }
         }
         else if (auto right_lit_b = dynamic_cast<ASTNodeBoolLiteral *>(node->right)) {
             if (right_lit_b->value == 0) {
-                std::cerr << "Semantic error: division by zero, error on line " << node->line << std::endl;
-                exit(1);
+                throw CompileError("Semantic error: division by zero, error on line ", node->line);
             }
         }
     }
@@ -486,8 +458,7 @@ void SemanticAnalyzer::visit(ASTNodeBinaryOperator *node) {
     node->right->accept(this);
 
     if (dynamic_cast<ASTNodeStringLiteral *>(node->left) || dynamic_cast<ASTNodeStringLiteral *>(node->right)) {
-        std::cerr << "Semantic error: string literals cannot be used in binary operators, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: string literals cannot be used in binary operators, error on line ", node->line);
     }
 }
 
@@ -495,20 +466,17 @@ void SemanticAnalyzer::visit(ASTNodeUnaryOperator *node) {
     node->expression->accept(this);
 
     if (dynamic_cast<ASTNodeStringLiteral *>(node->expression)) {
-        std::cerr << "Semantic error: string literals cannot be used in unary operators, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: string literals cannot be used in unary operators, error on line ", node->line);
     }
 }
 
 void SemanticAnalyzer::visit(ASTNodeCast *node) {
     if (str_to_val_type(node->type) == string_t.type) {
-        std::cerr << "Semantic error: cannot cast to string, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: cannot cast to string, error on line ", node->line);
     }
 
     if (dynamic_cast<ASTNodeStringLiteral *>(node->expression)) {
-        std::cerr << "Semantic error: cannot cast string literal, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: cannot cast string literal, error on line ", node->line);
     }
 
     node->expression->accept(this);
@@ -518,8 +486,7 @@ template<typename T>
 void SemanticAnalyzer::func_call_lit_arg_type_check(ASTNodeExpression *argument, struct SymbolTableRecord &parameter, Type &type, int line) {
     if (dynamic_cast<T *>(argument)) {
         if (parameter.type.type != type.type) {
-            std::cerr << "Semantic error: function expects " << val_type_to_str(parameter.type.type) << " argument, " << val_type_to_str(type.type) << " given, error on line " << line << std::endl;
-            exit(1);
+            throw CompileError("Semantic error: function expects ", val_type_to_str(parameter.type.type), " argument, ", val_type_to_str(type.type), " given, error on line ", line);
         }
     }
 }
@@ -528,18 +495,15 @@ void SemanticAnalyzer::visit(ASTNodeCallFunc *node) {
     auto &symbol = this->symtab.get_symbol(node->name);
 
     if (symbol == undefined_record) {
-        std::cerr << "Semantic error: function \"" << node->name << "\" not declared, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: function \"", node->name, "\" not declared, error on line ", node->line);
     }
 
     if (symbol.symbol_type != FUNCTION) {
-        std::cerr << "Semantic error: \"" << node->name << "\" is not a function, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: \"", node->name, "\" is not a function, error on line ", node->line);
     }
 
     if (symbol.parameters.size() != node->arguments.size()) {
-        std::cerr << "Semantic error: function \"" << node->name << "\" expects " << symbol.parameters.size() << " arguments, " << node->arguments.size() << " given, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: function \"", node->name, "\" expects ", symbol.parameters.size(), " arguments, ", node->arguments.size(), " given, error on line ", node->line);
     }
 
     /* Type check arguments */
@@ -555,16 +519,14 @@ void SemanticAnalyzer::visit(ASTNodeCallFunc *node) {
         if (auto id = dynamic_cast<ASTNodeIdentifier *>(argument)) {
             auto &id_symbol = this->symtab.get_symbol(id->name);
             if (id_symbol.type.type != parameter.type.type) {
-                std::cerr << "Semantic error: function expects " << val_type_to_str(parameter.type.type) << " argument, " << val_type_to_str(id_symbol.type.type) << " given, error on line " << node->line << std::endl;
-                exit(1);
+                throw CompileError("Semantic error: function expects ", val_type_to_str(parameter.type.type), " argument, ", val_type_to_str(id_symbol.type.type), " given, error on line ", node->line);
             }
         }
 
         if (auto call_func = dynamic_cast<ASTNodeCallFunc *>(argument)) {
             auto &call_func_symbol = this->symtab.get_symbol(call_func->name);
             if (call_func_symbol.type.type != parameter.type.type) {
-                std::cerr << "Semantic error: function expects " << val_type_to_str(parameter.type.type) << " argument, " << val_type_to_str(call_func_symbol.type.type) << " given, error on line " << node->line << std::endl;
-                exit(1);
+                throw CompileError("Semantic error: function expects ", val_type_to_str(parameter.type.type), " argument, ", val_type_to_str(call_func_symbol.type.type), " given, error on line ", node->line);
             }
         }
     }
@@ -581,8 +543,7 @@ void SemanticAnalyzer::visit(ASTNodeCallFunc *node) {
 
 void SemanticAnalyzer::visit(ASTNodeNew *node) {
     if (str_to_val_type(node->type) == void_t.type) {
-        std::cerr << "Semantic error: cannot allocate void, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: cannot allocate void, error on line ", node->line);
     }
 
     node->expression->accept(this);
@@ -599,14 +560,12 @@ void SemanticAnalyzer::visit(ASTNodeDereference *node) {
 void SemanticAnalyzer::visit(ASTNodeReference *node) {
     auto &symbol = this->symtab.get_symbol(node->identifier);
     if (symbol == undefined_record) {
-        std::cerr << "Semantic error: variable \"" << node->identifier << "\" not declared, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: variable \"", node->identifier, "\" not declared, error on line ", node->line);
     }
 }
 
 void SemanticAnalyzer::visit(ASTNodeSizeof *node) {
     if (str_to_val_type(node->type) == undefined_t.type) {
-        std::cerr << "Semantic error: type \"" << node->type << "\" not declared, error on line " << node->line << std::endl;
-        exit(1);
+        throw CompileError("Semantic error: type \"", node->type, "\" not declared, error on line ", node->line);
     }
 }
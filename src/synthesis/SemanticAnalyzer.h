@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AbstractSyntaxTree.h"
+#include "CompileError.h"
 #include "SymbolTable.h"
 
 /**
@@ -72,6 +73,7 @@ public:
 
     /**
      * Analyze the AST
+     * Throws CompileError on the first semantic error
      */
     void analyze();
 
@@ -0,0 +1,336 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "analysis/SyntaxAnalyzer.h"
+#include "synthesis/SemanticAnalyzer.h"
+#include "synthesis/InstructionsGenerator.h"
+#include "synthesis/Optimizer.h"
+#include "execution/Program.h"
+#include "execution/VirtualMachine.h"
+
+/**
+ * Struct for one test case (directory with src.yadc, input.txt and expected_output.txt, optionally expected_output_32.txt)
+ */
+typedef struct TestCase {
+    /** Name of the test case (name of the directory) */
+    std::string name;
+    /** Directory of the test case */
+    std::filesystem::path directory;
+    /** True if the output equals to the expected output; False otherwise */
+    bool passed;
+    /** Reason of the failure */
+    std::string message;
+    /** Number of executed instructions */
+    std::uint64_t instructions;
+    /** Compilation time [ms] */
+    double compile_time;
+    /** Run time [ms] */
+    double run_time;
+} TestCase;
+
+/**
+ * Parser and scanner are reentrant, but the symbol tables of the semantic analysis and the generation still share
+ * the mutable globals of SymbolTable.h (e.g. undefined_record), so only the parsing runs in parallel
+ */
+static std::mutex compiler_mutex;
+
+/**
+ * Prints usage of the program to stderr
+ * @param program_name name of the program
+ */
+void print_usage(const char *program_name) {
+    std::cerr << "Usage: " << program_name << " [options] [test directory]" << std::endl;
+    std::cerr << "Compiles and runs every test_case_* of the test directory (default \"test\") and compares the output" << std::endl;
+    std::cerr << "    --threads=<count>  - number of the worker threads (default number of the hardware threads)" << std::endl;
+    std::cerr << "    -o=<0|1>           - optimizations of the compiler (default 1)" << std::endl;
+    std::cerr << "    --benchmark=<file> - write executed instructions and times of the test cases to the JSON file" << std::endl;
+    std::cerr << "    --baseline=<file>  - fail the test cases which execute more instructions than in the JSON file" << std::endl;
+}
+
+/**
+ * Reads whole file (empty string if the file does not exist)
+ * @param path Path to the file
+ * @return Content of the file
+ */
+static std::string read_file(const std::filesystem::path &path) {
+    auto input = std::ifstream(path, std::ios::binary);
+    std::stringstream content;
+    content << input.rdbuf();
+    return content.str();
+}
+
+/**
+ * Compiles the source file to the PL/0 instructions, the same way as the compiler (yadc)
+ * Throws CompileError if the program has a lexical, syntax or semantic error
+ * @param source_file Source file
+ * @param optimizations_enabled True if the optimizations are enabled; False otherwise
+ * @return Compiled program
+ */
+static Program compile(const std::filesystem::path &source_file, bool optimizations_enabled) {
+    auto syntax_analyzer = SyntaxAnalyzer(source_file.string());
+    /* AST is freed also when the semantic analysis fails */
+    auto global_block_owner = std::unique_ptr<ASTNodeBlock>(syntax_analyzer.analyze().global_block);
+    auto global_block = global_block_owner.get();
+
+    std::lock_guard lock(compiler_mutex);
+    auto semantic_analyzer = SemanticAnalyzer(global_block);
+    semantic_analyzer.analyze();
+    auto used_builtin_functions = semantic_analyzer.get_used_builtin_functions();
+
+    auto optimizer = Optimizer();
+    if (optimizations_enabled)
+        optimizer.optimize_ast(global_block);
+    auto instructions_generator = InstructionsGenerator(global_block, used_builtin_functions);
+    instructions_generator.generate();
+    auto instructions = instructions_generator.get_instructions();
+    if (optimizations_enabled)
+        optimizer.optimize_instructions(instructions, instructions_generator.get_function_entries());
+
+    /* Instructions are handed over to the virtual machine in memory, the same way as by yadc run */
+    return Program::from_instructions(instructions);
+}
+
+/**
+ * Runs the compiled program of the test case with its input and compares the output with the expected output
+ * @tparam Cell Type of the cell of the virtual machine
+ * @param test_case Test case
+ * @param program Compiled program
+ * @param expected_output_file Name of the file of the expected output in the directory of the test case
+ * @return True if the output is the expected output; False otherwise (the message of the test case is set)
+ */
+template<typename Cell>
+static bool run_program(TestCase &test_case, const Program &program, const std::string &expected_output_file) {
+    auto actual_output = std::string();
+    auto virtual_machine = BasicVirtualMachine<Cell>(program, InputBuffer(read_file(test_case.directory / "input.txt")), OutputBuffer(actual_output));
+    /* Cells of the other width are named in the message, the executed instructions are of the 64-bit cells */
+    auto cells = std::is_same_v<Cell, cell_t> ? std::string() : "(" + std::to_string(sizeof(Cell) * 8) + "-bit cells) ";
+    try {
+        virtual_machine.run();
+    } catch (const RuntimeError &error) {
+        test_case.message = cells + "runtime error: " + error.what();
+    }
+    if constexpr (std::is_same_v<Cell, cell_t>)
+        test_case.instructions = virtual_machine.get_instruction_counter();
+
+    if (!test_case.message.empty())
+        return false;
+    auto expected_output = read_file(test_case.directory / expected_output_file);
+    if (actual_output != expected_output) {
+        auto mismatch = std::mismatch(actual_output.begin(), actual_output.end(), expected_output.begin(), expected_output.end());
+        test_case.message = cells + "output differs at character " + std::to_string(mismatch.first - actual_output.begin());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Compiles and runs the test case, with expected_output_32.txt it also runs on the 32-bit cells (yadc-vm --cells=32)
+ * @param test_case Test case
+ * @param optimizations_enabled True if the optimizations are enabled; False otherwise
+ */
+static void run_test_case(TestCase &test_case, bool optimizations_enabled) {
+    auto start = std::chrono::steady_clock::now();
+    auto program = compile(test_case.directory / "src.yadc", optimizations_enabled);
+    auto compiled = std::chrono::steady_clock::now();
+    test_case.compile_time = std::chrono::duration<double, std::milli>(compiled - start).count();
+
+    test_case.passed = run_program<cell_t>(test_case, program, "expected_output.txt")
+                       && (!std::filesystem::exists(test_case.directory / "expected_output_32.txt")
+                           || run_program<compact_cell_t>(test_case, program, "expected_output_32.txt"));
+    test_case.run_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - compiled).count();
+}
+
+/**
+ * Loads executed instructions of the test cases from the benchmark file written by an earlier run
+ * @param file_name Benchmark file
+ * @return Map for names of the test cases and their executed instructions
+ */
+static std::map<std::string, std::uint64_t> load_baseline(const std::string &file_name) {
+    auto input = std::ifstream(file_name);
+    if (!input)
+        throw std::runtime_error("cannot open file \"" + file_name + "\"");
+
+    /* Every test case is on its own line of the benchmark file */
+    std::map<std::string, std::uint64_t> baseline;
+    std::string line;
+    while (std::getline(input, line)) {
+        auto name = line.find("\"name\": \"");
+        auto instructions = line.find("\"instructions\": ");
+        if (name == std::string::npos || instructions == std::string::npos)
+            continue;
+        name += std::strlen("\"name\": \"");
+        instructions += std::strlen("\"instructions\": ");
+        baseline[line.substr(name, line.find('"', name) - name)] = std::stoull(line.substr(instructions));
+    }
+    return baseline;
+}
+
+/**
+ * Escapes the string for JSON
+ * @param text String
+ * @return JSON string (with the quotes)
+ */
+static std::string json_string(const std::string &text) {
+    auto result = std::string("\"");
+    for (auto character: text) {
+        if (character == '"' || character == '\\') {
+            result += '\\';
+            result += character;
+        } else if (character == '\n') {
+            result += "\\n";
+        } else if (static_cast<unsigned char>(character) < 0x20) {
+            result += ' ';
+        } else {
+            result += character;
+        }
+    }
+    return result + "\"";
+}
+
+/**
+ * Writes the benchmark of the test cases as JSON
+ * @param file_name Benchmark file
+ * @param test_cases Test cases
+ * @param threads Number of the worker threads
+ * @param total_time Wall time of the whole run [ms]
+ */
+static void write_benchmark(const std::string &file_name, const std::vector<TestCase> &test_cases, unsigned threads, double total_time) {
+    auto output = std::ofstream(file_name);
+    if (!output)
+        throw std::runtime_error("cannot open file \"" + file_name + "\"");
+
+    auto passed = std::count_if(test_cases.begin(), test_cases.end(), [](const TestCase &test_case) { return test_case.passed; });
+    output << std::fixed << std::setprecision(3);
+    output << "{\n";
+    output << "  \"threads\": " << threads << ",\n";
+    output << "  \"total_ms\": " << total_time << ",\n";
+    output << "  \"passed\": " << passed << ",\n";
+    output << "  \"failed\": " << test_cases.size() - passed << ",\n";
+    output << "  \"cases\": [\n";
+    for (std::size_t i = 0; i < test_cases.size(); i++) {
+        auto &test_case = test_cases[i];
+        output << "    {\"name\": \"" << test_case.name << "\", \"passed\": " << (test_case.passed ? "true" : "false")
+               << ", \"instructions\": " << test_case.instructions << ", \"compile_ms\": " << test_case.compile_time
+               << ", \"run_ms\": " << test_case.run_time << (test_case.passed ? "" : ", \"message\": " + json_string(test_case.message))
+               << "}" << (i + 1 < test_cases.size() ? "," : "") << "\n";
+    }
+    output << "  ]\n";
+    output << "}" << std::endl;
+}
+
+/**
+ * Main function of the test runner
+ * @param argc Argument count
+ * @param argv Argument values
+ * @return EXIT_SUCCESS if all test cases passed, EXIT_FAILURE otherwise
+ */
+int main(int argc, char **argv) {
+    auto test_directory = std::filesystem::path("test");
+    auto threads = std::max(1u, std::thread::hardware_concurrency());
+    auto optimizations_enabled = true;
+    auto benchmark_file = std::string();
+    auto baseline_file = std::string();
+    for (auto i = 1; i < argc; i++) {
+        auto argument = std::string(argv[i]);
+        if (argument.starts_with("--threads=")) {
+            threads = std::max(1, std::atoi(argv[i] + std::strlen("--threads=")));
+        } else if (argument == "-o=0" || argument == "-o=1") {
+            optimizations_enabled = argument == "-o=1";
+        } else if (argument.starts_with("--benchmark=")) {
+            benchmark_file = argument.substr(std::strlen("--benchmark="));
+        } else if (argument.starts_with("--baseline=")) {
+            baseline_file = argument.substr(std::strlen("--baseline="));
+        } else if (!argument.starts_with("-")) {
+            test_directory = argument;
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* Test cases ordered by their number */
+    std::vector<TestCase> test_cases;
+    std::error_code error;
+    for (auto &entry: std::filesystem::directory_iterator(test_directory, error)) {
+        auto name = entry.path().filename().string();
+        if (entry.is_directory() && name.starts_with("test_case_") && std::filesystem::exists(entry.path() / "src.yadc"))
+            test_cases.push_back(TestCase{name, entry.path(), false, "", 0, 0.0, 0.0});
+    }
+    if (error || test_cases.empty()) {
+        std::cerr << "No test cases found in \"" << test_directory.string() << "\"" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::sort(test_cases.begin(), test_cases.end(), [](const TestCase &left, const TestCase &right) {
+        return std::make_pair(left.name.size(), left.name) < std::make_pair(right.name.size(), right.name);
+    });
+
+    std::map<std::string, std::uint64_t> baseline;
+    try {
+        if (!baseline_file.empty())
+            baseline = load_baseline(baseline_file);
+    } catch (const std::exception &exception) {
+        std::cerr << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    /* Workers take the test cases one by one, the parsing and the execution run in parallel (the rest of the compilation is serialized) */
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<std::size_t> next_test_case = 0;
+    std::vector<std::thread> workers;
+    threads = std::min<unsigned>(threads, test_cases.size());
+    for (unsigned i = 0; i < threads; i++) {
+        workers.emplace_back([&]() {
+            for (auto index = next_test_case++; index < test_cases.size(); index = next_test_case++) {
+                try {
+                    run_test_case(test_cases[index], optimizations_enabled);
+                } catch (const CompileError &error) {
+                    /* Failed compilation fails only its test case, the other test cases still run */
+                    test_cases[index].message = std::string("compile error: ") + error.what();
+                } catch (const std::exception &exception) {
+                    test_cases[index].message = exception.what();
+                }
+            }
+        });
+    }
+    for (auto &worker: workers)
+        worker.join();
+    auto total_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    auto failed = 0;
+    for (auto &test_case: test_cases) {
+        auto it = baseline.find(test_case.name);
+        if (test_case.passed && it != baseline.end() && test_case.instructions > it->second) {
+            test_case.passed = false;
+            test_case.message = "executed instructions regressed from " + std::to_string(it->second);
+        }
+        if (!test_case.passed)
+            failed++;
+
+        std::cout << test_case.name << ": " << (test_case.passed ? "Test passed" : "Test failed (" + test_case.message + ")")
+                  << ", " << test_case.instructions << " instructions, " << std::fixed << std::setprecision(3)
+                  << test_case.compile_time << " ms compile, " << test_case.run_time << " ms run" << std::endl;
+    }
+    std::cout << test_cases.size() - failed << " passed, " << failed << " failed, " << total_time << " ms on " << threads << " threads" << std::endl;
+
+    if (!benchmark_file.empty()) {
+        try {
+            write_benchmark(benchmark_file, test_cases, threads, total_time);
+        } catch (const std::exception &exception) {
+            std::cerr << "Error: " << exception.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}